@@ -40,7 +40,11 @@
 #include "reprompi_bench/output_management/bench_info_output.h"
 #include "reprompi_bench/output_management/runtimes_computation.h"
 #include "reprompi_bench/output_management/results_output.h"
+#include "reprompi_bench/output_management/pipelined_output.h"
+#include "reprompi_bench/output_management/straggler_output.h"
+#include "reprompi_bench/output_management/latency_histogram.h"
 #include "collective_ops/collectives.h"
+#include "buf_manager/mem_allocation.h"
 #include "reprompi_bench/utils/keyvalue_store.h"
 
 #include "contrib/intercommunication/intercommunication.h"
@@ -48,29 +52,47 @@
 static const int OUTPUT_ROOT_PROC = 0;
 static const int HASHTABLE_SIZE=100;
 
-void print_initial_settings(const reprompib_options_t* opts, const reprompib_common_options_t* common_opts, print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict) {
+static void print_settings_to_file(FILE* f, const reprompib_options_t* opts) {
+    if (opts->n_rep > 0) {
+        fprintf(f, "#@nrep=%ld\n", opts->n_rep);
+    }
+    if (opts->nrep_valid_factor > 0) {
+        fprintf(f, "#@nrep_valid_factor=%.2f\n", opts->nrep_valid_factor);
+    }
+    if (opts->enable_pipelined_output > 0) {
+        fprintf(f, "#@pipelined_output_enabled=%d\n", opts->enable_pipelined_output);
+    }
+    if (opts->enable_streaming_summary > 0) {
+        fprintf(f, "#@streaming_summary_enabled=%d\n", opts->enable_streaming_summary);
+    }
+    if (opts->enable_stragglers > 0) {
+        fprintf(f, "#@stragglers_enabled=%d\n", opts->enable_stragglers);
+    }
+    if (opts->histogram_scope != REPROMPI_HISTOGRAM_NONE) {
+        fprintf(f, "#@histogram=%s\n", (opts->histogram_scope == REPROMPI_HISTOGRAM_NODE) ? "node" : "global");
+    }
+}
 
-    print_common_settings(common_opts, print_sync_info, dict);
+void print_initial_settings(const reprompib_options_t* opts, const reprompib_common_options_t* common_opts, const reprompib_sync_functions_t* sync_f, const reprompib_dictionary_t* dict) {
+
+    print_common_settings(common_opts, sync_f, dict);
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         FILE* f;
 
-        f = stdout;
-        if (opts->n_rep > 0) {
-          fprintf(f, "#@nrep=%ld\n", opts->n_rep);
-          if (common_opts->output_file != NULL) {
+        print_settings_to_file(stdout, opts);
+        if (common_opts->output_file != NULL) {
             f = fopen(common_opts->output_file, "a");
-            fprintf(f, "#@nrep=%ld\n", opts->n_rep);
+            print_settings_to_file(f, opts);
             fflush(f);
             fclose(f);
-          }
         }
     }
 }
 
 
 void reprompib_print_bench_output(job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        const reprompib_sync_functions_t* sync_f,
         const reprompib_options_t* opts, const reprompib_common_options_t* common_opts) {
     FILE* f = stdout;
 
@@ -81,19 +103,17 @@ void reprompib_print_bench_output(job_t job, double* tstart_sec, double* tend_se
     }
 
     if (opts->print_summary_methods >0)  {
-        print_summary(stdout, job, tstart_sec, tend_sec, get_errorcodes, get_global_time,
+        print_summary(stdout, job, tstart_sec, tend_sec, sync_f,
                 opts->print_summary_methods);
         if (common_opts->output_file != NULL) {
             print_measurement_results(f, job, tstart_sec, tend_sec,
-                    get_errorcodes, get_global_time,
-                    opts->verbose);
+                    sync_f, opts->verbose);
         }
 
     }
     else {
         print_measurement_results(f, job, tstart_sec, tend_sec,
-                get_errorcodes, get_global_time,
-                opts->verbose);
+                sync_f, opts->verbose);
     }
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
@@ -106,6 +126,46 @@ void reprompib_print_bench_output(job_t job, double* tstart_sec, double* tend_se
 }
 
 
+/*
+ * maximum number of repetitions executed for a job: with --nrep-valid and a
+ * window-based synchronization, invalid repetitions are re-run up to
+ * <factor> * nrep repetitions in total
+ */
+static long get_max_nrep(const reprompib_options_t* opts, const reprompib_sync_functions_t* sync_f, long n_rep) {
+    if (opts->nrep_valid_factor > 0 && sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL
+            && sync_f->get_errorcodes != NULL) {
+        return (long)(opts->nrep_valid_factor * n_rep);
+    }
+    return n_rep;
+}
+
+/*
+ * number of repetitions in [first, first + n) that are valid on all processes;
+ * if hist is not NULL, the runtimes of the valid repetitions are recorded in it
+ */
+static long count_valid_repetitions(const reprompib_sync_functions_t* sync_f, long first, long n,
+        const double* tstart_sec, const double* tend_sec, reprompib_histogram_t* hist) {
+    int* errorcodes;
+    long i, n_valid = 0;
+
+    errorcodes = (int*) calloc(n, sizeof(int));
+    if (sync_f->get_errorcodes != NULL) {
+        MPI_Allreduce(sync_f->get_errorcodes() + first, errorcodes, n, MPI_INT, MPI_BOR,
+                icmb_global_communicator());
+    }
+    for (i = 0; i < n; i++) {
+        if (errorcodes[i] == 0) {
+            n_valid++;
+            if (hist != NULL) {
+                reprompib_record_latency(hist, tend_sec[first + i] - tstart_sec[first + i]);
+            }
+        }
+    }
+    free(errorcodes);
+    return n_valid;
+}
+
+
 void reprompib_parse_bench_options(int argc, char** argv) {
     int c;
     opterr = 0;
@@ -144,6 +204,7 @@ void reprompib_parse_bench_options(int argc, char** argv) {
 
 int main(int argc, char* argv[]) {
     long i, jindex;
+    long max_nrep, n_executed, n_valid, n_round;
     double* tstart_sec;
     double* tend_sec;
     reprompib_options_t opts;
@@ -155,24 +216,27 @@ int main(int argc, char* argv[]) {
     time_t start_time, end_time;
     reprompib_sync_functions_t sync_f;
     reprompib_dictionary_t params_dict;
+    reprompib_histogram_t latency_hist;
+    int mpi_thread_level;
 
     /* start up MPI
      *
+     * (the writer thread of --pipelined-output does not call MPI)
      * */
-    MPI_Init(&argc, &argv);
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_thread_level);
 
     // parse command line options to launch inter-communicators
     icmb_parse_intercommunication_options(argc, argv);
 
     // initialize time measurement functions
-    init_timer();
+    init_timer(argc, argv);
     start_time = time(NULL);
 
     //initialize dictionary
     reprompib_init_dictionary(&params_dict, HASHTABLE_SIZE);
 
     // initialize synchronization functions according to the configured synchronization method
-    initialize_sync_implementation(&sync_f);
+    initialize_sync_implementation(argc, argv, &sync_f);
 
     // parse arguments and set-up benchmarking jobs
     print_command_line_args(argc, argv);
@@ -182,11 +246,22 @@ int main(int argc, char* argv[]) {
     // parse common arguments (e.g., msizes list, MPI calls to benchmark, input file)
     reprompib_parse_common_options(&common_opts, argc, argv);
 
+    // select the allocator for message buffers and keep them across jobs if requested
+    reprompi_set_buffer_alloc(common_opts.buffer_alloc);
+    reprompi_init_buffer_pool(common_opts.enable_buffer_pool);
+
+    // write the results file as text or in the binary format
+    set_results_output_format(common_opts.output_format);
+    if (common_opts.enable_output_mpiio) {
+        set_results_output_mpiio(common_opts.output_file);
+    }
+
     // parse extra parameters into the global dictionary
     reprompib_parse_extra_key_value_options(&params_dict, argc, argv);
 
     // parse the benchmark-specific arguments (nreps, summary)
     reprompib_parse_options(&opts, argc, argv);
+    set_results_summary_streaming(opts.enable_streaming_summary);
 
     // parse the arguments related to the synchronization and timing method
     sync_f.parse_sync_params( argc, argv, &sync_opts);
@@ -196,6 +271,14 @@ int main(int argc, char* argv[]) {
     }
     generate_job_list(&common_opts, opts.n_rep, &jlist);
 
+    if (opts.enable_pipelined_output) {
+        reprompib_init_pipelined_output(opts.print_summary_methods, common_opts.output_file);
+    }
+    if (opts.enable_stragglers) {
+        reprompib_init_straggler_output();
+    }
+    reprompib_init_histograms(opts.histogram_scope);
+
 
     init_collective_basic_info(common_opts, 0, &coll_basic_info);
     // execute the benchmark jobs
@@ -204,36 +287,80 @@ int main(int argc, char* argv[]) {
         job = jlist.jobs[jlist.job_indices[jindex]];
 
         // start synchronization module
-        sync_f.init_sync_module(sync_opts, job.n_rep);
+        max_nrep = get_max_nrep(&opts, &sync_f, job.n_rep);
+        sync_f.init_sync_module(sync_opts, max_nrep);
 
-        tstart_sec = (double*) malloc(job.n_rep * sizeof(double));
-        tend_sec = (double*) malloc(job.n_rep * sizeof(double));
+        tstart_sec = (double*) malloc(max_nrep * sizeof(double));
+        tend_sec = (double*) malloc(max_nrep * sizeof(double));
 
         if (jindex == 0) {
-            print_initial_settings(&opts, &common_opts, sync_f.print_sync_info, &params_dict);
-            print_results_header(&opts, common_opts.output_file, opts.verbose);
+            print_initial_settings(&opts, &common_opts, &sync_f, &params_dict);
+            print_results_header(&opts, &sync_f, common_opts.output_file, opts.verbose);
         }
 
         collective_calls[job.call_index].initialize_data(coll_basic_info, job.count, &coll_params);
 
+        // the results of the previous job have to be reduced before the clocks are synchronized
+        if (opts.enable_pipelined_output) {
+            reprompib_complete_pipelined_output();
+        }
+
+        reprompib_reset_histogram(&latency_hist);
+
         // initialize synchronization
         sync_f.sync_clocks();
         sync_f.init_sync();
 
-        // execute MPI call nrep times
-        for (i = 0; i < job.n_rep; i++) {
-            sync_f.start_sync();
-
-            tstart_sec[i] = sync_f.get_time();
-            collective_calls[job.call_index].collective_call(&coll_params);
-            tend_sec[i] = sync_f.get_time();
-
-            sync_f.stop_sync();
+        // execute MPI call nrep times (with --nrep-valid, re-run the
+        // invalid repetitions in further rounds of windows)
+        n_executed = 0;
+        n_valid = 0;
+        while (n_valid < job.n_rep && n_executed < max_nrep) {
+            n_round = job.n_rep - n_valid;
+            if (n_round > max_nrep - n_executed) {
+                n_round = max_nrep - n_executed;
+            }
+            if (n_executed > 0) {
+                sync_f.resume_sync();
+            }
+
+            for (i = n_executed; i < n_executed + n_round; i++) {
+                sync_f.start_sync();
+
+                tstart_sec[i] = sync_f.get_time();
+                collective_calls[job.call_index].collective_call(&coll_params);
+                tend_sec[i] = sync_f.get_time();
+
+                sync_f.stop_sync();
+            }
+
+            // only repetitions with error code 0 on all processes are counted
+            // and recorded in the latency histogram (without --nrep-valid,
+            // the loop ends after the first round regardless of the count)
+            if (max_nrep > job.n_rep || opts.histogram_scope != REPROMPI_HISTOGRAM_NONE) {
+                n_valid += count_valid_repetitions(&sync_f, n_executed, n_round, tstart_sec, tend_sec,
+                        (opts.histogram_scope != REPROMPI_HISTOGRAM_NONE) ? &latency_hist : NULL);
+            } else {
+                n_valid += n_round;
+            }
+            n_executed += n_round;
         }
+        // the results cover all executed repetitions (valid_nrep == nrep unless the cap was reached)
+        job.n_rep = n_executed;
 
         //print summarized data
-        reprompib_print_bench_output(job, tstart_sec, tend_sec, sync_f.get_errorcodes,
-                sync_f.get_normalized_time, &opts, &common_opts);
+        if (opts.enable_pipelined_output) {
+            reprompib_start_pipelined_output(job, tstart_sec, tend_sec, &sync_f);
+        } else {
+            reprompib_print_bench_output(job, tstart_sec, tend_sec, &sync_f,
+                    &opts, &common_opts);
+        }
+        if (opts.enable_stragglers) {
+            reprompib_print_stragglers(job, tstart_sec, tend_sec, &sync_f, common_opts.output_file);
+        }
+        if (opts.histogram_scope != REPROMPI_HISTOGRAM_NONE) {
+            reprompib_print_histogram(job, &latency_hist, common_opts.output_file);
+        }
 
         free(tstart_sec);
         free(tend_sec);
@@ -244,11 +371,18 @@ int main(int argc, char* argv[]) {
     }
 
 
+    if (opts.enable_pipelined_output) {
+        reprompib_finish_pipelined_output();
+    }
+
     end_time = time(NULL);
-    print_final_info(&common_opts, start_time, end_time);
+    print_final_info(&common_opts, &sync_f, start_time, end_time);
 
+    reprompib_cleanup_straggler_output();
+    reprompib_cleanup_histograms();
     cleanup_job_list(jlist);
     reprompib_free_common_parameters(&common_opts);
+    reprompi_cleanup_buffer_pool();
     reprompib_free_parameters(&opts);
     reprompib_cleanup_dictionary(&params_dict);
 
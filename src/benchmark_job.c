@@ -179,7 +179,6 @@ void generate_job_list(const reprompib_common_options_t *opts, const int predefi
                 jlist->jobs[i].n_rep = predefined_n_rep;
                 ++i;
             }
-            free(call_name);
         }
       }
 
@@ -20,46 +20,319 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 </license>
  */
+// madvise and mbind
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "mpi.h"
 
 #include "mem_allocation.h"
 
+// maximum number of buffers kept by the pool (a job uses at most 6 buffers)
+#define REPROMPI_BUFFER_POOL_NSLOTS 8
 
-void* reprompi_calloc(size_t count, size_t elem_size) {
-  void *buf = NULL;
+#ifndef OPTION_BUFFER_ALIGNMENT
+#define REPROMPI_BUFFER_ALIGNMENT 64      // cache line size
+#else
+#define REPROMPI_BUFFER_ALIGNMENT OPTION_BUFFER_ALIGNMENT
+#endif
+
+static const size_t HUGEPAGE_SIZE = 2 * 1024 * 1024;
+static const int REPROMPI_MPOL_LOCAL = 4;   // MPOL_LOCAL from linux/mempolicy.h
+
+typedef struct {
+  char* buf;
+  size_t capacity;
+  int in_use;
+} pool_slot_t;
+
+static char* const buffer_alloc_names[] = {
+        [REPROMPI_BUFFER_ALLOC_CALLOC] = "calloc",
+        [REPROMPI_BUFFER_ALLOC_ALIGNED] = "aligned",
+        [REPROMPI_BUFFER_ALLOC_HUGEPAGE] = "hugepage",
+        [REPROMPI_BUFFER_ALLOC_MPI_ALLOC_MEM] = "mpi_alloc_mem",
+        [REPROMPI_BUFFER_ALLOC_NUMA_LOCAL] = "numa_local",
+        NULL
+};
 
 #ifdef OPTION_BUFFER_ALIGNMENT
+static reprompi_buffer_alloc_t buffer_alloc = REPROMPI_BUFFER_ALLOC_ALIGNED;
+#else
+static reprompi_buffer_alloc_t buffer_alloc = REPROMPI_BUFFER_ALLOC_CALLOC;
+#endif
+
+static int pool_enabled = 0;
+static pool_slot_t pool_slots[REPROMPI_BUFFER_POOL_NSLOTS];
+static reprompi_buffer_pool_stats_t pool_stats;
+
+
+char* const* get_buffer_alloc_list(void) {
+  return &(buffer_alloc_names[0]);
+}
+
+void reprompi_set_buffer_alloc(reprompi_buffer_alloc_t alloc) {
+  assert(alloc >= 0 && alloc < REPROMPI_N_BUFFER_ALLOC);
+  buffer_alloc = alloc;
+}
+
+reprompi_buffer_alloc_t reprompi_get_buffer_alloc(void) {
+  return buffer_alloc;
+}
+
+
+static void* allocate_aligned(size_t size, size_t align) {
+  void *buf = NULL;
   int is_power_of_two;
   int err;
-  size_t align = OPTION_BUFFER_ALIGNMENT;
 
   assert(align > 0);
   assert(align % sizeof(void*) == 0);   // multiple of sizeof(void*)
   is_power_of_two = !(align & (align-1));
   assert(is_power_of_two);
 
-  err = posix_memalign(&buf, align, count*elem_size);
+  err = posix_memalign(&buf, align, size);
 
   if (err == ENOMEM) {
-    fprintf(stderr, "Cannot allocate memory with size %zu Bytes\n", count*elem_size);
+    fprintf(stderr, "Cannot allocate memory with size %zu Bytes\n", size);
     exit(1);
   }
   if (err == EINVAL) {
     fprintf(stderr, "Cannot allocate memory with alignment %zu\n", align);
     exit(1);
   }
-#else
-  errno = 0;
-  buf = calloc(count, elem_size);
+  return buf;
+}
 
-  if (errno == ENOMEM) {
-    fprintf(stderr, "Cannot allocate memory with size %zu Bytes\n", count*elem_size);
-    exit(1);
+/*
+ * allocates a buffer with the selected backend and touches all of its pages,
+ * so that page faults do not occur during the measurements
+ */
+static void* allocate_buffer(size_t count, size_t elem_size) {
+  void *buf = NULL;
+  size_t size = count * elem_size;
+  size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  reprompi_buffer_alloc_t alloc = buffer_alloc;
+
+  // smaller buffers (e.g., the counts and displacements of a collective) cannot use a huge page
+  if (alloc == REPROMPI_BUFFER_ALLOC_HUGEPAGE && size < HUGEPAGE_SIZE) {
+    alloc = REPROMPI_BUFFER_ALLOC_CALLOC;
   }
+
+  switch (alloc) {
+  case REPROMPI_BUFFER_ALLOC_ALIGNED:
+    buf = allocate_aligned(size, REPROMPI_BUFFER_ALIGNMENT);
+    break;
+
+  case REPROMPI_BUFFER_ALLOC_HUGEPAGE:
+    // transparent huge pages need 2MB-aligned regions
+    buf = allocate_aligned(size, HUGEPAGE_SIZE);
+#ifdef MADV_HUGEPAGE
+    madvise(buf, (size / HUGEPAGE_SIZE) * HUGEPAGE_SIZE, MADV_HUGEPAGE);
+#endif
+    break;
+
+  case REPROMPI_BUFFER_ALLOC_MPI_ALLOC_MEM:
+    if (MPI_Alloc_mem((MPI_Aint)size, MPI_INFO_NULL, &buf) != MPI_SUCCESS) {
+      fprintf(stderr, "Cannot allocate memory with size %zu Bytes\n", size);
+      exit(1);
+    }
+    break;
+
+  case REPROMPI_BUFFER_ALLOC_NUMA_LOCAL:
+    // bind the pages to the node of the calling process (first touch happens below)
+    buf = allocate_aligned(size, page_size);
+#ifdef SYS_mbind
+    if (size >= page_size) {
+      syscall(SYS_mbind, buf, (size / page_size) * page_size, REPROMPI_MPOL_LOCAL, NULL, 0, 0);
+    }
 #endif
+    break;
+
+  default:
+    errno = 0;
+    buf = calloc(count, elem_size);
 
+    if (errno == ENOMEM) {
+      fprintf(stderr, "Cannot allocate memory with size %zu Bytes\n", size);
+      exit(1);
+    }
+    break;
+  }
+
+  if (buf != NULL) {
+    memset(buf, 0, size);
+  }
   return buf;
 }
+
+static void release_buffer(void* buf) {
+  if (buf == NULL) {
+    return;
+  }
+  if (buffer_alloc == REPROMPI_BUFFER_ALLOC_MPI_ALLOC_MEM) {
+    MPI_Free_mem(buf);
+  } else {
+    free(buf);
+  }
+}
+
+
+static int pool_is_idle(void) {
+  int i;
+
+  for (i = 0; i < REPROMPI_BUFFER_POOL_NSLOTS; i++) {
+    if (pool_slots[i].in_use) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * returns a zeroed slice of at least size bytes from the pool
+ * (or NULL if all slots are in use)
+ */
+static void* pool_get_buffer(size_t size) {
+  int i;
+  int best = -1, largest = -1;
+  double start_time;
+  pool_slot_t* slot;
+
+  // the first request after all buffers were released belongs to a new job
+  if (pool_is_idle()) {
+    pool_stats.n_jobs++;
+  }
+
+  // best fit among the free slots
+  for (i = 0; i < REPROMPI_BUFFER_POOL_NSLOTS; i++) {
+    if (pool_slots[i].in_use) {
+      continue;
+    }
+    if (pool_slots[i].capacity >= size &&
+        (best < 0 || pool_slots[i].capacity < pool_slots[best].capacity)) {
+      best = i;
+    }
+    if (largest < 0 || pool_slots[i].capacity > pool_slots[largest].capacity) {
+      largest = i;
+    }
+  }
+
+  if (best >= 0) {    // reuse an already faulted-in slice
+    slot = &pool_slots[best];
+
+    start_time = MPI_Wtime();
+    memset(slot->buf, 0, size);
+    pool_stats.reuse_time_sec += MPI_Wtime() - start_time;
+    pool_stats.reused_bytes += size;
+
+    slot->in_use = 1;
+    return slot->buf;
+  }
+
+  if (largest < 0) {
+    return NULL;
+  }
+
+  // grow the largest free slot to the requested size (rounded up to full pages)
+  slot = &pool_slots[largest];
+  {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t capacity = ((size + page_size - 1) / page_size) * page_size;
+
+    start_time = MPI_Wtime();
+    release_buffer(slot->buf);
+    pool_stats.pool_size_bytes -= slot->capacity;
+
+    slot->buf = (char*)allocate_buffer(capacity, sizeof(char));
+    slot->capacity = capacity;
+    pool_stats.alloc_time_sec += MPI_Wtime() - start_time;
+    pool_stats.allocated_bytes += capacity;
+    pool_stats.pool_size_bytes += capacity;
+  }
+
+  slot->in_use = 1;
+  return slot->buf;
+}
+
+
+void reprompi_init_buffer_pool(int enable) {
+  int i;
+
+  pool_enabled = enable;
+  for (i = 0; i < REPROMPI_BUFFER_POOL_NSLOTS; i++) {
+    pool_slots[i].buf = NULL;
+    pool_slots[i].capacity = 0;
+    pool_slots[i].in_use = 0;
+  }
+  memset(&pool_stats, 0, sizeof(reprompi_buffer_pool_stats_t));
+}
+
+void reprompi_cleanup_buffer_pool(void) {
+  int i;
+
+  for (i = 0; i < REPROMPI_BUFFER_POOL_NSLOTS; i++) {
+    release_buffer(pool_slots[i].buf);
+    pool_slots[i].buf = NULL;
+    pool_slots[i].capacity = 0;
+    pool_slots[i].in_use = 0;
+  }
+  pool_stats.pool_size_bytes = 0;
+  pool_enabled = 0;
+}
+
+int reprompi_buffer_pool_enabled(void) {
+  return pool_enabled;
+}
+
+void reprompi_get_buffer_pool_stats(reprompi_buffer_pool_stats_t* stats_p) {
+  *stats_p = pool_stats;
+}
+
+double reprompi_buffer_pool_saved_time(const reprompi_buffer_pool_stats_t* stats_p) {
+  double saved_time = 0;
+
+  // reused bytes would have cost as much as freshly allocated and faulted-in ones
+  if (stats_p->allocated_bytes > 0) {
+    saved_time = stats_p->alloc_time_sec * ((double)stats_p->reused_bytes / stats_p->allocated_bytes)
+        - stats_p->reuse_time_sec;
+  }
+  return saved_time;
+}
+
+
+void* reprompi_calloc(size_t count, size_t elem_size) {
+  void *buf = NULL;
+
+  if (pool_enabled && count * elem_size > 0) {
+    buf = pool_get_buffer(count * elem_size);
+  }
+  if (buf == NULL) {
+    buf = allocate_buffer(count, elem_size);
+  }
+
+  return buf;
+}
+
+void reprompi_free(void* buf) {
+  int i;
+
+  if (buf == NULL) {
+    return;
+  }
+
+  // pool buffers are kept for the next job
+  for (i = 0; i < REPROMPI_BUFFER_POOL_NSLOTS; i++) {
+    if (pool_slots[i].buf == buf && pool_slots[i].in_use) {
+      pool_slots[i].in_use = 0;
+      return;
+    }
+  }
+  release_buffer(buf);
+}
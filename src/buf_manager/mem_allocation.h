@@ -24,6 +24,42 @@
 #ifndef REPROMPI_MEM_ALLOCATION_H_
 #define REPROMPI_MEM_ALLOCATION_H_
 
+#include <stddef.h>
+
+typedef enum reprompi_buffer_alloc {
+  REPROMPI_BUFFER_ALLOC_CALLOC = 0,
+  REPROMPI_BUFFER_ALLOC_ALIGNED,
+  REPROMPI_BUFFER_ALLOC_HUGEPAGE,
+  REPROMPI_BUFFER_ALLOC_MPI_ALLOC_MEM,
+  REPROMPI_BUFFER_ALLOC_NUMA_LOCAL,
+  REPROMPI_N_BUFFER_ALLOC
+} reprompi_buffer_alloc_t;
+
+typedef struct {
+  long n_jobs;                /* number of jobs that requested buffers from the pool */
+  size_t pool_size_bytes;     /* memory currently kept by the pool */
+  size_t allocated_bytes;     /* memory newly allocated and pre-faulted by the pool */
+  size_t reused_bytes;        /* memory handed out again without allocation */
+  double alloc_time_sec;      /* time spent allocating and pre-faulting */
+  double reuse_time_sec;      /* time spent clearing reused buffers */
+} reprompi_buffer_pool_stats_t;
+
 void* reprompi_calloc(size_t count, size_t elem_size);
+void reprompi_free(void* buf);
+
+/* allocator backend used for all benchmark buffers (--buffer-alloc) */
+char* const* get_buffer_alloc_list(void);
+void reprompi_set_buffer_alloc(reprompi_buffer_alloc_t alloc);
+reprompi_buffer_alloc_t reprompi_get_buffer_alloc(void);
+
+/*
+ * the buffer pool keeps the buffers released with reprompi_free()
+ * and hands them out again to the next jobs
+ */
+void reprompi_init_buffer_pool(int enable);
+void reprompi_cleanup_buffer_pool(void);
+int reprompi_buffer_pool_enabled(void);
+void reprompi_get_buffer_pool_stats(reprompi_buffer_pool_stats_t* stats_p);
+double reprompi_buffer_pool_saved_time(const reprompi_buffer_pool_stats_t* stats_p);
 
 #endif /* REPROMPI_MEM_ALLOCATION_H_ */
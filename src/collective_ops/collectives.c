@@ -215,6 +215,26 @@ const collective_ops_t collective_calls[] = {
                 &initialize_data_default,
                 &cleanup_data_default
         },
+        [BBARRIER_TREE] = {
+                &execute_BBarrier_Tree,
+                &initialize_data_default,
+                &cleanup_data_default
+        },
+        [BBARRIER_TOURNAMENT] = {
+                &execute_BBarrier_Tournament,
+                &initialize_data_default,
+                &cleanup_data_default
+        },
+        [BBARRIER_BUTTERFLY] = {
+                &execute_BBarrier_Butterfly,
+                &initialize_data_default,
+                &cleanup_data_default
+        },
+        [BBARRIER_TWO_LEVEL] = {
+                &execute_BBarrier_TwoLevel,
+                &initialize_data_BBarrier_TwoLevel,
+                &cleanup_data_BBarrier_TwoLevel
+        },
         [EMPTY] = {
                 &execute_Empty,
                 &initialize_data_default,
@@ -261,6 +281,10 @@ static char* const mpi_calls_opts[] = {
         [PINGPONG_ISEND_IRECV] = "Isend_Irecv",
         [PINGPONG_SEND_IRECV] = "Send_Irecv",
         [BBARRIER] = "BBarrier",
+        [BBARRIER_TREE] = "BBarrier_Tree",
+        [BBARRIER_TOURNAMENT] = "BBarrier_Tournament",
+        [BBARRIER_BUTTERFLY] = "BBarrier_Butterfly",
+        [BBARRIER_TWO_LEVEL] = "BBarrier_TwoLevel",
         [EMPTY] = "Empty",
         NULL
 };
@@ -290,7 +314,7 @@ char* get_call_from_index(int index) {
     if (index < 0 || index >= N_MPI_CALLS) {
         return "";
     }
-    return strdup(mpi_calls_opts[index]);
+    return mpi_calls_opts[index];
 }
 
 
@@ -299,6 +323,22 @@ inline void execute_BBarrier(collective_params_t* params) {
     dissemination_barrier();
 }
 
+inline void execute_BBarrier_Tree(collective_params_t* params) {
+    binomial_tree_barrier();
+}
+
+inline void execute_BBarrier_Tournament(collective_params_t* params) {
+    tournament_barrier();
+}
+
+inline void execute_BBarrier_Butterfly(collective_params_t* params) {
+    butterfly_barrier();
+}
+
+inline void execute_BBarrier_TwoLevel(collective_params_t* params) {
+    two_level_barrier();
+}
+
 
 inline void execute_Empty(collective_params_t* params) {
 }
@@ -329,13 +369,26 @@ void initialize_data_default(const basic_collective_params_t info, const long co
 
 
 void cleanup_data_default(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
 
 
+void initialize_data_BBarrier_TwoLevel(const basic_collective_params_t info, const long count,
+        collective_params_t* params) {
+    initialize_data_default(info, count, params);
+    bbarrier_init_two_level();
+}
+
+
+void cleanup_data_BBarrier_TwoLevel(collective_params_t* params) {
+    bbarrier_cleanup_two_level();
+    cleanup_data_default(params);
+}
+
+
 void initialize_common_data(const basic_collective_params_t info,
         collective_params_t* params) {
 
@@ -66,6 +66,10 @@ enum {
     PINGPONG_ISEND_IRECV,
     PINGPONG_SEND_IRECV,
     BBARRIER,
+    BBARRIER_TREE,
+    BBARRIER_TOURNAMENT,
+    BBARRIER_BUTTERFLY,
+    BBARRIER_TWO_LEVEL,
     EMPTY,
     N_MPI_CALLS         // number of calls
 };
@@ -129,7 +133,7 @@ typedef struct coll_op {
 } collective_ops_t;
 
 int get_call_index(char* name);
-char* get_call_from_index(int index);
+char* get_call_from_index(int index);    // the returned name must not be freed
 char* const* get_mpi_calls_list(void);
 
 extern const collective_ops_t collective_calls[];
@@ -156,6 +160,10 @@ void execute_Scan(collective_params_t* params);
 void execute_Scatter(collective_params_t* params);
 
 void execute_BBarrier(collective_params_t* params);
+void execute_BBarrier_Tree(collective_params_t* params);
+void execute_BBarrier_Tournament(collective_params_t* params);
+void execute_BBarrier_Butterfly(collective_params_t* params);
+void execute_BBarrier_TwoLevel(collective_params_t* params);
 void execute_Empty(collective_params_t* params);
 
 // Mockup functions to measure for MPI guidelines
@@ -222,9 +230,13 @@ void initialize_data_GL_Scatter_as_Bcast(const basic_collective_params_t info, c
 // buffer initialization for pingpongs
 void initialize_data_pingpong(const basic_collective_params_t info, const long count, collective_params_t* params);
 
+// set-up of the shared memory for the two-level barrier
+void initialize_data_BBarrier_TwoLevel(const basic_collective_params_t info, const long count, collective_params_t* params);
+
 
 // buffer cleanup functions
 void cleanup_data_default(collective_params_t* params);
+void cleanup_data_BBarrier_TwoLevel(collective_params_t* params);
 
 
 void cleanup_data_Allgather(collective_params_t* params);
@@ -71,8 +71,8 @@ void initialize_data_GL_Allgather_as_Alltoall(const basic_collective_params_t in
 
 
 void cleanup_data_GL_Allgather_as_Alltoall(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
@@ -149,9 +149,9 @@ void initialize_data_GL_Allgather_as_Allreduce(const basic_collective_params_t i
 
 
 void cleanup_data_GL_Allgather_as_Allreduce(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
@@ -201,8 +201,8 @@ void initialize_data_GL_Allgather_as_GatherBcast(const basic_collective_params_t
 
 
 void cleanup_data_GL_Allgather_as_GatherBcast(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 
@@ -76,8 +76,8 @@ void initialize_data_GL_Allreduce_as_ReduceBcast(const basic_collective_params_t
 
 void cleanup_data_GL_Allreduce_as_ReduceBcast(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 
@@ -127,9 +127,9 @@ void initialize_data_GL_Allreduce_as_ReducescatterblockAllgather(const basic_col
 
 void cleanup_data_GL_Allreduce_as_ReducescatterblockAllgather(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
@@ -203,12 +203,12 @@ void initialize_data_GL_Allreduce_as_ReducescatterAllgatherv(const basic_collect
 
 void cleanup_data_GL_Allreduce_as_ReducescatterAllgatherv(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
-    free(params->counts_array);
-    free(params->displ_array);
-    free(params->scounts_array);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
+    reprompi_free(params->counts_array);
+    reprompi_free(params->displ_array);
+    reprompi_free(params->scounts_array);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
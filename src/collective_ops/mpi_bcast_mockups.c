@@ -63,9 +63,9 @@ void initialize_data_GL_Bcast_as_ScatterAllgather(const basic_collective_params_
 
 void cleanup_data_GL_Bcast_as_ScatterAllgather(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
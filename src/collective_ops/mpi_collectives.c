@@ -99,8 +99,8 @@ void initialize_data_Scatter(const basic_collective_params_t info, const long co
 
 
 void cleanup_data_Scatter(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
@@ -137,8 +137,8 @@ void initialize_data_Gather(const basic_collective_params_t info, const long cou
 
 
 void cleanup_data_Gather(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
@@ -173,8 +173,8 @@ void initialize_data_Allgather(const basic_collective_params_t info, const long
 
 
 void cleanup_data_Allgather(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
@@ -227,9 +227,9 @@ void initialize_data_Reduce_scatter(const basic_collective_params_t info, const
 
 
 void cleanup_data_Reduce_scatter(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->counts_array);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->counts_array);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->counts_array = NULL;
@@ -274,8 +274,8 @@ void initialize_data_Reduce_scatter_block(const basic_collective_params_t info,
 
 void cleanup_data_Reduce_scatter_block(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
@@ -309,8 +309,8 @@ void initialize_data_Alltoall(const basic_collective_params_t info, const long c
 
 
 void cleanup_data_Alltoall(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
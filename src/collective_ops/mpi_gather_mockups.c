@@ -60,8 +60,8 @@ void initialize_data_GL_Gather_as_Allgather(const basic_collective_params_t info
 
 void cleanup_data_GL_Gather_as_Allgather(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 
@@ -140,9 +140,9 @@ void initialize_data_GL_Gather_as_Reduce(const basic_collective_params_t info, c
 
 void cleanup_data_GL_Gather_as_Reduce(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
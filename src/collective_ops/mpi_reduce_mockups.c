@@ -58,8 +58,8 @@ void initialize_data_GL_Reduce_as_Allreduce(const basic_collective_params_t info
 
 
 void cleanup_data_GL_Reduce_as_Allreduce(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 
@@ -106,9 +106,9 @@ void initialize_data_GL_Reduce_as_ReducescatterblockGather(const basic_collectiv
 
 void cleanup_data_GL_Reduce_as_ReducescatterblockGather(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
@@ -178,12 +178,12 @@ void initialize_data_GL_Reduce_as_ReducescatterGatherv(const basic_collective_pa
 
 
 void cleanup_data_GL_Reduce_as_ReducescatterGatherv(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
-    free(params->counts_array);
-    free(params->displ_array);
-    free(params->scounts_array);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
+    reprompi_free(params->counts_array);
+    reprompi_free(params->displ_array);
+    reprompi_free(params->scounts_array);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
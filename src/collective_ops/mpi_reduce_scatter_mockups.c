@@ -80,9 +80,9 @@ void initialize_data_GL_Reduce_scatter_block_as_ReduceScatter(const basic_collec
 
 
 void cleanup_data_GL_Reduce_scatter_block_as_ReduceScatter(collective_params_t* params) {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
@@ -130,9 +130,9 @@ void initialize_data_GL_Reduce_scatter_as_Allreduce(const basic_collective_param
 
 void cleanup_data_GL_Reduce_scatter_as_Allreduce(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 
@@ -202,12 +202,12 @@ void initialize_data_GL_Reduce_scatter_as_ReduceScatterv(const basic_collective_
 
 void cleanup_data_GL_Reduce_scatter_as_ReduceScatterv(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
 
-    free(params->counts_array);
-    free(params->displ_array);
+    reprompi_free(params->counts_array);
+    reprompi_free(params->displ_array);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
@@ -76,9 +76,9 @@ void initialize_data_GL_Scan_as_ExscanReducelocal(const basic_collective_params_
 
 void cleanup_data_GL_Scan_as_ExscanReducelocal(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
-    free(params->tmp_buf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
+    reprompi_free(params->tmp_buf);
     params->sbuf = NULL;
     params->rbuf = NULL;
     params->tmp_buf = NULL;
@@ -67,8 +67,8 @@ void initialize_data_GL_Scatter_as_Bcast(const basic_collective_params_t info, c
 
 void cleanup_data_GL_Scatter_as_Bcast(collective_params_t* params)
 {
-    free(params->sbuf);
-    free(params->rbuf);
+    reprompi_free(params->sbuf);
+    reprompi_free(params->rbuf);
     params->sbuf = NULL;
     params->rbuf = NULL;
 }
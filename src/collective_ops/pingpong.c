@@ -262,8 +262,8 @@ void initialize_data_pingpong(const basic_collective_params_t info, const long c
 }
 
 void cleanup_data_pingpong(collective_params_t* params) {
-  free(params->sbuf);
-  free(params->rbuf);
+  reprompi_free(params->sbuf);
+  reprompi_free(params->rbuf);
   params->sbuf = NULL;
   params->rbuf = NULL;
 }
@@ -19,7 +19,7 @@ do {\
   HRT_GET_FREQUENCY(freq); \
 } while(0)
 
-inline uint64_t cntpct(void)
+static inline uint64_t cntpct(void)
 {
     uint64_t pct;
     HRT_GET_TIMESTAMP(pct);
@@ -18,7 +18,7 @@
   HRT_GET_FREQUENCY(freq); \
 } while(0)
 
-inline uint64_t cntvct(void)
+static inline uint64_t cntvct(void)
 {
     uint64_t vct;
     HRT_GET_TIMESTAMP(vct);
@@ -10,8 +10,8 @@
    You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
-// allow strdup with c99
-#define _POSIX_C_SOURCE 200809L
+// allow strdup with c99 (and getsubopt)
+#define _XOPEN_SOURCE 500
 
 #include <assert.h>
 #include <getopt.h>
@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "reprompi_bench/misc.h"
+
 #include "contrib/intercommunication/intercommunication.h"
 
 #include "options_parser.h"
@@ -35,9 +37,10 @@ enum process_skew_getopt_ids
     SKEW_ARGS_MPI_BARRIER = 'm',
     SKEW_ARGS_DISSEMINATION_BARRIER = 'b',
     SKEW_ARGS_DOUBLE_BARRIER = 'd',
+    SKEW_ARGS_METHODS = 's',
 };
 
-static const char skew_short_options[] = "ho:wmbd";
+static const char skew_short_options[] = "ho:wmbds:";
 
 static const struct option skew_long_options[] = {
         { "help", no_argument, 0, SKEW_ARGS_HELP },
@@ -47,14 +50,53 @@ static const struct option skew_long_options[] = {
         { "barrier", no_argument, 0, SKEW_ARGS_MPI_BARRIER },
         { "bbarrier", no_argument, 0, SKEW_ARGS_DISSEMINATION_BARRIER },
         { "double", no_argument, 0, SKEW_ARGS_DOUBLE_BARRIER },
+        { "sync-methods", required_argument, 0, SKEW_ARGS_METHODS },
         { NULL, 0, NULL, 0 }
 };
 
+// names accepted by --sync-methods (same order as skew_method_id_t)
+static char* const skew_method_opts[] = {
+        [SKEW_METHOD_MPI_BARRIER] = "barrier",
+        [SKEW_METHOD_BBARRIER] = "bbarrier",
+        [SKEW_METHOD_BBARRIER_TREE] = "bbarrier-tree",
+        [SKEW_METHOD_BBARRIER_TOURNAMENT] = "bbarrier-tournament",
+        [SKEW_METHOD_BBARRIER_BUTTERFLY] = "bbarrier-butterfly",
+        [SKEW_METHOD_BBARRIER_TWO_LEVEL] = "bbarrier-two-level",
+        [SKEW_METHOD_SK] = "sk",
+        [SKEW_METHOD_JK] = "jk",
+        [SKEW_METHOD_HCA] = "hca",
+        NULL
+};
+
+// names printed in the test column
+static const char* const skew_method_names[] = {
+        [SKEW_METHOD_MPI_BARRIER] = "MPI_Barrier",
+        [SKEW_METHOD_BBARRIER] = "BBarrier",
+        [SKEW_METHOD_BBARRIER_TREE] = "BBarrier_Tree",
+        [SKEW_METHOD_BBARRIER_TOURNAMENT] = "BBarrier_Tournament",
+        [SKEW_METHOD_BBARRIER_BUTTERFLY] = "BBarrier_Butterfly",
+        [SKEW_METHOD_BBARRIER_TWO_LEVEL] = "BBarrier_TwoLevel",
+        [SKEW_METHOD_SK] = "SK_window",
+        [SKEW_METHOD_JK] = "JK_window",
+        [SKEW_METHOD_HCA] = "HCA_window"
+};
+
+const char* get_skew_method_name(skew_method_id_t method)
+{
+    return skew_method_names[method];
+}
+
+int is_window_skew_method(skew_method_id_t method)
+{
+    return (method == SKEW_METHOD_SK || method == SKEW_METHOD_JK || method == SKEW_METHOD_HCA);
+}
+
 static void init_options(skew_options_t* opt)
 {
-    opt->use_window = 0;
-    opt->use_mpi_barrier = 0;
-    opt->use_dissemination_barrier = 0;
+    for (int i = 0; i < SKEW_N_METHODS; i++)
+    {
+        opt->use_method[i] = 0;
+    }
     opt->use_double_barrier = 0;
     opt->output_file = NULL;
 }
@@ -64,12 +106,16 @@ static void print_process_skew_help(char* command) {
     {
         printf("Usage: mpiexec -n <numprocs> %s [options]\n", command);
 
-        printf("\nMeasures process skew after synchronizing processes.\n");
-        printf("(Clocks are synchronized using JK-algorithm).\n");
+        printf("\nMeasures process skew after synchronizing processes with each of the\n");
+        printf("selected methods (all methods by default).\n");
+        printf("(Start times are compared on the global clock of the HCA-algorithm).\n");
 
         printf("\noptions for measuring process skew:\n");
         printf("%-25s %-.54s\n", "-h,--help", "prints this help message");
         printf("%-25s %-.54s\n", "-o,--output=<path>", "results file");
+        printf("%-25s %-.54s\n", "-s,--sync-methods=<list>", "comma-separated list of synchronization methods:");
+        printf("%-29s %-.50s\n", "", "barrier, bbarrier, bbarrier-tree, bbarrier-tournament,");
+        printf("%-29s %-.50s\n", "", "bbarrier-butterfly, bbarrier-two-level, sk, jk, hca");
         printf("%-25s %-.54s\n", "-w,--window", "use window synchronization (JK)");
         printf("%-25s %-.54s\n", "-m,--barrier", "use MPI_Barrier synchronization");
         printf("%-25s %-.54s\n", "-b,--bbarrier", "use dissemination barrier synchronization");
@@ -131,16 +177,33 @@ void parse_process_skew_options(skew_options_t* opt, int argc, char **argv)
 				break;
 
             case SKEW_ARGS_WINDOW:
-                opt->use_window = 1;
+                opt->use_method[SKEW_METHOD_JK] = 1;
 				break;
 
 			case SKEW_ARGS_MPI_BARRIER:
-                opt->use_mpi_barrier = 1;
+                opt->use_method[SKEW_METHOD_MPI_BARRIER] = 1;
 				break;
 
             case SKEW_ARGS_DISSEMINATION_BARRIER:
-                opt->use_dissemination_barrier = 1;
+                opt->use_method[SKEW_METHOD_BBARRIER] = 1;
+                break;
+
+            case SKEW_ARGS_METHODS:
+            {
+                char* subopts = optarg;
+                char* value;
+
+                while (*subopts != '\0')
+                {
+                    int index = getsubopt(&subopts, skew_method_opts, &value);
+                    if (index < 0 || index >= SKEW_N_METHODS)
+                    {
+                        reprompib_print_error_and_exit("Unknown synchronization method in --sync-methods");
+                    }
+                    opt->use_method[index] = 1;
+                }
                 break;
+            }
 
             case SKEW_ARGS_DOUBLE_BARRIER:
                 opt->use_double_barrier = 1;
@@ -154,29 +217,17 @@ void parse_process_skew_options(skew_options_t* opt, int argc, char **argv)
     optind = 1;	// reset optind to enable option re-parsing
     opterr = 1;	// reset opterr to catch invalid options
 
-    // sanity checks
-    if (opt->use_window)
+    // default: profile all methods
+    int n_methods = 0;
+    for (int i = 0; i < SKEW_N_METHODS; i++)
     {
-        opt->use_mpi_barrier = 0;
-        opt ->use_dissemination_barrier = 0;
-        opt->use_double_barrier = 0;
+        n_methods += opt->use_method[i];
     }
-
-    if (opt->use_dissemination_barrier)
-    {
-        opt->use_window = 0;
-        opt->use_mpi_barrier = 0;
-    }
-
-    if (opt->use_mpi_barrier)
-    {
-        opt->use_window = 0;
-        opt->use_dissemination_barrier = 0;
-    }
-
-    if (!opt->use_window && !opt->use_mpi_barrier && !opt->use_dissemination_barrier)
+    if (n_methods == 0)
     {
-        // default: MPI_Barrier
-        opt->use_mpi_barrier = 1;
+        for (int i = 0; i < SKEW_N_METHODS; i++)
+        {
+            opt->use_method[i] = 1;
+        }
     }
 }
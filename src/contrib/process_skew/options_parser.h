@@ -13,14 +13,29 @@
 #ifndef SKEW_OPTIONS_PARSER_H
 #define SKEW_OPTIONS_PARSER_H
 
+// synchronization methods whose exit skew can be measured (in the order of the output)
+typedef enum {
+    SKEW_METHOD_MPI_BARRIER = 0,
+    SKEW_METHOD_BBARRIER,
+    SKEW_METHOD_BBARRIER_TREE,
+    SKEW_METHOD_BBARRIER_TOURNAMENT,
+    SKEW_METHOD_BBARRIER_BUTTERFLY,
+    SKEW_METHOD_BBARRIER_TWO_LEVEL,
+    SKEW_METHOD_SK,
+    SKEW_METHOD_JK,
+    SKEW_METHOD_HCA,
+    SKEW_N_METHODS
+} skew_method_id_t;
+
 typedef struct {
-    int use_window;
-    int use_mpi_barrier;
-    int use_dissemination_barrier;
+    int use_method[SKEW_N_METHODS];
     int use_double_barrier;
     char* output_file;
 } skew_options_t;
 
+const char* get_skew_method_name(skew_method_id_t method);
+int is_window_skew_method(skew_method_id_t method);
+
 void parse_process_skew_options (skew_options_t* opt, int argc, char** argv);
 void free_process_skew_options(skew_options_t* opt);
 
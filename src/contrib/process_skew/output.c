@@ -26,7 +26,9 @@
 
 #include "reprompi_bench/option_parser/parse_extra_key_value_options.h"
 #include "reprompi_bench/option_parser/parse_options.h"
-#include "reprompi_bench/sync/joneskoenig_sync/jk_sync.h"
+#include "reprompi_bench/output_management/summary_computation.h"
+#include "reprompi_bench/sync/hca_sync/hca_sync.h"
+#include "reprompi_bench/sync/sync_info.h"
 #include "reprompi_bench/sync/time_measurement.h"
 #include "version.h"
 
@@ -36,9 +38,24 @@
 #include "output.h"
 
 static const int OUTPUT_ROOT_PROC = 0;
-static const char* MPI_CALL_NAME = "process_skew";
 static const int OUTPUT_NITERATIONS_CHUNK = 3000; // approx. 1 MB per process
 
+// quantiles of the skew distributions
+static const double SKEW_QUANTILES[] = { 0.5, 0.9, 0.99 };
+enum {
+    N_SKEW_QUANTILES = 3,
+    N_RANK_SKEW_VALUES = N_SKEW_QUANTILES + 2   /* quantiles, maximum, and how often the rank was the last one */
+};
+
+// per-rank skew distribution of each profiled method (on the root)
+static double* rank_skew[SKEW_N_METHODS];
+
+// start time and rank of the last process of a repetition (MPI_DOUBLE_INT)
+typedef struct {
+    double time;
+    int rank;
+} last_start_t;
+
 void print_command_line(int argc, char** argv)
 {
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
@@ -62,7 +79,7 @@ void print_header(const skew_options_t* skew_options, const reprompib_options_t*
         if ( benchmark_options->print_summary_methods >0)
         {
           int i;
-          fprintf(f, "%14s %10s %10s ", "test", "total_nrep", "valid_nrep");
+          fprintf(f, "%20s %10s %10s ", "test", "total_nrep", "valid_nrep");
 
           for (i=0; i<reprompib_get_number_summary_methods(); i++)
           {
@@ -72,7 +89,7 @@ void print_header(const skew_options_t* skew_options, const reprompib_options_t*
               fprintf(f, "%10s_sec ", s->name);
             }
           }
-          fprintf(f, "\n");
+          fprintf(f, "%14s %14s %10s %10s\n", "p90_sec", "p99_sec", "last_rank", "last_freq");
         }
 
 
@@ -90,12 +107,7 @@ void print_header(const skew_options_t* skew_options, const reprompib_options_t*
                 fprintf(f, "%7s ", "process");
             }
 
-            fprintf(f, "%14s %10s ", "test", "nrep");
-
-            if (skew_options->use_window)
-            {
-                fprintf(f, "%10s ", "errorcode");
-            }
+            fprintf(f, "%20s %10s %10s ", "test", "nrep", "errorcode");
 
             if (benchmark_options->verbose)
             {
@@ -103,7 +115,7 @@ void print_header(const skew_options_t* skew_options, const reprompib_options_t*
             }
             else
             {
-                fprintf(f, "%14s\n", "max_skew_sec");
+                fprintf(f, "%14s %10s\n", "max_skew_sec", "last_rank");
             }
         }
 
@@ -114,11 +126,18 @@ void print_header(const skew_options_t* skew_options, const reprompib_options_t*
     }
 }
 
-static void print_settings_to_file(FILE* f, const skew_options_t* skew_options, const reprompib_dictionary_t* params_dict, const reprompib_options_t* benchmark_options)
+static void print_settings_to_file(FILE* f, const skew_options_t* skew_options, const reprompib_dictionary_t* params_dict,
+        const reprompib_options_t* benchmark_options, const reprompib_sync_options_t* reference_sync_options)
 {
     // print_benchmark_common_settings_to_file
     fprintf(f, "#MPI calls:\n");
-    fprintf(f, "#\t%s\n", MPI_CALL_NAME);
+    for (int method = 0; method < SKEW_N_METHODS; method++)
+    {
+        if (skew_options->use_method[method])
+        {
+            fprintf(f, "#\t%s\n", get_skew_method_name(method));
+        }
+    }
 
     // print_common_settings_to_file
     reprompib_print_dictionary(params_dict, f);
@@ -135,358 +154,404 @@ static void print_settings_to_file(FILE* f, const skew_options_t* skew_options,
     }
     fprintf(f, "#@clocktype=global\n");
     print_time_parameters(f);
-    jk_print_sync_parameters(f);
+
+    // the reference clock (HCA) and the windows of the window-based methods
+    fprintf(f, "#@reference_clock=HCA\n");
+    fprintf(f, "#@fitpoints=%d\n", reference_sync_options->n_fitpoints);
+    fprintf(f, "#@exchanges=%d\n", reference_sync_options->n_exchanges);
+    fprintf(f, "#@window_s=%.10f\n", reference_sync_options->window_size_sec);
+    fprintf(f, "#@wait_time_s=%.10f\n", reference_sync_options->wait_time_sec);
 
     // print_initial_settings
     fprintf(f, "#@nrep=%ld\n", benchmark_options->n_rep);
 
     // process skew options
-    if (skew_options->use_window)
-    {
-        fprintf(f, "#@process_sync=window\n");
-    }
-    else if (skew_options->use_mpi_barrier)
-    {
-        fprintf(f, "#@process_sync=MPI_Barrier\n");
-    }
-    else if (skew_options->use_dissemination_barrier)
-    {
-        fprintf(f, "#@process_sync=BBarrier\n");
-    }
     if (skew_options->use_double_barrier)
     {
         fprintf(f, "#@doublebarrier=true\n");
     }
 }
 
-void print_settings(const skew_options_t* skew_options, const reprompib_dictionary_t* params_dict, const reprompib_options_t* benchmark_options)
+void print_settings(const skew_options_t* skew_options, const reprompib_dictionary_t* params_dict,
+        const reprompib_options_t* benchmark_options, const reprompib_sync_options_t* reference_sync_options)
 {
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
     {
         FILE* f = stdout;
-        print_settings_to_file(f, skew_options, params_dict, benchmark_options);
-        if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
-            if (skew_options->output_file != NULL) {
-                f = fopen(skew_options->output_file, "a");
-                print_settings_to_file(f, skew_options, params_dict, benchmark_options);
-                fflush(f);
-                fclose(f);
-            }
+        print_settings_to_file(f, skew_options, params_dict, benchmark_options, reference_sync_options);
+        if (skew_options->output_file != NULL) {
+            f = fopen(skew_options->output_file, "a");
+            print_settings_to_file(f, skew_options, params_dict, benchmark_options, reference_sync_options);
+            fflush(f);
+            fclose(f);
         }
     }
 }
 
-static void compute_starttimes_global_clocks(const skew_options_t* skew_options, const double* tstart_sec, long current_start_index, long current_nreps, double* max_process_skew, int* sync_errorcodes)
+/*
+ * computes the skew of each repetition (on the root) and the skew of each
+ * process relative to the first process of the repetition (on all processes)
+ */
+static void compute_starttimes_global_clocks(const reprompib_options_t* benchmark_options, const double* tstart_sec,
+        const int* local_errorcodes, double* max_process_skew, int* last_rank, int* sync_errorcodes, double* local_skew)
 {
+    long n_rep = benchmark_options->n_rep;
 
-    // gather error codes in the  [current_start_index, current_start_index + current_nreps) interval
-    int* local_errorcodes = NULL;
-    if (skew_options->use_window)
+    // gather error codes
+    if (local_errorcodes != NULL)
     {
-        local_errorcodes = jk_get_local_sync_errorcodes() + current_start_index;
-        MPI_Reduce(local_errorcodes, sync_errorcodes, current_nreps, MPI_INT, MPI_MAX, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+        MPI_Reduce(local_errorcodes, sync_errorcodes, n_rep, MPI_INT, MPI_MAX, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
     }
 
-    double* start_sec = NULL;
-    double* end_sec = NULL;
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    double* norm_tstart_sec = (double*)malloc(n_rep * sizeof(double));
+    double* start_sec = (double*)malloc(n_rep * sizeof(double));
+    last_start_t* local_start = (last_start_t*)malloc(n_rep * sizeof(last_start_t));
+    last_start_t* last_start = (last_start_t*)malloc(n_rep * sizeof(last_start_t));
+
+    // normalize results to the reference clock
+    for (int i = 0; i < n_rep; i++)
     {
-        start_sec = (double*)malloc(current_nreps * sizeof(double));
-        end_sec = (double*)malloc(current_nreps * sizeof(double));
+        norm_tstart_sec[i] = hca_get_normalized_time(tstart_sec[i]);
+        local_start[i].time = norm_tstart_sec[i];
+        local_start[i].rank = icmb_global_rank();
     }
 
-    double* norm_tstart_sec = (double*)malloc(current_nreps * sizeof(double));
+    // first start time and last process of each repetition
+    MPI_Allreduce(norm_tstart_sec, start_sec, n_rep, MPI_DOUBLE, MPI_MIN, icmb_global_communicator());
+    MPI_Allreduce(local_start, last_start, n_rep, MPI_DOUBLE_INT, MPI_MAXLOC, icmb_global_communicator());
 
-    // normalize results in the  [current_start_index, current_start_index + current_nreps) interval
-    int index;
-    for (int i = 0; i < current_nreps; i++)
+    for (int i = 0; i < n_rep; i++)
     {
-        index = i + current_start_index;
-        norm_tstart_sec[i] = jk_get_normalized_time(tstart_sec[index]);
+        local_skew[i] = norm_tstart_sec[i] - start_sec[i];
+        last_rank[i] = last_start[i].rank;
     }
 
-    // gather results at the root process and compute start times
-    MPI_Reduce(norm_tstart_sec, start_sec, current_nreps, MPI_DOUBLE, MPI_MIN, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
-    MPI_Reduce(norm_tstart_sec, end_sec, current_nreps, MPI_DOUBLE, MPI_MAX, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
-
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
     {
-        for (int i = 0; i< current_nreps; i++)
+        for (int i = 0; i < n_rep; i++)
         {
-            index = i + current_start_index;
-            max_process_skew[index] = end_sec[index] - start_sec[index];
+            max_process_skew[i] = last_start[i].time - start_sec[i];
         }
-
-        free(start_sec);
-        free(end_sec);
     }
 
     free(norm_tstart_sec);
+    free(start_sec);
+    free(local_start);
+    free(last_start);
 }
 
-static void print_summary(FILE* f,const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, double* tstart_sec)
+/*
+ * distribution of the skew of this process (quantiles and maximum) and the
+ * fraction of repetitions in which it was the last process, gathered at the root
+ */
+static void gather_rank_skew(const reprompib_options_t* benchmark_options, int method, double* local_skew, const int* last_rank)
 {
-    double* max_process_skew = NULL;
-    int* sync_errorcodes = NULL;
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    long n_rep = benchmark_options->n_rep;
+    double values[N_RANK_SKEW_VALUES];
+    long n_last = 0;
+
+    gsl_sort(local_skew, 1, n_rep);
+    for (int q = 0; q < N_SKEW_QUANTILES; q++)
     {
-        max_process_skew = (double*) malloc(benchmark_options->n_rep * sizeof(double));
+        values[q] = gsl_stats_quantile_from_sorted_data(local_skew, 1, n_rep, SKEW_QUANTILES[q]);
+    }
+    values[N_SKEW_QUANTILES] = local_skew[n_rep - 1];
 
-        if (skew_options->use_window)
+    for (int i = 0; i < n_rep; i++)
+    {
+        if (last_rank[i] == icmb_global_rank())
         {
-            sync_errorcodes = (int*) malloc(benchmark_options->n_rep * sizeof(int));
-            for (int i = 0; i < benchmark_options->n_rep; i++)
-            {
-                sync_errorcodes[i] = 0;
-            }
+            n_last++;
         }
     }
+    values[N_SKEW_QUANTILES + 1] = (double)n_last / n_rep;
 
-    long current_start_index = 0;
-    compute_starttimes_global_clocks(skew_options, tstart_sec, current_start_index, benchmark_options->n_rep, max_process_skew, sync_errorcodes);
-
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
-        long valid_nreps = 0;
-
-        // don't count measurements with out-of-window errors as valid,
-        // but display the result anyway, because we want to see
-        // the process skew
-        if (skew_options->use_window)
-        {
-            for (int i = 0; i < benchmark_options->n_rep; i++)
-            {
-                if (sync_errorcodes[i] == 0)
-                {
-                    valid_nreps++;
-                }
-            }
-        }
-        else
-        {
-            valid_nreps = benchmark_options->n_rep;
-        }
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    {
+        rank_skew[method] = (double*)malloc(icmb_global_size() * N_RANK_SKEW_VALUES * sizeof(double));
+    }
+    MPI_Gather(values, N_RANK_SKEW_VALUES, MPI_DOUBLE, rank_skew[method], N_RANK_SKEW_VALUES, MPI_DOUBLE,
+            icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+}
 
-        gsl_sort(max_process_skew, 1, benchmark_options->n_rep);
-        fprintf(f, "%14s %10ld %10ld ", MPI_CALL_NAME, benchmark_options->n_rep, valid_nreps);
+/*
+ * the process that was the last one most often
+ */
+static int most_frequent_last_rank(const int* last_rank, long n_rep, long* count)
+{
+    int np = icmb_global_size();
+    long* n_last = (long*)calloc(np, sizeof(long));
+    int argmax = 0;
 
-        if (benchmark_options->print_summary_methods > 0)
+    for (int i = 0; i < n_rep; i++)
+    {
+        n_last[last_rank[i]]++;
+    }
+    for (int p = 1; p < np; p++)
+    {
+        if (n_last[p] > n_last[argmax])
         {
-          for (int i=0; i<reprompib_get_number_summary_methods(); i++)
-          {
-            summary_method_info_t* s = reprompib_get_summary_method(i);
-
-            if (benchmark_options->print_summary_methods & s->mask)
-            {
-              double value = 0;
-
-              if (strcmp(s->name, "mean") == 0)
-              {
-                value = gsl_stats_mean(max_process_skew, 1, benchmark_options->n_rep);
-              }
-              else if (strcmp(s->name, "median") == 0)
-              {
-                value = gsl_stats_quantile_from_sorted_data (max_process_skew, 1, benchmark_options->n_rep, 0.5);
-              }
-              else if (strcmp(s->name, "min") == 0)
-              {
-                if (benchmark_options->n_rep > 0) {
-                  value = max_process_skew[0];
-                }
-              }
-              else if (strcmp(s->name, "max") == 0)
-              {
-                if (benchmark_options->n_rep > 0) {
-                  value = max_process_skew[benchmark_options->n_rep-1];
-                }
-              }
-              fprintf(f, "  %.10f ", value);
-            }
-          }
+            argmax = p;
         }
-        fprintf(f, "\n");
-
-        free(sync_errorcodes);
-        free(max_process_skew);
     }
+    *count = n_last[argmax];
+    free(n_last);
+    return argmax;
 }
 
-static void print_skewtimes(FILE* f,const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, double* tstart_sec)
+static void print_summary(FILE* f, const reprompib_options_t* benchmark_options, int method,
+        const double* max_process_skew_unsorted, const int* last_rank, const int* sync_errorcodes)
 {
-    double* max_process_skew = NULL;
-    int* sync_errorcodes = NULL;
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
-    {
-        max_process_skew = (double*) malloc(benchmark_options->n_rep * sizeof(double));
+    long n_rep = benchmark_options->n_rep;
+    long valid_nreps = 0;
 
-        if (skew_options->use_window)
+    // don't count measurements with out-of-window errors as valid,
+    // but display the result anyway, because we want to see
+    // the process skew
+    for (int i = 0; i < n_rep; i++)
+    {
+        if (sync_errorcodes[i] == 0)
         {
-            sync_errorcodes = (int*) malloc(benchmark_options->n_rep * sizeof(int));
-            for (int i = 0; i < benchmark_options->n_rep; i++)
-            {
-                sync_errorcodes[i] = 0;
-            }
+            valid_nreps++;
         }
     }
 
-    long current_start_index = 0;
-    compute_starttimes_global_clocks(skew_options, tstart_sec, current_start_index, benchmark_options->n_rep, max_process_skew, sync_errorcodes);
+    double* max_process_skew = (double*) malloc(n_rep * sizeof(double));
+    memcpy(max_process_skew, max_process_skew_unsorted, n_rep * sizeof(double));
+    double p90 = reprompib_select_quantile(max_process_skew, n_rep, 0.9);
+    double p99 = reprompib_select_quantile(max_process_skew, n_rep, 0.99);
+    fprintf(f, "%20s %10ld %10ld ", get_skew_method_name(method), n_rep, valid_nreps);
 
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    if (benchmark_options->print_summary_methods > 0)
     {
+      for (int i=0; i<reprompib_get_number_summary_methods(); i++)
+      {
+        summary_method_info_t* s = reprompib_get_summary_method(i);
 
-        for (int i = 0; i < benchmark_options->n_rep; i++)
+        if (benchmark_options->print_summary_methods & s->mask)
         {
-            fprintf(f, "%14s %10d ", MPI_CALL_NAME, i);
+          double value = reprompib_compute_summary(s->name, max_process_skew, n_rep);
 
-            if (skew_options->use_window)
-            {
-                fprintf(f, "%10d ", sync_errorcodes[i]);
-            }
-
-            fprintf(f, "%14.10f\n", max_process_skew[i]);
+          fprintf(f, "  %.10f ", value);
         }
+      }
+    }
 
-        free(sync_errorcodes);
-        free(max_process_skew);
+    long n_last;
+    int argmax = most_frequent_last_rank(last_rank, n_rep, &n_last);
+    fprintf(f, "%14.10f %14.10f %10d %10.4f\n",
+            p90, p99, argmax, (double)n_last / n_rep);
+
+    free(max_process_skew);
+}
+
+static void print_skewtimes(FILE* f, const reprompib_options_t* benchmark_options, int method,
+        const double* max_process_skew, const int* last_rank, const int* sync_errorcodes)
+{
+    for (int i = 0; i < benchmark_options->n_rep; i++)
+    {
+        fprintf(f, "%20s %10d %10d ", get_skew_method_name(method), i, sync_errorcodes[i]);
+        fprintf(f, "%14.10f %10d\n", max_process_skew[i], last_rank[i]);
     }
 }
 
-static void print_measurements(FILE* f,const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, double* tstart_sec)
+static void print_process_skewtimes(FILE* f, const reprompib_options_t* benchmark_options, int method,
+        const int* local_errorcodes, double* tstart_sec)
 {
-    if (benchmark_options->verbose == 0) {
-        print_skewtimes(f, skew_options, benchmark_options, tstart_sec);
+    // first we calculate the minimum start time for each sample
+    // so that we know the skew of each process in that sample
+    double* tmp_minimum_start_sec_global_time = (double*) malloc(benchmark_options->n_rep * sizeof(double));
+    for (int i=0; i< benchmark_options->n_rep; ++i)
+    {
+        tmp_minimum_start_sec_global_time[i] = hca_get_normalized_time(tstart_sec[i]);
+    }
+    double* minimum_start_sec = NULL;
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    {
+        minimum_start_sec = (double*) malloc(benchmark_options->n_rep * sizeof(double));
     }
-    else
+    MPI_Reduce(tmp_minimum_start_sec_global_time, minimum_start_sec, benchmark_options->n_rep, MPI_DOUBLE, MPI_MIN, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+    free(tmp_minimum_start_sec_global_time);
+
+    // we gather data from processes in chunks of OUTPUT_NITERATIONS_CHUNK elements
+    // the total number of chunks depends on the number of repetitions of the current exp benchmark_options->n_rep
+    int nchunks = benchmark_options->n_rep/OUTPUT_NITERATIONS_CHUNK + (benchmark_options->n_rep % OUTPUT_NITERATIONS_CHUNK != 0);
+
+    int chunk_nrep = 0;
+    for (int chunk_id = 0; chunk_id < nchunks; chunk_id++)
     {
-        // first we calculate the minimum start time for each sample
-        // so that we know the skew of each process in that sample
-        double* tmp_minimum_start_sec_global_time = (double*) malloc(benchmark_options->n_rep * sizeof(double));
-        for (int i=0; i< benchmark_options->n_rep; ++i)
+        //the last chunk may be smaller than OUTPUT_NITERATIONS_CHUNK
+        if ((chunk_id == nchunks - 1) && (benchmark_options->n_rep % OUTPUT_NITERATIONS_CHUNK != 0))
         {
-            tmp_minimum_start_sec_global_time[i] = jk_get_normalized_time(tstart_sec[i]);
+            chunk_nrep = benchmark_options->n_rep % OUTPUT_NITERATIONS_CHUNK;
         }
-        double* minimum_start_sec = NULL;
-        if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+        else
         {
-            minimum_start_sec = (double*) malloc(benchmark_options->n_rep * sizeof(double));
+            chunk_nrep = OUTPUT_NITERATIONS_CHUNK;
         }
-        MPI_Reduce(tmp_minimum_start_sec_global_time, minimum_start_sec, benchmark_options->n_rep, MPI_DOUBLE, MPI_MIN, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
-        free(tmp_minimum_start_sec_global_time);
-
-        // we gather data from processes in chunks of OUTPUT_NITERATIONS_CHUNK elements
-        // the total number of chunks depends on the number of repetitions of the current exp benchmark_options->n_rep
-        int nchunks = benchmark_options->n_rep/OUTPUT_NITERATIONS_CHUNK + (benchmark_options->n_rep % OUTPUT_NITERATIONS_CHUNK != 0);
 
-        int chunk_nrep = 0;
-        for (int chunk_id = 0; chunk_id < nchunks; chunk_id++)
+        int* errorcodes = NULL;
+        if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
         {
-            //the last chunk may be smaller than OUTPUT_NITERATIONS_CHUNK
-            if ((chunk_id == nchunks - 1) && (benchmark_options->n_rep % OUTPUT_NITERATIONS_CHUNK != 0))
-            {
-                chunk_nrep = benchmark_options->n_rep % OUTPUT_NITERATIONS_CHUNK;
-            }
-            else
-            {
-                chunk_nrep = OUTPUT_NITERATIONS_CHUNK;
-            }
-
-            int* errorcodes = NULL;
-            if (skew_options->use_window)
-            {
-                if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
-                {
-                    errorcodes = (int*)malloc(chunk_nrep * icmb_global_size() * sizeof(int));
-                    for (int i = 0; i < chunk_nrep * icmb_global_size(); i++)
-                    {
-                        errorcodes[i] = 0;
-                    }
-                }
+            errorcodes = (int*)calloc(chunk_nrep * icmb_global_size(), sizeof(int));
+        }
+        if (local_errorcodes != NULL)
+        {
+            MPI_Gather(local_errorcodes + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_INT, errorcodes, chunk_nrep, MPI_INT, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+        }
 
-                int* local_errorcodes = jk_get_local_sync_errorcodes();
-                MPI_Gather(local_errorcodes + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_INT, errorcodes, chunk_nrep, MPI_INT, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
-            }
+        double* local_start_sec = NULL;
+        double* global_start_sec = NULL;
+        if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+        {
+            local_start_sec = (double*) malloc(chunk_nrep * icmb_global_size() * sizeof(double));
+            global_start_sec = (double*) malloc(chunk_nrep * icmb_global_size() * sizeof(double));
+        }
 
-            double* local_start_sec = NULL;
-            double* global_start_sec = NULL;
-            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
-            {
-                local_start_sec = (double*) malloc(chunk_nrep * icmb_global_size() * sizeof(double));
-                global_start_sec = (double*) malloc(chunk_nrep * icmb_global_size() * sizeof(double));
-            }
+        // gather measurement results
+        MPI_Gather(tstart_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, local_start_sec, chunk_nrep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+        for (int i = 0; i < chunk_nrep; i++)
+        {
+            int current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
+            tstart_sec[current_rep_id] = hca_get_normalized_time(tstart_sec[current_rep_id]);
+        }
 
-            // gather measurement results
-            MPI_Gather(tstart_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, local_start_sec, chunk_nrep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
-            for (int i = 0; i < chunk_nrep; i++)
-            {
-                int current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
-                tstart_sec[current_rep_id] = jk_get_normalized_time(tstart_sec[current_rep_id]);
-            }
+        MPI_Gather(tstart_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, global_start_sec, chunk_nrep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
 
-            MPI_Gather(tstart_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, global_start_sec, chunk_nrep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+        if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+        {
 
-            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+            for (int proc_id = 0; proc_id < icmb_global_size(); proc_id++)
             {
-
-                for (int proc_id = 0; proc_id < icmb_global_size(); proc_id++)
+                for (int i = 0; i < chunk_nrep; i++)
                 {
-                    for (int i = 0; i < chunk_nrep; i++)
-                    {
-                        int current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
-                        fprintf(f, "%7d %14s %10d ", proc_id, MPI_CALL_NAME, current_rep_id);
-
-                        if (skew_options->use_window)
-                        {
-                            fprintf(f, "%10d ", errorcodes[proc_id * chunk_nrep + i]);
-                        }
-
-                        fprintf(f, "%17.10f %17.10f ", local_start_sec[proc_id * chunk_nrep + i], global_start_sec[proc_id * chunk_nrep + i]);
-                        fprintf(f, "%14.10f\n", global_start_sec[proc_id * chunk_nrep + i] - minimum_start_sec[current_rep_id]);
-                    }
+                    int current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
+                    fprintf(f, "%7d %20s %10d ", proc_id, get_skew_method_name(method), current_rep_id);
+                    fprintf(f, "%10d ", errorcodes[proc_id * chunk_nrep + i]);
+                    fprintf(f, "%17.10f %17.10f ", local_start_sec[proc_id * chunk_nrep + i], global_start_sec[proc_id * chunk_nrep + i]);
+                    fprintf(f, "%14.10f\n", global_start_sec[proc_id * chunk_nrep + i] - minimum_start_sec[current_rep_id]);
                 }
-
-                free(local_start_sec);
-                free(global_start_sec);
-                free(errorcodes);
             }
 
+            free(local_start_sec);
+            free(global_start_sec);
+            free(errorcodes);
         }
 
-        free(minimum_start_sec);
     }
+
+    free(minimum_start_sec);
 }
 
-void print_result(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, double* tstart_sec)
+void print_result(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, int method,
+        const int* local_errorcodes, double* tstart_sec)
 {
     FILE* f = stdout;
+    long n_rep = benchmark_options->n_rep;
+    double* max_process_skew = NULL;
+    int* sync_errorcodes = NULL;
+    int* last_rank = (int*) malloc(n_rep * sizeof(int));
+    double* local_skew = (double*) malloc(n_rep * sizeof(double));
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
     {
+        max_process_skew = (double*) malloc(n_rep * sizeof(double));
+        sync_errorcodes = (int*) calloc(n_rep, sizeof(int));
+
         if (skew_options->output_file != NULL)
         {
             f = fopen(skew_options->output_file, "a");
         }
     }
 
-    if (benchmark_options->print_summary_methods >0)
+    compute_starttimes_global_clocks(benchmark_options, tstart_sec, local_errorcodes,
+            max_process_skew, last_rank, sync_errorcodes, local_skew);
+    gather_rank_skew(benchmark_options, method, local_skew, last_rank);
+
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC) && benchmark_options->print_summary_methods > 0)
+    {
+        print_summary(stdout, benchmark_options, method, max_process_skew, last_rank, sync_errorcodes);
+    }
+
+    if (skew_options->output_file != NULL || benchmark_options->print_summary_methods == 0)
+    {
+        if (benchmark_options->verbose == 0)
+        {
+            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+            {
+                print_skewtimes(f, benchmark_options, method, max_process_skew, last_rank, sync_errorcodes);
+            }
+        }
+        else
+        {
+            print_process_skewtimes(f, benchmark_options, method, local_errorcodes, tstart_sec);
+        }
+    }
+
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
     {
-        print_summary(stdout, skew_options, benchmark_options, tstart_sec);
         if (skew_options->output_file != NULL)
         {
-            print_measurements(f, skew_options, benchmark_options, tstart_sec);
+            fflush(f);
+            fclose(f);
         }
     }
-    else
+
+    free(max_process_skew);
+    free(sync_errorcodes);
+    free(last_rank);
+    free(local_skew);
+}
+
+static void print_rank_skew_to_file(FILE* f, const skew_options_t* skew_options)
+{
+    fprintf(f, "#Per-process skew distributions:\n");
+    fprintf(f, "%20s %7s ", "test", "process");
+    for (int q = 0; q < N_SKEW_QUANTILES; q++)
     {
-        print_measurements(f, skew_options, benchmark_options, tstart_sec);
+        char name[32];
+        snprintf(name, sizeof(name), "p%g_sec", SKEW_QUANTILES[q] * 100);
+        fprintf(f, "%14s ", name);
     }
+    fprintf(f, "%14s %10s\n", "max_sec", "last_freq");
 
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    for (int method = 0; method < SKEW_N_METHODS; method++)
     {
-        if (skew_options->output_file != NULL)
+        if (rank_skew[method] == NULL)
+        {
+            continue;
+        }
+        for (int proc_id = 0; proc_id < icmb_global_size(); proc_id++)
         {
+            const double* values = rank_skew[method] + proc_id * N_RANK_SKEW_VALUES;
+
+            fprintf(f, "%20s %7d ", get_skew_method_name(method), proc_id);
+            for (int q = 0; q <= N_SKEW_QUANTILES; q++)
+            {
+                fprintf(f, "%14.10f ", values[q]);
+            }
+            fprintf(f, "%10.4f\n", values[N_SKEW_QUANTILES + 1]);
+        }
+    }
+}
+
+void print_rank_skew(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options)
+{
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+    {
+        print_rank_skew_to_file(stdout, skew_options);
+        if (skew_options->output_file != NULL) {
+            FILE* f = fopen(skew_options->output_file, "a");
+            print_rank_skew_to_file(f, skew_options);
             fflush(f);
             fclose(f);
         }
+
+        for (int method = 0; method < SKEW_N_METHODS; method++)
+        {
+            free(rank_skew[method]);
+            rank_skew[method] = NULL;
+        }
     }
 }
 
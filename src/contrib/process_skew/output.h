@@ -14,9 +14,21 @@
 #define SKEW_OUTPUT_H
 
 void print_command_line(int argc, char** argv);
-void print_settings(const skew_options_t* skew_options, const reprompib_dictionary_t* params_dict, const reprompib_options_t* benchmark_options);
+void print_settings(const skew_options_t* skew_options, const reprompib_dictionary_t* params_dict,
+        const reprompib_options_t* benchmark_options, const reprompib_sync_options_t* reference_sync_options);
 void print_header(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options);
-void print_result(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, double* tstart_sec);
+
+/*
+ * prints the skew of the start times measured after synchronizing with the given method
+ * (local_errorcodes is NULL for barrier methods); collective on the global communicator
+ */
+void print_result(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options, int method,
+        const int* local_errorcodes, double* tstart_sec);
+
+/*
+ * prints the skew distribution of each process for all methods passed to print_result
+ */
+void print_rank_skew(const skew_options_t* skew_options, const reprompib_options_t* benchmark_options);
 void print_final(const skew_options_t* skew_options, const time_t start_time, const time_t end_time);
 
 #endif /* SKEW_OUTPUT_H */
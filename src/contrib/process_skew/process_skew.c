@@ -23,12 +23,15 @@
 #include "reprompi_bench/option_parser/parse_extra_key_value_options.h"
 #include "reprompi_bench/option_parser/parse_options.h"
 #include "reprompi_bench/sync/benchmark_barrier_sync/bbarrier_sync.h"
+#include "reprompi_bench/sync/hca_sync/hca_parse_options.h"
+#include "reprompi_bench/sync/hca_sync/hca_sync.h"
 #include "reprompi_bench/sync/joneskoenig_sync/jk_parse_options.h"
-#include "reprompi_bench/sync/mpibarrier_sync/barrier_sync.h"
+#include "reprompi_bench/sync/joneskoenig_sync/jk_sync.h"
+#include "reprompi_bench/sync/skampi_sync/sk_parse_options.h"
+#include "reprompi_bench/sync/skampi_sync/sk_sync.h"
 #include "reprompi_bench/sync/sync_info.h"
 #include "reprompi_bench/sync/synchronization.h"
 #include "reprompi_bench/sync/time_measurement.h"
-#include "reprompi_bench/sync/joneskoenig_sync/jk_sync.h"
 
 #include "contrib/intercommunication/intercommunication.h"
 
@@ -37,28 +40,56 @@
 
 static const int HASHTABLE_SIZE=100;
 
+// barrier used by the barrier methods (called twice with --double)
+static void (*barrier_func)(void) = NULL;
+static int use_double_barrier = 0;
 
-static inline void mpibarrier_start_single()
+static void mpi_barrier(void)
 {
     MPI_Barrier(icmb_global_communicator());
 }
 
-static inline void mpibarrier_start_double()
+static void barrier_start(void)
 {
-    MPI_Barrier(icmb_global_communicator());
-    MPI_Barrier(icmb_global_communicator());
+    barrier_func();
+    if (use_double_barrier)
+    {
+        barrier_func();
+    }
 }
 
-static inline void bbarrier_start_single()
+static void no_op_sync(void)
 {
-    dissemination_barrier();
 }
 
-static inline void bbarrier_start_double()
-{
-    dissemination_barrier();
-    dissemination_barrier();
-}
+// process synchronization of each method
+typedef struct {
+    void (*barrier)(void);                                          /* NULL for window methods */
+    void (*init_module)(const reprompib_sync_options_t, const long); /* NULL if not needed */
+    sync_clocks_t sync_clocks;                                      /* NULL if not needed */
+    init_sync_t init_sync;
+    start_sync_t start_sync;
+    stop_sync_t stop_sync;
+    cleanup_sync_t cleanup_module;                                  /* NULL if not needed */
+    sync_errorcodes_t get_errorcodes;                               /* NULL for barriers */
+} skew_method_t;
+
+static const skew_method_t skew_methods[] = {
+        [SKEW_METHOD_MPI_BARRIER] = { mpi_barrier, NULL, NULL, no_op_sync, barrier_start, no_op_sync, NULL, NULL },
+        [SKEW_METHOD_BBARRIER] = { dissemination_barrier, NULL, NULL, no_op_sync, barrier_start, no_op_sync, NULL, NULL },
+        [SKEW_METHOD_BBARRIER_TREE] = { binomial_tree_barrier, NULL, NULL, no_op_sync, barrier_start, no_op_sync, NULL, NULL },
+        [SKEW_METHOD_BBARRIER_TOURNAMENT] = { tournament_barrier, NULL, NULL, no_op_sync, barrier_start, no_op_sync, NULL, NULL },
+        [SKEW_METHOD_BBARRIER_BUTTERFLY] = { butterfly_barrier, NULL, NULL, no_op_sync, barrier_start, no_op_sync, NULL, NULL },
+        [SKEW_METHOD_BBARRIER_TWO_LEVEL] = { two_level_barrier, NULL, NULL, bbarrier_init_two_level, barrier_start,
+                no_op_sync, bbarrier_cleanup_two_level, NULL },
+        [SKEW_METHOD_SK] = { NULL, sk_init_synchronization_module, sk_sync_clocks, sk_init_synchronization,
+                sk_start_synchronization, sk_stop_synchronization, sk_cleanup_synchronization_module, sk_get_local_sync_errorcodes },
+        [SKEW_METHOD_JK] = { NULL, jk_init_synchronization_module, jk_sync_clocks, jk_init_synchronization,
+                jk_start_synchronization, jk_stop_synchronization, jk_cleanup_synchronization_module, jk_get_local_sync_errorcodes },
+        // the HCA window uses the reference clock model itself
+        [SKEW_METHOD_HCA] = { NULL, NULL, NULL, hca_init_synchronization,
+                hca_start_synchronization, hca_stop_synchronization, NULL, hca_get_local_sync_errorcodes }
+};
 
 int main(int argc, char* argv[])
 {
@@ -69,7 +100,7 @@ int main(int argc, char* argv[])
     icmb_parse_intercommunication_options(argc, argv);
 
     // initialize time measurement
-    init_timer();
+    init_timer(argc, argv);
     time_t start_time = time(NULL);
 
     // log command line arguments
@@ -78,6 +109,7 @@ int main(int argc, char* argv[])
     // parse process skew options
     skew_options_t skew_options;
     parse_process_skew_options(&skew_options, argc, argv);
+    use_double_barrier = skew_options.use_double_barrier;
 
     // parse extra parameters into the global dictionary
     reprompib_dictionary_t params_dict;
@@ -94,84 +126,72 @@ int main(int argc, char* argv[])
         benchmark_opts.n_rep = 1;
     }
 
-    // parse jones-koenig sync options
-    reprompib_sync_options_t sync_opts;
-    jk_parse_options(argc, argv, &sync_opts);
-
-    // optionally parse mpi barrier sync options
-    if (skew_options.use_mpi_barrier)
-    {
-        mpibarrier_parse_options(argc, argv, &sync_opts);
-    }
-
-    // optionally parse dissemination barrier options
-    {
-        bbarrier_parse_options(argc, argv, &sync_opts);
-    }
+    // parse the options of each window-based method
+    // (the HCA options also configure the reference clock)
+    reprompib_sync_options_t sync_opts[SKEW_N_METHODS];
+    sk_parse_options(argc, argv, &sync_opts[SKEW_METHOD_SK]);
+    jk_parse_options(argc, argv, &sync_opts[SKEW_METHOD_JK]);
+    hca_parse_options(argc, argv, &sync_opts[SKEW_METHOD_HCA]);
 
-    // initialize joneskoenig module
-    jk_init_synchronization_module(sync_opts, benchmark_opts.n_rep);
     double* tstart_sec = (double*) malloc(benchmark_opts.n_rep * sizeof(double));
 
     // log settings
-    print_settings(&skew_options, &params_dict, &benchmark_opts);
+    print_settings(&skew_options, &params_dict, &benchmark_opts, &sync_opts[SKEW_METHOD_HCA]);
     print_header(&skew_options, &benchmark_opts);
 
-    // select synchronization start function
-    start_sync_t sync_func;
-    if (skew_options.use_mpi_barrier)
+    for (int method = 0; method < SKEW_N_METHODS; method++)
     {
-        if (skew_options.use_double_barrier)
-        {
-            sync_func = mpibarrier_start_double;
-        }
-        else
+        const skew_method_t* m = &skew_methods[method];
+
+        if (!skew_options.use_method[method])
         {
-            sync_func = mpibarrier_start_single;
+            continue;
         }
-    }
-    else if (skew_options.use_dissemination_barrier) {
-        if (skew_options.use_double_barrier)
+
+        // the start times of all methods are compared on the HCA clocks
+        hca_init_synchronization_module(sync_opts[SKEW_METHOD_HCA], benchmark_opts.n_rep);
+        if (m->init_module != NULL)
         {
-            sync_func = bbarrier_start_double;
+            m->init_module(sync_opts[method], benchmark_opts.n_rep);
         }
-        else
+
+        // synchronize clocks
+        hca_synchronize_clocks();
+        if (m->sync_clocks != NULL)
         {
-            sync_func = bbarrier_start_single;
+            m->sync_clocks();
         }
-    }
-    else
-    {
-        sync_func = jk_start_synchronization;
-    }
+        barrier_func = m->barrier;
+        m->init_sync();
 
-    // synchronize clocks
-    jk_sync_clocks();
-    jk_init_synchronization();
+        // run benchmark
+        for (int i = 0; i < benchmark_opts.n_rep; ++i)
+        {
+            // synchronize processes
+            m->start_sync();
 
+            // we are only interested in the start time here,
+            // as that shows the process skew coming out of the barrier
+            tstart_sec[i] = hca_get_adjusted_time();
 
-    // run benchmark
-    for (int i = 0; i < benchmark_opts.n_rep; ++i)
-    {
-        // synchronize processes
-        sync_func();
+            m->stop_sync();
+        }
 
-        // we are only interested in the start time here,
-        // as that shows the process skew coming out of the barrier
-        tstart_sec[i] = get_time();
+        // print benchmark result
+        print_result(&skew_options, &benchmark_opts, method,
+                (m->get_errorcodes != NULL) ? m->get_errorcodes() : NULL, tstart_sec);
 
-        if (skew_options.use_window)
+        if (m->cleanup_module != NULL)
         {
-            jk_stop_synchronization();
+            m->cleanup_module();
         }
+        hca_cleanup_synchronization_module();
     }
 
-    // print benchmark result
-    print_result(&skew_options, &benchmark_opts, tstart_sec);
+    // per-rank skew distributions of all methods
+    print_rank_skew(&skew_options, &benchmark_opts);
 
-    // shutdown joneskoenig module
     free(tstart_sec);
-    jk_cleanup_synchronization_module();
 
     // shutdown time measurement
     time_t end_time = time(NULL);
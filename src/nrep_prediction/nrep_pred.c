@@ -34,19 +34,19 @@
 #include <gsl/gsl_statistics.h>
 #include <gsl/gsl_sort.h>
 
+#include "reprompi_bench/misc.h"
 #include "reprompi_bench/option_parser/parse_common_options.h"
 #include "reprompi_bench/option_parser/parse_extra_key_value_options.h"
 #include "reprompi_bench/sync/synchronization.h"
 #include "reprompi_bench/output_management/bench_info_output.h"
 #include "reprompi_bench/output_management/runtimes_computation.h"
 #include "collective_ops/collectives.h"
+#include "buf_manager/mem_allocation.h"
 #include "benchmark_job.h"
 #include "parse_nrep_pred_options.h"
 
 #include "contrib/intercommunication/intercommunication.h"
 
-#ifndef ENABLE_WINDOWSYNC
-
 static const int OUTPUT_ROOT_PROC = 0;
 static const int HASHTABLE_SIZE=100;
 
@@ -159,11 +159,9 @@ void nrep_pred_print_results_header(const char* filename) {
     }
   }
 }
-#endif
 
 int main(int argc, char* argv[]) {
 
-#ifndef ENABLE_WINDOWSYNC
   long i, jindex, current_index;
   double* tstart_sec;
   double* tend_sec;
@@ -203,11 +201,18 @@ int main(int argc, char* argv[]) {
   // parse arguments and set-up benchmarking jobs
   reprompib_parse_common_options(&opts, argc, argv);
 
+  // select the allocator for message buffers and keep them across jobs if requested
+  reprompi_set_buffer_alloc(opts.buffer_alloc);
+  reprompi_init_buffer_pool(opts.enable_buffer_pool);
+
   // parse extra parameters into the global dictionary
   reprompib_parse_extra_key_value_options(&params_dict, argc, argv);
 
   // initialize synchronization functions according to the configured synchronization method
-  initialize_sync_implementation(&sync_f);
+  initialize_sync_implementation(argc, argv, &sync_f);
+  if (sync_f.clocktype != REPROMPI_CLOCKS_LOCAL) {
+    reprompib_print_error_and_exit("Cannot use this NREP prediction module with window-based synchronization (use --sync=mpibarrier or --sync=bbarrier)");
+  }
 
   // start synchronization module
   sync_f.parse_sync_params(argc, argv, &sync_opts);
@@ -233,7 +238,7 @@ int main(int argc, char* argv[]) {
     job = jlist.jobs[jlist.job_indices[jindex]];
 
     if (jindex == 0) {
-      print_common_settings(&opts, sync_f.print_sync_info, &params_dict);
+      print_common_settings(&opts, &sync_f, &params_dict);
       nrep_pred_print_cli_args_to_file(opts.output_file, &pred_params);
       nrep_pred_print_results_header(opts.output_file);
     }
@@ -321,20 +326,16 @@ int main(int argc, char* argv[]) {
 
   sync_f.clean_sync_module();
   end_time = time(NULL);
-  print_final_info(&opts, start_time, end_time);
+  print_final_info(&opts, &sync_f, start_time, end_time);
 
   cleanup_job_list(jlist);
   reprompib_free_common_parameters(&opts);
+  reprompi_cleanup_buffer_pool();
 
   reprompib_cleanup_dictionary(&params_dict);
 
   /* shut down MPI */
   MPI_Finalize();
 
-#else
-  printf("ERROR: Cannot use this NREP prediction module with window-based synchronization. \n");
-  printf("Please disable the HCA, SKaMPI or JK synchronization compile flags and use either the MPI_Barrier (default) or the dissemination barrier (ENABLE_BENCHMARK_BARRIER flag) for process synchronization.\n");
-#endif
-
   return 0;
 }
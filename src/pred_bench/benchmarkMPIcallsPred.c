@@ -40,6 +40,7 @@
 #include "reprompi_bench/output_management/bench_info_output.h"
 #include "reprompi_bench/output_management/runtimes_computation.h"
 #include "collective_ops/collectives.h"
+#include "buf_manager/mem_allocation.h"
 #include "reprompi_bench/utils/keyvalue_store.h"
 #include "nrep_estimation.h"
 
@@ -98,8 +99,7 @@ void print_measurement_results_prediction(const job_t* job_p, const reprompib_co
 
 }
 
-void print_initial_settings_prediction_to_file(FILE* f, const nrep_pred_params_t* pred_params_p,
-    print_sync_info_t print_sync_info) {
+void print_initial_settings_prediction_to_file(FILE* f, const nrep_pred_params_t* pred_params_p) {
 
   if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
     int i;
@@ -118,19 +118,19 @@ void print_initial_settings_prediction_to_file(FILE* f, const nrep_pred_params_t
 
 void print_initial_settings_prediction(const reprompib_common_options_t* common_opts_p,
     const nrep_pred_params_t* pred_params_p, const reprompib_dictionary_t* dict,
-    print_sync_info_t print_sync_info) {
+    const reprompib_sync_functions_t* sync_f) {
   FILE* f;
   const char header[] = "test nrep count mean_runtime_sec median_runtime_sec pred_method pred_value";
 
 
-  print_common_settings(common_opts_p, print_sync_info, dict);
+  print_common_settings(common_opts_p, sync_f, dict);
 
-  print_initial_settings_prediction_to_file(stdout, pred_params_p, print_sync_info);
+  print_initial_settings_prediction_to_file(stdout, pred_params_p);
 
   if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
     if (common_opts_p->output_file != NULL) {
       f = fopen(common_opts_p->output_file, "a");
-      print_initial_settings_prediction_to_file(f, pred_params_p, print_sync_info);
+      print_initial_settings_prediction_to_file(f, pred_params_p);
       fprintf(f, "%s\n", header);
       fclose(f);
     } else {
@@ -140,12 +140,18 @@ void print_initial_settings_prediction(const reprompib_common_options_t* common_
 }
 
 void compute_runtimes(double* tstart_sec, double* tend_sec, long current_start_index, long current_nreps,
-    sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time, double* maxRuntimes_sec, long* updated_nreps) {
+    const reprompib_sync_functions_t* sync_f, double* maxRuntimes_sec, long* updated_nreps) {
 
-#ifdef ENABLE_WINDOWSYNC
   int* sync_errorcodes;
   int i;
 
+  if (sync_f->clocktype == REPROMPI_CLOCKS_LOCAL) {   // measurements with Barrier-based synchronization
+    compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, current_nreps, OUTPUT_ROOT_PROC,
+        maxRuntimes_sec);
+    *updated_nreps = current_nreps;
+    return;
+  }
+
   sync_errorcodes = NULL;
   if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
 
@@ -157,16 +163,9 @@ void compute_runtimes(double* tstart_sec, double* tend_sec, long current_start_i
 
   compute_runtimes_global_clocks(tstart_sec, tend_sec,
       current_start_index, current_nreps, OUTPUT_ROOT_PROC,
-      get_errorcodes, get_global_time,
+      sync_f->get_errorcodes, sync_f->get_normalized_times,
       maxRuntimes_sec, sync_errorcodes);
 
-#else
-  compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, current_nreps, OUTPUT_ROOT_PROC,
-      maxRuntimes_sec);
-#endif
-
-#if defined (ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-
   // remove measurements that resulted in an window error
   long nreps = 0;
 
@@ -187,11 +186,6 @@ void compute_runtimes(double* tstart_sec, double* tend_sec, long current_start_i
   }
 
   *updated_nreps = nreps;
-
-#else // measurements with Barrier-based synchronization
-  *updated_nreps = current_nreps;
-#endif
-
 }
 
 int main(int argc, char* argv[]) {
@@ -223,14 +217,14 @@ int main(int argc, char* argv[]) {
   icmb_parse_intercommunication_options(argc, argv);
 
   // initialize time measurement functions
-  init_timer();
+  init_timer(argc, argv);
   start_time = time(NULL);
 
   // initialize global dictionary
   reprompib_init_dictionary(&params_dict, HASHTABLE_SIZE);
 
   // initialize synchronization functions according to the configured synchronization method
-  initialize_sync_implementation(&sync_f);
+  initialize_sync_implementation(argc, argv, &sync_f);
 
   // parse arguments and set-up benchmarking jobs
   print_command_line_args(argc, argv);
@@ -241,6 +235,10 @@ int main(int argc, char* argv[]) {
   // parse common arguments (e.g., msizes list, MPI calls to benchmark, input file)
   reprompib_parse_common_options(&common_opt, argc, argv);
 
+  // select the allocator for message buffers and keep them across jobs if requested
+  reprompi_set_buffer_alloc(common_opt.buffer_alloc);
+  reprompi_init_buffer_pool(common_opt.enable_buffer_pool);
+
   // parse extra parameters into the global dictionary
   reprompib_parse_extra_key_value_options(&params_dict, argc, argv);
 
@@ -259,7 +257,7 @@ int main(int argc, char* argv[]) {
     sync_f.init_sync_module(sync_opts, pred_opts.n_rep_max);
 
     if (jindex == 0) {
-      print_initial_settings_prediction(&common_opt, &pred_opts, &params_dict, sync_f.print_sync_info);
+      print_initial_settings_prediction(&common_opt, &pred_opts, &params_dict, &sync_f);
     }
 
     tstart_sec = (double*) malloc(pred_opts.n_rep_max * sizeof(double));
@@ -297,8 +295,8 @@ int main(int argc, char* argv[]) {
       }
 
       batch_runtimes = maxRuntimes_sec + (runtimes_index - nrep);
-      compute_runtimes(tstart_sec, tend_sec, (current_index - nrep), nrep, sync_f.get_errorcodes,
-          sync_f.get_normalized_time, batch_runtimes, &updated_batch_nreps);
+      compute_runtimes(tstart_sec, tend_sec, (current_index - nrep), nrep, &sync_f,
+          batch_runtimes, &updated_batch_nreps);
 
       // set the number of correct measurements to take into account out-of-window measurement errors
       runtimes_index = (runtimes_index - nrep) + updated_batch_nreps;
@@ -341,16 +339,18 @@ int main(int argc, char* argv[]) {
     free(tstart_sec);
     free(tend_sec);
     free(maxRuntimes_sec);
+    reset_prediction_conditions();
 
     collective_calls[job.call_index].cleanup_data(&coll_params);
     sync_f.clean_sync_module();
   }
 
   end_time = time(NULL);
-  print_final_info(&common_opt, start_time, end_time);
+  print_final_info(&common_opt, &sync_f, start_time, end_time);
 
   cleanup_job_list(jlist);
   reprompib_free_common_parameters(&common_opt);
+  reprompi_cleanup_buffer_pool();
   reprompib_cleanup_dictionary(&params_dict);
 
   /* shut down MPI */
@@ -83,6 +83,10 @@ int check_prediction_conditions(nrep_pred_params_t prediction_params, pred_condi
 
 }
 
+void reset_prediction_conditions(void) {
+    reset_cov_median();
+}
+
 
 
 
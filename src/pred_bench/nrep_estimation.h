@@ -48,4 +48,7 @@ void set_prediction_conditions(long current_nreps, double* runtimes_sec,
         nrep_pred_params_t prediction_params, pred_conditions_t* conds);
 int check_prediction_conditions(nrep_pred_params_t prediction_params, pred_conditions_t conds);
 
+// releases the state the prediction methods keep between the rounds of a job
+void reset_prediction_conditions(void);
+
 #endif /* NREP_ESTIMATION_H_ */
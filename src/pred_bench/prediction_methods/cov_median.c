@@ -28,7 +28,6 @@
 #include <stdlib.h>
 #include <math.h>
 #include <gsl/gsl_statistics.h>
-#include <gsl/gsl_sort.h>
 #include "mpi.h"
 
 #include "prediction_data.h"
@@ -39,48 +38,156 @@
 
 static const int OUTPUT_ROOT_PROC = 0;
 
+/*
+ * The runtimes only grow between the prediction rounds of a job, so the
+ * samples are inserted once into two heaps (the lower half in a max-heap,
+ * the upper half in a min-heap) and the median of every prefix is kept.
+ * A round costs O(batch * log(nreps)) instead of sorting the prefix
+ * method_win times.
+ */
+typedef struct {
+    double* values;
+    long size;
+    long capacity;
+    int sign;       // 1 for a max-heap, -1 for a min-heap
+} median_heap_t;
+
+typedef struct {
+    const double* runtimes_sec;     // samples of the current job
+    long count;                     // number of samples inserted so far
+    median_heap_t lower;
+    median_heap_t upper;
+    double* prefix_medians;         // prefix_medians[k] is the median of the first k+1 samples
+    long medians_capacity;
+} median_state_t;
+
+static median_state_t state = { NULL, 0, { NULL, 0, 0, 1 }, { NULL, 0, 0, -1 }, NULL, 0 };
+
+
+static int heap_before(const median_heap_t* heap, double a, double b) {
+    return (heap->sign > 0) ? (a > b) : (a < b);
+}
+
+static void heap_push(median_heap_t* heap, double value) {
+    long i, parent;
+
+    if (heap->size == heap->capacity) {
+        heap->capacity = (heap->capacity > 0) ? 2 * heap->capacity : 64;
+        heap->values = (double*)realloc(heap->values, heap->capacity * sizeof(double));
+    }
+
+    i = heap->size++;
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (!heap_before(heap, value, heap->values[parent])) {
+            break;
+        }
+        heap->values[i] = heap->values[parent];
+        i = parent;
+    }
+    heap->values[i] = value;
+}
+
+static double heap_pop(median_heap_t* heap) {
+    double top = heap->values[0];
+    double last = heap->values[--heap->size];
+    long i = 0, child;
+
+    while ((child = 2 * i + 1) < heap->size) {
+        if (child + 1 < heap->size && heap_before(heap, heap->values[child + 1], heap->values[child])) {
+            child++;
+        }
+        if (!heap_before(heap, heap->values[child], last)) {
+            break;
+        }
+        heap->values[i] = heap->values[child];
+        i = child;
+    }
+    if (heap->size > 0) {
+        heap->values[i] = last;
+    }
+    return top;
+}
+
+// the lower heap holds ceil(n/2) samples, the upper heap floor(n/2)
+static void insert_sample(double value) {
+    if (state.lower.size == 0 || value <= state.lower.values[0]) {
+        heap_push(&state.lower, value);
+    } else {
+        heap_push(&state.upper, value);
+    }
+
+    if (state.lower.size > state.upper.size + 1) {
+        heap_push(&state.upper, heap_pop(&state.lower));
+    } else if (state.upper.size > state.lower.size) {
+        heap_push(&state.lower, heap_pop(&state.upper));
+    }
+}
+
+// same value as gsl_stats_quantile_from_sorted_data(..., 0.5)
+static double current_median(void) {
+    if (state.lower.size > state.upper.size) {
+        return state.lower.values[0];
+    }
+    return 0.5 * state.lower.values[0] + 0.5 * state.upper.values[0];
+}
+
+static void update_prefix_medians(long nreps, const double* runtimes_sec) {
+    // a different array or fewer samples than before: runtimes of a new job
+    if (runtimes_sec != state.runtimes_sec || nreps < state.count) {
+        reset_cov_median();
+        state.runtimes_sec = runtimes_sec;
+    }
+
+    if (nreps > state.medians_capacity) {
+        state.medians_capacity = (2 * state.medians_capacity > nreps) ? 2 * state.medians_capacity : nreps;
+        state.prefix_medians = (double*)realloc(state.prefix_medians, state.medians_capacity * sizeof(double));
+    }
+
+    for (; state.count < nreps; state.count++) {
+        insert_sample(runtimes_sec[state.count]);
+        state.prefix_medians[state.count] = current_median();
+    }
+}
+
+
+void reset_cov_median(void) {
+    free(state.lower.values);
+    free(state.upper.values);
+    free(state.prefix_medians);
+
+    state.runtimes_sec = NULL;
+    state.count = 0;
+    state.lower.values = NULL;
+    state.lower.size = state.lower.capacity = 0;
+    state.upper.values = NULL;
+    state.upper.size = state.upper.capacity = 0;
+    state.prefix_medians = NULL;
+    state.medians_capacity = 0;
+}
+
+
 double compute_cov_median(long nreps, double* runtimes_sec,
         pred_method_info_t prediction_info) {
-    int i,j;
+    int i;
     double* median_list = NULL;
     int nmedians;
-    long current_nreps;
-    double* tmp_runtimes;
     double cov_median = COEF_ERROR_VALUE;
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         double mean_of_medians = 0, sd;
-        //double q1,q3;
-        //long start_index, end_index;
-        double* runtimes;
 
         nmedians = prediction_info.method_win;
         if (nmedians > nreps) {
             return COEF_ERROR_VALUE;
         }
 
-        median_list = (double*)malloc(prediction_info.method_win * sizeof(double));
-        tmp_runtimes = (double*)malloc(nreps * sizeof(double));
+        update_prefix_medians(nreps, runtimes_sec);
 
+        // medians of the prefixes with nreps, nreps-1, ..., nreps-nmedians+1 samples
+        median_list = (double*)malloc(prediction_info.method_win * sizeof(double));
         for (i = 0; i < nmedians; i++) {
-            current_nreps = nreps - i;
-
-            for (j=0; j < current_nreps; j++) {
-                tmp_runtimes[j] = runtimes_sec[j];
-            }
-
-            runtimes = tmp_runtimes;
-            gsl_sort(tmp_runtimes, 1, current_nreps);
-            //if (current_nreps > OUTLIER_FILTER_MIN_MEAS) {
-            //            q1 =  gsl_stats_quantile_from_sorted_data (tmp_runtimes, 1, current_nreps, 0.25);
-            //            q3 =  gsl_stats_quantile_from_sorted_data (tmp_runtimes, 1, current_nreps, 0.75);
-
-            //            filter_outliers_from_sorted(tmp_runtimes, current_nreps, q1, q3, OUTLIER_FILTER_THRES, &start_index, &end_index);
-            //            runtimes = runtimes + start_index;
-            //            current_nreps =  end_index - start_index + 1;
-            //        }
-            //median_list[i] = gsl_stats_quantile_from_sorted_data (runtimes, 1, current_nreps, 0.5);
-            median_list[i] = gsl_stats_quantile_from_sorted_data (tmp_runtimes, 1, current_nreps, 0.5);
+            median_list[i] = state.prefix_medians[nreps - 1 - i];
         }
 
         mean_of_medians = gsl_stats_mean(median_list, 1, nmedians);
@@ -90,7 +197,6 @@ double compute_cov_median(long nreps, double* runtimes_sec,
         //printf("cov_median=%lf, nreps = %ld, thres=%lf (mean_of_medians=%.10f)\n", cov_median, nreps, prediction_info.method_thres, mean_of_medians);
 
 
-        free(tmp_runtimes);
         free(median_list);
     }
 
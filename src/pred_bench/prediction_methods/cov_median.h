@@ -30,4 +30,7 @@ double compute_cov_median(long current_nreps, double* maxRuntimes_sec,
         pred_method_info_t prediction_info);
 int check_cov_median(pred_method_info_t prediction_info, double value);
 
+// releases the prefix medians kept between the prediction rounds of a job
+void reset_cov_median(void);
+
 #endif /* MEDIAN_COV_H_ */
@@ -51,12 +51,12 @@ static int first_print_call = 1;
 
 static reprompib_dictionary_t params_dict;
 
-void print_initial_settings(long nrep, print_sync_info_t print_sync_info) {
+void print_initial_settings(long nrep, const reprompib_sync_functions_t* sync_f) {
   FILE* f = stdout;
 
   if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
     fprintf(f, "#@nrep=%ld\n", nrep);
-    print_common_settings_to_file(f, print_sync_info, &params_dict);
+    print_common_settings_to_file(f, sync_f, &params_dict);
   }
 }
 
@@ -69,15 +69,15 @@ void reprompib_print_bench_output(const reprompib_job_t* job_p,
   output_info.print_summary_methods = opts->print_summary_methods;
 
   if (first_print_call) {
-    print_initial_settings(opts->n_rep, sync_f->print_sync_info);
-    print_results_header(&output_info, job_p);
+    print_initial_settings(opts->n_rep, sync_f);
+    print_results_header(&output_info, job_p, sync_f);
     first_print_call = 0;
   }
 
   if (opts->print_summary_methods > 0) {
-    print_summary(stdout, &output_info, job_p, sync_f->get_errorcodes, sync_f->get_normalized_time);
+    print_summary(stdout, &output_info, job_p, sync_f);
   } else {
-    print_measurement_results(f, &output_info, job_p, sync_f->get_errorcodes, sync_f->get_normalized_time);
+    print_measurement_results(f, &output_info, job_p, sync_f);
   }
 
 }
@@ -87,7 +87,7 @@ void reprompib_initialize_benchmark(int argc, char* argv[], reprompib_sync_funct
   reprompib_sync_options_t sync_opts;
 
   // initialize time measurement functions
-  init_timer();
+  init_timer(argc, argv);
 
   //initialize dictionary
   reprompib_init_dictionary(&params_dict, HASHTABLE_SIZE);
@@ -102,7 +102,7 @@ void reprompib_initialize_benchmark(int argc, char* argv[], reprompib_sync_funct
   reprompib_parse_options(opts_p, argc, argv);
 
   // initialize synchronization functions according to the configured synchronization method
-  initialize_sync_implementation(sync_f_p);
+  initialize_sync_implementation(argc, argv, sync_f_p);
 
   sync_f_p->parse_sync_params(argc, argv, &sync_opts);
 
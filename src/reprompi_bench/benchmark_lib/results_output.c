@@ -41,7 +41,7 @@
 static const int OUTPUT_ROOT_PROC = 0;
 
 void print_results_header(const reprompib_lib_output_info_t* output_info_p,
-    const reprompib_job_t* job_p) {
+    const reprompib_job_t* job_p, const reprompib_sync_functions_t* sync_f) {
     FILE* f = stdout;
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
@@ -57,15 +57,12 @@ void print_results_header(const reprompib_lib_output_info_t* output_info_p,
         fprintf(f, "%20s %4s", "measure_type", "proc");
 
         if (output_info_p->verbose == 1 && output_info_p->print_summary_methods == 0) {
-#ifdef ENABLE_WINDOWSYNC
-            fprintf(f, " %12s", "errorcode");
-#endif
-
-#ifdef ENABLE_WINDOWSYNC
-            fprintf(f," %8s %16s %16s %16s %16s\n", "nrep", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
-#else
-            fprintf(f," %8s %16s %16s\n",  "nrep", "loc_tstart_sec", "loc_tend_sec");
-#endif
+            if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                fprintf(f, " %12s", "errorcode");
+                fprintf(f," %8s %16s %16s %16s %16s\n", "nrep", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
+            } else {
+                fprintf(f," %8s %16s %16s\n",  "nrep", "loc_tstart_sec", "loc_tend_sec");
+            }
         } else {
 
             // print summary
@@ -81,9 +78,9 @@ void print_results_header(const reprompib_lib_output_info_t* output_info_p,
               fprintf(f, "\n");
             }
             else {
-#ifdef ENABLE_WINDOWSYNC
-                fprintf(f, " %12s", "errorcode");
-#endif
+                if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                    fprintf(f, " %12s", "errorcode");
+                }
                 fprintf(f, " %8s %16s\n", "nrep", "runtime_sec");
             }
         }
@@ -132,7 +129,7 @@ void compute_runtimes_local_clocks_with_reduction(
 
 
 void print_runtimes(FILE* f, const reprompib_job_t* job_p,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time) {
+        const reprompib_sync_functions_t* sync_f) {
 
     double* maxRuntimes_sec;
     int i;
@@ -144,24 +141,19 @@ void print_runtimes(FILE* f, const reprompib_job_t* job_p,
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         maxRuntimes_sec = (double*) malloc(job_p->n_rep * sizeof(double));
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job_p->n_rep * sizeof(int));
-        for (i = 0; i < job_p->n_rep; i++) {
-            sync_errorcodes[i] = 0;
-        }
-#endif
+        sync_errorcodes = (int*) calloc(job_p->n_rep, sizeof(int));
     }
 
     current_start_index = 0;
 
-#ifdef ENABLE_WINDOWSYNC
-    compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
-            get_errorcodes, get_global_time,
-            maxRuntimes_sec, sync_errorcodes);
-#else
-    compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
-            maxRuntimes_sec, job_p->op);
-#endif
+    if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
+                sync_f->get_errorcodes, sync_f->get_normalized_times,
+                maxRuntimes_sec, sync_errorcodes);
+    } else {
+        compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
+                maxRuntimes_sec, job_p->op);
+    }
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         for (i = 0; i < job_p->n_rep; i++) {
@@ -174,19 +166,17 @@ void print_runtimes(FILE* f, const reprompib_job_t* job_p,
                 fprintf(f, "%10d ", job_p->user_ivars[j]);
             }
 
-#if defined(ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-            fprintf(f, "%20s %4s %12d %8d %16.10f\n", job_p->timername, "all",
-                    sync_errorcodes[i],i,
-                    maxRuntimes_sec[i]);
-#else   // measurements with Barrier-based synchronization
-            fprintf(f, "%20s %4s %8d %16.10f\n", job_p->timername, "all",
-                    i, maxRuntimes_sec[i]);
-#endif
+            if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {   // measurements with window-based synchronization
+                fprintf(f, "%20s %4s %12d %8d %16.10f\n", job_p->timername, "all",
+                        sync_errorcodes[i],i,
+                        maxRuntimes_sec[i]);
+            } else {   // measurements with Barrier-based synchronization
+                fprintf(f, "%20s %4s %8d %16.10f\n", job_p->timername, "all",
+                        i, maxRuntimes_sec[i]);
+            }
         }
 
-#ifdef ENABLE_WINDOWSYNC
         free(sync_errorcodes);
-#endif
 
         free(maxRuntimes_sec);
     }
@@ -196,7 +186,7 @@ void print_runtimes(FILE* f, const reprompib_job_t* job_p,
 
 void print_runtimes_allprocs(FILE* f, const reprompib_job_t* job_p,
     const double* global_start_sec, const double* global_end_sec,
-    int* errorcodes) {
+    int* errorcodes, const reprompib_sync_functions_t* sync_f) {
 
     double* maxRuntimes_sec;
     int i;
@@ -225,14 +215,14 @@ void print_runtimes_allprocs(FILE* f, const reprompib_job_t* job_p,
                     fprintf(f, "%10d ", job_p->user_ivars[j]);
                 }
 
-#if defined(ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-                fprintf(f, "%20s %4d %12d %8d %16.10f\n", job_p->timername,
-                        proc_id, errorcodes[proc_id * job_p->n_rep + i], i,
-                        maxRuntimes_sec[proc_id * job_p->n_rep + i]);
-#else   // measurements with Barrier-based synchronization
-                fprintf(f, "%20s %4d %8d %16.10f\n", job_p->timername,
-                        proc_id,i, maxRuntimes_sec[proc_id * job_p->n_rep + i]);
-#endif
+                if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {   // measurements with window-based synchronization
+                    fprintf(f, "%20s %4d %12d %8d %16.10f\n", job_p->timername,
+                            proc_id, errorcodes[proc_id * job_p->n_rep + i], i,
+                            maxRuntimes_sec[proc_id * job_p->n_rep + i]);
+                } else {   // measurements with Barrier-based synchronization
+                    fprintf(f, "%20s %4d %8d %16.10f\n", job_p->timername,
+                            proc_id,i, maxRuntimes_sec[proc_id * job_p->n_rep + i]);
+                }
             }
         }
 
@@ -244,8 +234,7 @@ void print_runtimes_allprocs(FILE* f, const reprompib_job_t* job_p,
 void print_measurement_results(FILE* f,
     const reprompib_lib_output_info_t* output_info_p,
     const reprompib_job_t* job_p,
-    const sync_errorcodes_t get_errorcodes,
-    const sync_normtime_t get_global_time) {
+    const reprompib_sync_functions_t* sync_f) {
 
     int i, proc_id;
     double* local_start_sec = NULL;
@@ -259,30 +248,22 @@ void print_measurement_results(FILE* f,
     int np = icmb_global_size();
 
     if (output_info_p->verbose == 0 && strcmp(job_p->timertype, "all") != 0) {
-        print_runtimes(f, job_p, get_errorcodes, get_global_time);
+        print_runtimes(f, job_p, sync_f);
 
     }
     else {
 
-#ifdef ENABLE_WINDOWSYNC
-        if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
-        {
-            errorcodes = (int*)malloc(job_p->n_rep * np * sizeof(int));
-            for (i = 0; i < job_p->n_rep * np; i++) {
-                errorcodes[i] = 0;
-            }
-        }
-
-#ifndef ENABLE_BARRIERSYNC	// gather measurement results
-        {
-            int* local_errorcodes = get_errorcodes();
+        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+            int* local_errorcodes = sync_f->get_errorcodes();
 
+            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+            {
+                errorcodes = (int*)calloc(job_p->n_rep * np, sizeof(int));
+            }
+            // gather measurement results
             MPI_Gather(local_errorcodes, job_p->n_rep, MPI_INT,
                     errorcodes, job_p->n_rep, MPI_INT, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
         }
-#endif
-
-#endif
 
         if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
             local_start_sec = (double*) malloc(
@@ -307,8 +288,8 @@ void print_measurement_results(FILE* f,
         tmp_local_end_sec = (double*) malloc(
             job_p->n_rep * np * sizeof(double));
         for (i = 0; i < job_p->n_rep; i++) {
-            tmp_local_start_sec[i] = get_global_time(job_p->tstart_sec[i]);
-            tmp_local_end_sec[i] = get_global_time(job_p->tend_sec[i]);
+            tmp_local_start_sec[i] = sync_f->get_normalized_time(job_p->tstart_sec[i]);
+            tmp_local_end_sec[i] = sync_f->get_normalized_time(job_p->tend_sec[i]);
         }
         MPI_Gather(tmp_local_start_sec, job_p->n_rep, MPI_DOUBLE,
             global_start_sec, job_p->n_rep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
@@ -321,7 +302,7 @@ void print_measurement_results(FILE* f,
 
         if (output_info_p->verbose == 0  && strcmp(job_p->timertype, "all") == 0) {
 
-            print_runtimes_allprocs(f, job_p, global_start_sec, global_end_sec, errorcodes);
+            print_runtimes_allprocs(f, job_p, global_start_sec, global_end_sec, errorcodes, sync_f);
         }
 
         else {      // verbose == 1
@@ -337,21 +318,20 @@ void print_measurement_results(FILE* f,
                             fprintf(f, "%10d ", job_p->user_ivars[j]);
                         }
 
-#ifdef ENABLE_WINDOWSYNC
-                        fprintf(f, "%20s %4d %12d %8d %16.10f %16.10f %16.10f %16.10f\n",
-                            job_p->timername, proc_id,
-                                errorcodes[proc_id * job_p->n_rep + i], i,
-                                local_start_sec[proc_id * job_p->n_rep + i],
-                                local_end_sec[proc_id * job_p->n_rep + i],
-                                global_start_sec[proc_id * job_p->n_rep + i],
-                                global_end_sec[proc_id * job_p->n_rep + i]);
-
-#else
-                        fprintf(f, "%20s %4d %8d %16.10f %16.10f\n", job_p->timername,
-                                proc_id, i,
-                                local_start_sec[proc_id * job_p->n_rep + i],
-                                local_end_sec[proc_id * job_p->n_rep + i]);
-#endif
+                        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                            fprintf(f, "%20s %4d %12d %8d %16.10f %16.10f %16.10f %16.10f\n",
+                                job_p->timername, proc_id,
+                                    errorcodes[proc_id * job_p->n_rep + i], i,
+                                    local_start_sec[proc_id * job_p->n_rep + i],
+                                    local_end_sec[proc_id * job_p->n_rep + i],
+                                    global_start_sec[proc_id * job_p->n_rep + i],
+                                    global_end_sec[proc_id * job_p->n_rep + i]);
+                        } else {
+                            fprintf(f, "%20s %4d %8d %16.10f %16.10f\n", job_p->timername,
+                                    proc_id, i,
+                                    local_start_sec[proc_id * job_p->n_rep + i],
+                                    local_end_sec[proc_id * job_p->n_rep + i]);
+                        }
                     }
                 }
             }
@@ -362,10 +342,7 @@ void print_measurement_results(FILE* f,
             free(local_end_sec);
             free(global_start_sec);
             free(global_end_sec);
-#ifdef ENABLE_WINDOWSYNC
             free(errorcodes);
-#endif
-
         }
 
     }
@@ -376,8 +353,7 @@ void print_measurement_results(FILE* f,
 void print_summary(FILE* f,
         const reprompib_lib_output_info_t* output_info_p,
         const reprompib_job_t* job_p,
-        const sync_errorcodes_t get_errorcodes,
-        const sync_normtime_t get_global_time) {
+        const reprompib_sync_functions_t* sync_f) {
 
     double* maxRuntimes_sec;
     int i, j;
@@ -392,27 +368,22 @@ void print_summary(FILE* f,
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         maxRuntimes_sec = (double*) malloc(job_p->n_rep * np * sizeof(double));
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job_p->n_rep * np * sizeof(int));
-        for (i = 0; i < job_p->n_rep * np; i++) {
-            sync_errorcodes[i] = 0;
-        }
-#endif
+        sync_errorcodes = (int*) calloc(job_p->n_rep * np, sizeof(int));
     }
 
     current_start_index = 0;
 
     if (strcmp(job_p->timertype, "all") !=0) { // one runtime for each nrep id (reduced over processes)
 
-#ifdef ENABLE_WINDOWSYNC
-        compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec,
-                current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
-                get_errorcodes, get_global_time,
-                maxRuntimes_sec, sync_errorcodes);
-#else
-        compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
-                maxRuntimes_sec, job_p->op);
-#endif
+        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+            compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec,
+                    current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
+                    sync_f->get_errorcodes, sync_f->get_normalized_times,
+                    maxRuntimes_sec, sync_errorcodes);
+        } else {
+            compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
+                    maxRuntimes_sec, job_p->op);
+        }
         n_results = 1;
 
     }
@@ -424,17 +395,12 @@ void print_summary(FILE* f,
         double* tmp_local_start_sec = NULL;
         double* tmp_local_end_sec = NULL;
 
-#ifdef ENABLE_WINDOWSYNC
-#ifndef ENABLE_BARRIERSYNC  // gather measurement results
-        {
-            int* local_errorcodes = get_errorcodes();
+        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {  // gather measurement results
+            int* local_errorcodes = sync_f->get_errorcodes();
 
             MPI_Gather(local_errorcodes, job_p->n_rep, MPI_INT,
                     sync_errorcodes, job_p->n_rep, MPI_INT, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
         }
-#endif
-
-#endif
 
         if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
             local_start_sec = (double*) malloc(
@@ -459,8 +425,8 @@ void print_summary(FILE* f,
         tmp_local_end_sec = (double*) malloc(
             job_p->n_rep * np * sizeof(double));
         for (i = 0; i < job_p->n_rep; i++) {
-            tmp_local_start_sec[i] = get_global_time(job_p->tstart_sec[i]);
-            tmp_local_end_sec[i] = get_global_time(job_p->tend_sec[i]);
+            tmp_local_start_sec[i] = sync_f->get_normalized_time(job_p->tstart_sec[i]);
+            tmp_local_end_sec[i] = sync_f->get_normalized_time(job_p->tend_sec[i]);
         }
         MPI_Gather(tmp_local_start_sec, job_p->n_rep, MPI_DOUBLE, global_start_sec,
             job_p->n_rep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
@@ -506,7 +472,6 @@ void print_summary(FILE* f,
             current_error_codes = sync_errorcodes + (proc * job_p->n_rep);
 
             // remove measurements with out-of-window errors
-#ifdef ENABLE_WINDOWSYNC
             for (i = 0; i < job_p->n_rep; i++) {
                 if (current_error_codes[i] == 0) {
                     if (nreps < i) {
@@ -515,9 +480,6 @@ void print_summary(FILE* f,
                     nreps++;
                 }
             }
-#else
-            nreps = job_p->n_rep;
-#endif
 
             gsl_sort(current_proc_runtimes, 1, nreps);
 
@@ -566,10 +528,7 @@ void print_summary(FILE* f,
             fprintf(f, "\n");
         }
 
-
-#ifdef ENABLE_WINDOWSYNC
         free(sync_errorcodes);
-#endif
 
         free(maxRuntimes_sec);
     }
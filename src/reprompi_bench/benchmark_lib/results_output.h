@@ -34,20 +34,19 @@ typedef struct {
 } reprompib_lib_output_info_t;
 
 
-void print_results_header(const reprompib_lib_output_info_t* output_info_p, const reprompib_job_t* job_p);
+void print_results_header(const reprompib_lib_output_info_t* output_info_p, const reprompib_job_t* job_p,
+    const reprompib_sync_functions_t* sync_f);
 
 void print_measurement_results(FILE* f,
     const reprompib_lib_output_info_t* output_info_p,
     const reprompib_job_t* job_p,
-		const sync_errorcodes_t get_errorcodes,
-		const sync_normtime_t get_global_time
+    const reprompib_sync_functions_t* sync_f
 		);
 
 void print_summary(FILE* f,
     const reprompib_lib_output_info_t* output_info_p,
     const reprompib_job_t* job_p,
-    const sync_errorcodes_t get_errorcodes,
-    const sync_normtime_t get_global_time
+    const reprompib_sync_functions_t* sync_f
     );
 
 #endif /* REPROMPIB_RESULTS_OUTPUT_H_ */
@@ -42,6 +42,12 @@ void reprompib_print_common_help(void) {
                 "input file containing the list of benchmarking jobs");
         printf("%-40s %-40s\n", "--output-file=<path>",
                         "results file");
+        printf("%-40s %-40s\n %50s%s\n", "--output-format=<format>",
+                "format of the results file: text (default) or binary,", "",
+                "convert binary files with reprompi_convert");
+        printf("%-40s %-40s\n %50s%s\n", "--output-mpiio",
+                "with -v, each process writes its measurements into the results file", "",
+                "with collective MPI-IO instead of gathering them at the root");
         printf("%-40s %-40s\n %50s%s\n", "--msizes-list=<values>",
                 "list of comma-separated message sizes in Bytes,", "",
                 "e.g., --msizes-list=10,1024");
@@ -67,6 +73,14 @@ void reprompib_print_common_help(void) {
 
         printf("%-40s %-40s\n", "--shuffle-jobs",
                 "shuffle experiments before running the benchmark");
+        printf("%-40s %-40s\n", "--buffer-pool",
+                "keep pre-faulted message buffers allocated across jobs");
+        printf("%-40s %-40s\n %50s%s\n", "--buffer-alloc=<alloc>",
+                "allocator for the (pre-faulted) message buffers,", "",
+                "one of calloc, aligned, hugepage, mpi_alloc_mem, numa_local");
+        printf("%-40s %-40s\n %50s%s\n", "--timer=<timer>",
+                "timer used for time measurements (default: selected at compile time),", "",
+                "one of mpi_wtime, monotonic, monotonic_raw, monotonic_vdso, rdtsc, rdtscp, cntvct, cntpct");
         printf("%-40s %-40s\n", "--params=<k1>:<v1>,<k2>:<v2>",
                 "list of comma-separated <key>:<value> pairs to be printed in the benchmark output");
         printf("\n");
@@ -79,17 +93,45 @@ void reprompib_print_common_help(void) {
                 "", "MPI_Scatter, MPI_Reduce, MPI_Allreduce, MPI_Barrier, Send_Recv,",
                 "", "Isend_Recv, Isend_Irecv, Sendrecv\n");
 
+        printf("\nSynchronization options:\n");
+        printf("%-40s %-40s\n %50s%s\n", "--sync=<method>",
+                "process synchronization method (default: selected at compile time),", "",
+                "one of mpibarrier, bbarrier, sk, jk, hca, hca-global, roundtime");
+        printf("%-40s %-40s\n %50s%s\n %50s%s\n", "--bbarrier-alg=<alg>",
+                "barrier algorithm of the bbarrier synchronization (default: dissemination),", "",
+                "one of dissemination, tree, tournament, butterfly, two-level", "",
+                "(with hca-global: use this barrier instead of MPI_Barrier)");
+
         printf("\nWindow-based synchronization options:\n");
         printf("%-40s %-40s\n", "--window-size=<win>",
                 "window size in microseconds for window-based synchronization (default: 1 ms)");
         printf("%-40s %-40s\n", "--wait-time=<wait>",
                 "wait time in microseconds before the start of the first window (default: 1 ms)");
 
+        printf("%-40s %-40s\n %50s%s\n", "--auto-window=<nrep>",
+                "adapt the window size every <nrep> repetitions, starting from --window-size,", "",
+                "to the observed runtimes and the synchronization error (default: 0, fixed window)");
+        printf("%-40s %-40s\n %50s%s\n", "--node-leader-sync",
+                "learn the clock models between one leader process per node only", "",
+                "and share them with the other processes of the node (sk, jk, hca)");
+        printf("%-40s %-40s\n %50s%s\n", "--sk-offsets=<scheme>",
+                "measure the SKaMPI clock offsets one process after the other (linear, default)", "",
+                "or concurrently along a binomial tree (tree)");
+
         printf("\nSpecific options for the linear model of the clock skew:\n");
         printf("%-40s %-40s\n", "--fitpoints=<nfit>",
                 "number of fitpoints (default: 20)");
         printf("%-40s %-40s\n", "--exchanges=<nexc>",
-                "number of exchanges (default: 10)\n");
+                "number of exchanges (default: 10)");
+        printf("%-40s %-40s\n %50s%s\n", "--jk-models=<scheme>",
+                "learn the JK clock models against the root (linear, default)", "",
+                "or along a binomial tree, merging the models (tree)");
+        printf("%-40s %-40s\n %50s%s\n", "--clock-tracking=<nrep>",
+                "update the JK/HCA clock models online with timestamp exchanges between windows,", "",
+                "one process every <nrep> repetitions (default: 0, no tracking)");
+        printf("%-40s %-40s\n %50s%s\n\n", "--hca-drift-bound=<bound>",
+                "keep the HCA clock model across jobs and re-learn it only if the residual offset", "",
+                "exceeds <bound> microseconds (default: 0, re-learn for every job)");
 
         // display help for intercommunication options
         icmb_print_intercommunication_help();
@@ -37,7 +37,9 @@
 #include <errno.h>
 #include <mpi.h>
 #include "collective_ops/collectives.h"
+#include "buf_manager/mem_allocation.h"
 #include "reprompi_bench/misc.h"
+#include "reprompi_bench/output_management/binary_output.h"
 #include "parse_common_options.h"
 
 #include "contrib/intercommunication/intercommunication.h"
@@ -70,7 +72,11 @@ enum {
   REPROMPI_ARGS_OPERATION,
   REPROMPI_ARGS_DATATYPE,
   REPROMPI_ARGS_PINGPONG_RANKS,
-  REPROMPI_ARGS_SHUFFLE_JOBS
+  REPROMPI_ARGS_SHUFFLE_JOBS,
+  REPROMPI_ARGS_BUFFER_POOL,
+  REPROMPI_ARGS_BUFFER_ALLOC,
+  REPROMPI_ARGS_OUTPUT_FORMAT,
+  REPROMPI_ARGS_OUTPUT_MPIIO
 };
 
 
@@ -85,6 +91,10 @@ static const struct option reprompi_common_long_options[] = {
         {"datatype", required_argument, 0, REPROMPI_ARGS_DATATYPE},
         {"pingpong-ranks", required_argument, 0, REPROMPI_ARGS_PINGPONG_RANKS},
         {"shuffle-jobs", no_argument, 0, REPROMPI_ARGS_SHUFFLE_JOBS},
+        {"buffer-pool", no_argument, 0, REPROMPI_ARGS_BUFFER_POOL},
+        {"buffer-alloc", required_argument, 0, REPROMPI_ARGS_BUFFER_ALLOC},
+        {"output-format", required_argument, 0, REPROMPI_ARGS_OUTPUT_FORMAT},
+        {"output-mpiio", no_argument, 0, REPROMPI_ARGS_OUTPUT_MPIIO},
         { 0, 0, 0, 0 }
 };
 static const char reprompi_common_opts_str[] = "";
@@ -95,12 +105,16 @@ static void init_parameters(reprompib_common_options_t* opts_p) {
     opts_p->n_calls = 0;
     opts_p->root_proc = 0;
     opts_p->enable_job_shuffling = 0;
+    opts_p->enable_buffer_pool = 0;
+    opts_p->buffer_alloc = reprompi_get_buffer_alloc();  // compile-time default
 
     opts_p->msize_list = NULL;
     opts_p->list_mpi_calls = NULL;
 
     opts_p->input_file = NULL;
     opts_p->output_file = NULL;
+    opts_p->output_format = REPROMPI_OUTPUT_TEXT;
+    opts_p->enable_output_mpiio = 0;
     opts_p->operation = MPI_BOR;
     opts_p->datatype = MPI_BYTE;
 
@@ -253,6 +267,28 @@ static void parse_call_list(char* subopts, reprompib_common_options_t* opts_p) {
 
 }
 
+static void parse_buffer_alloc(char* subopts, reprompib_common_options_t* opts_p) {
+    char * value;
+    int index;
+
+    index = getsubopt(&subopts, get_buffer_alloc_list(), &value);
+    if (index < 0 || index >= REPROMPI_N_BUFFER_ALLOC) {
+        reprompib_print_error_and_exit("Unknown buffer allocator (--buffer-alloc=<calloc|aligned|hugepage|mpi_alloc_mem|numa_local>)");
+    }
+    opts_p->buffer_alloc = index;
+}
+
+static void parse_output_format(char* subopts, reprompib_common_options_t* opts_p) {
+    char * value;
+    int index;
+
+    index = getsubopt(&subopts, get_output_format_list(), &value);
+    if (index < 0 || index >= REPROMPI_N_OUTPUT_FORMATS) {
+        reprompib_print_error_and_exit("Unknown output format (--output-format=<text|binary>)");
+    }
+    opts_p->output_format = index;
+}
+
 static void parse_operation(char* arg, reprompib_common_options_t* opts_p) {
     if (arg != NULL && strlen(arg) > 0) {
         if (strcmp("MPI_BOR", arg) == 0) {
@@ -422,10 +458,22 @@ void reprompib_parse_common_options(reprompib_common_options_t* opts_p, int argc
         case REPROMPI_ARGS_SHUFFLE_JOBS: /* enable job shuffling */
             opts_p->enable_job_shuffling = 1;
             break;
+        case REPROMPI_ARGS_BUFFER_POOL: /* reuse message buffers across jobs */
+            opts_p->enable_buffer_pool = 1;
+            break;
+        case REPROMPI_ARGS_BUFFER_ALLOC: /* allocator backend for message buffers */
+            parse_buffer_alloc(optarg, opts_p);
+            break;
         case REPROMPI_ARGS_OUTPUT_FILE: /* path to an output file */
             opts_p->output_file = (char*)malloc((strlen(optarg)+1) * sizeof(char));
             strcpy(opts_p->output_file, optarg);
             break;
+        case REPROMPI_ARGS_OUTPUT_FORMAT: /* format of the results in the output file */
+            parse_output_format(optarg, opts_p);
+            break;
+        case REPROMPI_ARGS_OUTPUT_MPIIO: /* each process writes its results with MPI-IO */
+            opts_p->enable_output_mpiio = 1;
+            break;
         case REPROMPI_ARGS_PINGPONG_RANKS: /* set the ranks between which to run the ping-pong operations*/
             parse_pingpong_ranks(optarg, opts_p);
             break;
@@ -448,6 +496,13 @@ void reprompib_parse_common_options(reprompib_common_options_t* opts_p, int argc
       }
     }
 
+    if (opts_p->output_format == REPROMPI_OUTPUT_BINARY && opts_p->output_file == NULL) {
+      reprompib_print_error_and_exit("Binary results require an output file (--output-file=<path>)");
+    }
+    if (opts_p->enable_output_mpiio && opts_p->output_file == NULL) {
+      reprompib_print_error_and_exit("MPI-IO output requires an output file (--output-file=<path>)");
+    }
+
     if (opts_p->output_file != NULL) {
         long output_file_error = 0;
         if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
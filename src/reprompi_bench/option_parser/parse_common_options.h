@@ -32,6 +32,8 @@ typedef struct reprompib_common_opt {
     size_t* msize_list; /* --msizes-list / --msize-interval */
 
     int enable_job_shuffling;
+    int enable_buffer_pool; /* --buffer-pool */
+    int buffer_alloc; /* --buffer-alloc */
 
     MPI_Datatype datatype;
     MPI_Op operation;
@@ -39,6 +41,8 @@ typedef struct reprompib_common_opt {
 
     char* input_file;
     char* output_file;
+    int output_format; /* --output-format */
+    int enable_output_mpiio; /* --output-mpiio */
 
     // parameters relevant for ping-pong operations
     int pingpong_ranks[2];
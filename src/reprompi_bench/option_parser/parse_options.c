@@ -45,39 +45,82 @@ enum reprompi_summary_opts {
     MASK_PRINT_MEAN = 0x01,
     MASK_PRINT_MEDIAN = 0x02,
     MASK_PRINT_MIN = 0x04,
-    MASK_PRINT_MAX = 0x08
+    MASK_PRINT_MAX = 0x08,
+    MASK_PRINT_P90 = 0x10,
+    MASK_PRINT_P99 = 0x20,
+    MASK_PRINT_P999 = 0x40,
+    MASK_PRINT_TRIMMED_MEAN = 0x80,
+    MASK_PRINT_MAD = 0x100,
+    MASK_PRINT_IQR = 0x200,
+    MASK_PRINT_MEDIAN_CI_LO = 0x400,
+    MASK_PRINT_MEDIAN_CI_HI = 0x800
+};
+static const int N_SUMMARY_METHODS = 12;
+
+// methods printed by --summary without a list
+static const int DEFAULT_SUMMARY_METHODS = MASK_PRINT_MEAN | MASK_PRINT_MEDIAN | MASK_PRINT_MIN | MASK_PRINT_MAX;
+// methods that can be computed from the streaming statistics (--streaming-summary)
+static const int STREAMING_SUMMARY_METHODS = MASK_PRINT_MEAN | MASK_PRINT_MEDIAN | MASK_PRINT_MIN | MASK_PRINT_MAX
+        | MASK_PRINT_P90 | MASK_PRINT_P99 | MASK_PRINT_P999 | MASK_PRINT_IQR;
+
+static char* const histogram_scope_opts[] = {
+        [REPROMPI_HISTOGRAM_NONE] = "none",
+        [REPROMPI_HISTOGRAM_GLOBAL] = "global",
+        [REPROMPI_HISTOGRAM_NODE] = "node",
+        NULL
 };
-static const int N_SUMMARY_METHODS = 4;
 
-static char* const summary_opts[] = { "mean", "median", "min", "max", NULL};
+static char* const summary_opts[] = { "mean", "median", "min", "max", "p90", "p99", "p99.9",
+        "trimmed_mean", "mad", "iqr", "median_ci_lo", "median_ci_hi", NULL};
 static summary_method_info_t summary_methods[] = {
     { MASK_PRINT_MEAN, "mean" },
     { MASK_PRINT_MEDIAN, "median" },
     { MASK_PRINT_MIN, "min" },
-    { MASK_PRINT_MAX, "max" }
+    { MASK_PRINT_MAX, "max" },
+    { MASK_PRINT_P90, "p90" },
+    { MASK_PRINT_P99, "p99" },
+    { MASK_PRINT_P999, "p99.9" },
+    { MASK_PRINT_TRIMMED_MEAN, "trimmed_mean" },
+    { MASK_PRINT_MAD, "mad" },
+    { MASK_PRINT_IQR, "iqr" },
+    { MASK_PRINT_MEDIAN_CI_LO, "median_ci_lo" },
+    { MASK_PRINT_MEDIAN_CI_HI, "median_ci_hi" }
 };
 
 
 enum reprompi_common_getopt_ids {
   REPROMPI_ARGS_VERBOSE = 'v',
   REPROMPI_ARGS_NREPS = 500,
-  REPROMPI_ARGS_SUMMARY
+  REPROMPI_ARGS_SUMMARY,
+  REPROMPI_ARGS_NREP_VALID,
+  REPROMPI_ARGS_PIPELINED_OUTPUT,
+  REPROMPI_ARGS_STREAMING_SUMMARY,
+  REPROMPI_ARGS_STRAGGLERS,
+  REPROMPI_ARGS_HISTOGRAM
 };
 
 static const struct option reprompi_default_long_options[] = {
         {"verbose", no_argument, 0, REPROMPI_ARGS_VERBOSE},
         { "nrep", required_argument, 0, REPROMPI_ARGS_NREPS },
         {"summary", optional_argument, 0, REPROMPI_ARGS_SUMMARY},
+        {"nrep-valid", optional_argument, 0, REPROMPI_ARGS_NREP_VALID},
+        {"pipelined-output", no_argument, 0, REPROMPI_ARGS_PIPELINED_OUTPUT},
+        {"streaming-summary", no_argument, 0, REPROMPI_ARGS_STREAMING_SUMMARY},
+        {"stragglers", no_argument, 0, REPROMPI_ARGS_STRAGGLERS},
+        {"histogram", optional_argument, 0, REPROMPI_ARGS_HISTOGRAM},
 
         { 0, 0, 0, 0 }
 };
 static const char reprompi_default_opts_str[] = "v";
 
+// default cap on the executed repetitions with --nrep-valid (as a multiple of --nrep)
+static const double DEFAULT_NREP_VALID_FACTOR = 2.0;
+
 
 
 summary_method_info_t* reprompib_get_summary_method(int index) {
    if (index <0 || index >= N_SUMMARY_METHODS) {
-     reprompib_print_error_and_exit("Incorrect index for the summary methods (it has to be an integer between 0 and 3)");
+     reprompib_print_error_and_exit("Incorrect index for the summary methods (it has to be an integer between 0 and 11)");
    }
 
    return &(summary_methods[index]);
@@ -92,6 +135,11 @@ static void init_parameters(reprompib_options_t* opts_p) {
     opts_p->verbose = 0;
     opts_p->n_rep = 0;
     opts_p->print_summary_methods = 0;
+    opts_p->nrep_valid_factor = 0;
+    opts_p->enable_pipelined_output = 0;
+    opts_p->enable_streaming_summary = 0;
+    opts_p->enable_stragglers = 0;
+    opts_p->histogram_scope = REPROMPI_HISTOGRAM_NONE;
 }
 
 void reprompib_free_parameters(reprompib_options_t* opts_p) {
@@ -110,14 +158,26 @@ static void parse_summary_list(char* subopts, reprompib_options_t* opts_p) {
                 opts_p->print_summary_methods |= reprompib_get_summary_method(index)->mask;
             }
             else {
-              reprompib_print_error_and_exit("Invalid list of summary methods (--summary=<list of comma-separated methods> [min, max, mean, median])");
+              reprompib_print_error_and_exit("Invalid list of summary methods (--summary=<list of comma-separated methods> [min, max, mean, median, p90, p99, p99.9, trimmed_mean, mad, iqr, median_ci_lo, median_ci_hi])");
             }
         }
     }
-    if (opts_p->print_summary_methods == 0) {  // no method specified - use all of them
-        for (index=0; index < reprompib_get_number_summary_methods(); index++) {
-          opts_p->print_summary_methods |= reprompib_get_summary_method(index)->mask;
+    if (opts_p->print_summary_methods == 0) {  // no method specified - use the default ones
+        opts_p->print_summary_methods = DEFAULT_SUMMARY_METHODS;
+    }
+}
+
+static void parse_histogram_scope(char* subopts, reprompib_options_t* opts_p) {
+    char * value;
+    int index;
+
+    opts_p->histogram_scope = REPROMPI_HISTOGRAM_GLOBAL;
+    if (subopts != NULL) {
+        index = getsubopt(&subopts, histogram_scope_opts, &value);
+        if (index < 0) {
+            reprompib_print_error_and_exit("Unknown histogram scope (--histogram=<global|node>)");
         }
+        opts_p->histogram_scope = index;
     }
 }
 
@@ -155,6 +215,32 @@ void reprompib_parse_options(reprompib_options_t* opts_p, int argc, char** argv)
             break;
 
 
+        case REPROMPI_ARGS_NREP_VALID: /* repeat until nrep valid measurements */
+            opts_p->nrep_valid_factor = DEFAULT_NREP_VALID_FACTOR;
+            if (optarg != NULL) {
+                opts_p->nrep_valid_factor = atof(optarg);
+            }
+            if (opts_p->nrep_valid_factor < 1) {
+              reprompib_print_error_and_exit("The --nrep-valid factor has to be at least 1");
+            }
+            break;
+
+        case REPROMPI_ARGS_PIPELINED_OUTPUT: /* overlap the output of a job with the next job */
+            opts_p->enable_pipelined_output = 1;
+            break;
+
+        case REPROMPI_ARGS_STREAMING_SUMMARY: /* summary without keeping all runtimes on the root */
+            opts_p->enable_streaming_summary = 1;
+            break;
+
+        case REPROMPI_ARGS_STRAGGLERS: /* report the ranks that determined the runtimes */
+            opts_p->enable_stragglers = 1;
+            break;
+
+        case REPROMPI_ARGS_HISTOGRAM: /* latency histogram of all processes or of each node */
+            parse_histogram_scope(optarg, opts_p);
+            break;
+
         case REPROMPI_ARGS_VERBOSE: /* verbose flag */
             opts_p->verbose = 1;
             break;
@@ -163,6 +249,19 @@ void reprompib_parse_options(reprompib_options_t* opts_p, int argc, char** argv)
         }
     }
 
+    if (opts_p->enable_pipelined_output && opts_p->verbose) {
+      reprompib_print_error_and_exit("Pipelined output is not supported in verbose mode (-v)");
+    }
+    if (opts_p->enable_pipelined_output && opts_p->enable_stragglers) {
+      reprompib_print_error_and_exit("Pipelined output is not supported with --stragglers");
+    }
+    if (opts_p->enable_pipelined_output && opts_p->histogram_scope != REPROMPI_HISTOGRAM_NONE) {
+      reprompib_print_error_and_exit("Pipelined output is not supported with --histogram");
+    }
+    if (opts_p->enable_streaming_summary && (opts_p->print_summary_methods & ~STREAMING_SUMMARY_METHODS)) {
+      reprompib_print_error_and_exit("The trimmed_mean, mad and median_ci_* summary methods are not supported with --streaming-summary");
+    }
+
 
 //    if (opts_p->n_rep < 0) {
 //      reprompib_print_error_and_exit("Nreps value is negative or not correctly specified");
@@ -187,8 +286,23 @@ void reprompib_print_benchmark_help(void) {
         printf("%-40s %-40s\n", "--nrep=<nrep>",
                 "set number of experiment repetitions");
         printf("%-40s %-40s\n %50s%s\n", "--summary=<args>",
-                "list of comma-separated data summarizing methods (mean, median, min, max)", "",
-                "e.g., --summary=mean,max");
+                "list of comma-separated data summarizing methods (mean, median, min, max, p90, p99, p99.9,", "",
+                "trimmed_mean, mad, iqr, median_ci_lo, median_ci_hi), e.g., --summary=mean,max (default: mean, median, min, max)");
+        printf("%-40s %-40s\n %50s%s\n", "--nrep-valid[=<factor>]",
+                "with window-based synchronization, repeat until <nrep> measurements are valid,", "",
+                "running at most <factor> * <nrep> repetitions (default factor: 2)");
+        printf("%-40s %-40s\n %50s%s\n", "--pipelined-output",
+                "reduce the results of a job while the next job is set up and write them", "",
+                "from a background thread on the root (not with -v)");
+        printf("%-40s %-40s\n %50s%s\n", "--streaming-summary",
+                "compute the --summary from runtimes reduced in batches with bounded memory", "",
+                "on the root (the median is approximated for more than 1024 valid repetitions)");
+        printf("%-40s %-40s\n %50s%s\n", "--stragglers",
+                "print for each job how often each rank and node finished last (or had the longest", "",
+                "runtime with local clocks) and started first (not with --pipelined-output)");
+        printf("%-40s %-40s\n %50s%s\n", "--histogram[=<global|node>]",
+                "print a log-linear histogram of the local runtimes of all processes (global, default)", "",
+                "or of the processes of each node for each job (not with --pipelined-output)");
 
         printf("\nEXAMPLES: mpirun -np 4 ./bin/mpibenchmark --calls-list=MPI_Bcast --msizes-list=8,512,1024 --nrep=5 --summary=mean,max,min\n");
         printf("\n          mpirun -np 4 ./bin/mpibenchmark --calls-list=MPI_Bcast --msizes-list=8,512,1024 --nrep=5\n");
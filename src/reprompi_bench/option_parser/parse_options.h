@@ -24,10 +24,21 @@
 #ifndef REPROMPIB_PARSE_OPTIONS_H_
 #define REPROMPIB_PARSE_OPTIONS_H_
 
+typedef enum reprompi_histogram_scope {
+    REPROMPI_HISTOGRAM_NONE = 0,
+    REPROMPI_HISTOGRAM_GLOBAL,      /* one histogram merged over all processes */
+    REPROMPI_HISTOGRAM_NODE         /* one histogram per node */
+} reprompi_histogram_scope_t;
+
 typedef struct reprompib_opt {
     long n_rep; /* --nrep */
     int verbose; /* -v */
     int print_summary_methods; /* --summary */
+    double nrep_valid_factor; /* --nrep-valid (0 if disabled) */
+    int enable_pipelined_output; /* --pipelined-output */
+    int enable_streaming_summary; /* --streaming-summary */
+    int enable_stragglers; /* --stragglers */
+    reprompi_histogram_scope_t histogram_scope; /* --histogram */
 } reprompib_options_t;
 
 
@@ -34,6 +34,8 @@
 #include "reprompi_bench/option_parser/parse_common_options.h"
 #include "collective_ops/collectives.h"
 #include "reprompi_bench/utils/keyvalue_store.h"
+#include "buf_manager/mem_allocation.h"
+#include "binary_output.h"
 #include "bench_info_output.h"
 
 #include "version.h"
@@ -68,7 +70,7 @@ void print_command_line_args(int argc, char* argv[]) {
 }
 
 
-void print_common_settings_to_file(FILE* f, const print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict) {
+void print_common_settings_to_file(FILE* f, const reprompib_sync_functions_t* sync_f, const reprompib_dictionary_t* dict) {
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         reprompib_print_dictionary(dict, f);
@@ -84,25 +86,18 @@ void print_common_settings_to_file(FILE* f, const print_sync_info_t print_sync_i
         else{
             fprintf(f, "#@nprocs=%d\n", icmb_local_size());
         }
-#ifdef ENABLE_GLOBAL_TIMES
-        fprintf(f, "#@clocktype=global\n");
-#ifdef ENABLE_LOGP_SYNC
-        fprintf(f, "#@hcasynctype=logp\n");
-#else
-        fprintf(f, "#@hcasynctype=linear\n");
-#endif
-#elif defined(ENABLE_WINDOWSYNC)
-        fprintf(f, "#@clocktype=global\n");
-#else
-        fprintf(f, "#@clocktype=local\n");
-#endif
+        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+            fprintf(f, "#@clocktype=global\n");
+        } else {
+            fprintf(f, "#@clocktype=local\n");
+        }
         print_time_parameters(f);
-        print_sync_info(f);
+        sync_f->print_sync_info(f);
     }
 }
 
 void print_benchmark_common_settings_to_file(FILE* f, const reprompib_common_options_t* opts,
-    const print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict) {
+    const reprompib_sync_functions_t* sync_f, const reprompib_dictionary_t* dict) {
     int len;
     char type_name[MPI_MAX_OBJECT_NAME];
     MPI_Aint lb, extent;
@@ -122,7 +117,6 @@ void print_benchmark_common_settings_to_file(FILE* f, const reprompib_common_opt
               {
                   fprintf(f, "#\t%s\n", call_name);
               }
-              free(call_name);
           }
         }
         if (opts->n_msize > 0) {
@@ -139,24 +133,34 @@ void print_benchmark_common_settings_to_file(FILE* f, const reprompib_common_opt
         if (opts->enable_job_shuffling > 0) {
             fprintf(f, "#@job_shuffling_enabled=%d\n", opts->enable_job_shuffling);
         }
+        fprintf(f, "#@buffer_alloc=%s\n", get_buffer_alloc_list()[opts->buffer_alloc]);
+        if (opts->enable_buffer_pool > 0) {
+            fprintf(f, "#@buffer_pool_enabled=%d\n", opts->enable_buffer_pool);
+        }
+        if (opts->output_format != REPROMPI_OUTPUT_TEXT) {
+            fprintf(f, "#@output_format=%s\n", get_output_format_list()[opts->output_format]);
+        }
+        if (opts->enable_output_mpiio > 0) {
+            fprintf(f, "#@output_mpiio_enabled=%d\n", opts->enable_output_mpiio);
+        }
 
         if (opts->pingpong_ranks[0] >=0 && opts->pingpong_ranks[1] >=0) {
           fprintf(f, "#@pingpong_ranks=%d,%d\n", opts->pingpong_ranks[0], opts->pingpong_ranks[1]);
         }
-        print_common_settings_to_file(f, print_sync_info, dict);
+        print_common_settings_to_file(f, sync_f, dict);
     }
 }
 
 
-void print_common_settings(const reprompib_common_options_t* opts, const print_sync_info_t print_sync_info,
+void print_common_settings(const reprompib_common_options_t* opts, const reprompib_sync_functions_t* sync_f,
                            const reprompib_dictionary_t* dict) {
     FILE* f = stdout;
 
-    print_benchmark_common_settings_to_file(stdout, opts, print_sync_info, dict);
+    print_benchmark_common_settings_to_file(stdout, opts, sync_f, dict);
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         if (opts->output_file != NULL) {
             f = fopen(opts->output_file, "a");
-            print_benchmark_common_settings_to_file(f, opts, print_sync_info, dict);
+            print_benchmark_common_settings_to_file(f, opts, sync_f, dict);
             fflush(f);
             fclose(f);
         }
@@ -166,10 +170,61 @@ void print_common_settings(const reprompib_common_options_t* opts, const print_s
 
 
 
-void print_final_info(const reprompib_common_options_t* opts, const time_t start_time, const time_t end_time) {
+static void print_buffer_pool_info_to_file(FILE* f, const reprompi_buffer_pool_stats_t* stats_p,
+        const double max_saved_time) {
+    fprintf(f, "#@bufpool_jobs=%ld\n", stats_p->n_jobs);
+    fprintf(f, "#@bufpool_size_bytes=%zu\n", stats_p->pool_size_bytes);
+    fprintf(f, "#@bufpool_allocated_bytes=%zu\n", stats_p->allocated_bytes);
+    fprintf(f, "#@bufpool_reused_bytes=%zu\n", stats_p->reused_bytes);
+    fprintf(f, "#@bufpool_setup_time_saved_s=%.10f\n", max_saved_time);
+    if (stats_p->n_jobs > 0) {
+        fprintf(f, "#@bufpool_setup_time_saved_per_job_s=%.10f\n", max_saved_time / stats_p->n_jobs);
+    }
+}
+
+static void print_buffer_pool_info(const reprompib_common_options_t* opts) {
+    reprompi_buffer_pool_stats_t stats;
+    double saved_time, max_saved_time = 0;
+
+    // report the largest setup time saved by a process
+    reprompi_get_buffer_pool_stats(&stats);
+    saved_time = reprompi_buffer_pool_saved_time(&stats);
+    MPI_Reduce(&saved_time, &max_saved_time, 1, MPI_DOUBLE, MPI_MAX,
+            icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
+        print_buffer_pool_info_to_file(stdout, &stats, max_saved_time);
+
+        if (opts->output_file != NULL) {
+            FILE* f = fopen(opts->output_file, "a");
+            print_buffer_pool_info_to_file(f, &stats, max_saved_time);
+            fflush(f);
+            fclose(f);
+        }
+    }
+}
+
+
+void print_final_info(const reprompib_common_options_t* opts, const reprompib_sync_functions_t* sync_f,
+        const time_t start_time, const time_t end_time) {
+
+    if (reprompi_buffer_pool_enabled()) {
+        print_buffer_pool_info(opts);
+    }
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         FILE* f;
+
+        if (sync_f->print_sync_stats != NULL) {
+            sync_f->print_sync_stats(stdout);
+            if (opts->output_file != NULL) {
+                f = fopen(opts->output_file, "a");
+                sync_f->print_sync_stats(f);
+                fflush(f);
+                fclose(f);
+            }
+        }
+
         f = stdout;
         fprintf (f, "# Benchmark started at %s", asctime (localtime (&start_time)));
         fprintf (f, "# Execution time: %lds\n", (long int)(end_time-start_time));
@@ -31,10 +31,11 @@
 
 
 void print_command_line_args(int argc, char* argv[]);
-void print_common_settings(const reprompib_common_options_t* opts, const print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict);
-void print_common_settings_to_file(FILE* f, print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict);
-void print_benchmark_common_settings_to_file(FILE* f, const reprompib_common_options_t* opts, const print_sync_info_t print_sync_info,
+void print_common_settings(const reprompib_common_options_t* opts, const reprompib_sync_functions_t* sync_f, const reprompib_dictionary_t* dict);
+void print_common_settings_to_file(FILE* f, const reprompib_sync_functions_t* sync_f, const reprompib_dictionary_t* dict);
+void print_benchmark_common_settings_to_file(FILE* f, const reprompib_common_options_t* opts, const reprompib_sync_functions_t* sync_f,
                                              const reprompib_dictionary_t* dict);
-void print_final_info(const reprompib_common_options_t* opts, const time_t start_time, const time_t end_time);
+void print_final_info(const reprompib_common_options_t* opts, const reprompib_sync_functions_t* sync_f,
+        const time_t start_time, const time_t end_time);
 
 #endif /* BENCH_INFO_OUTPUT_H_ */
@@ -0,0 +1,282 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "binary_output.h"
+
+static const int MAX_VARINT_BYTES = 10;
+
+static char* const output_format_names[] = {
+        [REPROMPI_OUTPUT_TEXT] = "text",
+        [REPROMPI_OUTPUT_BINARY] = "binary",
+        NULL
+};
+
+static const char* const column_names[] = {
+        [REPROMPIB_BIN_COL_LOC_TSTART] = "loc_tstart_sec",
+        [REPROMPIB_BIN_COL_LOC_TEND] = "loc_tend_sec",
+        [REPROMPIB_BIN_COL_GL_TSTART] = "gl_tstart_sec",
+        [REPROMPIB_BIN_COL_GL_TEND] = "gl_tend_sec",
+        [REPROMPIB_BIN_COL_MODEL_UNC] = "model_unc_sec",
+        [REPROMPIB_BIN_COL_RUNTIME] = "runtime_sec",
+        [REPROMPIB_BIN_COL_WINDOW] = "window_sec"
+};
+
+char* const* get_output_format_list(void) {
+    return &(output_format_names[0]);
+}
+
+const char* reprompib_get_bin_column_name(reprompib_bin_column_t column) {
+    if (column < 0 || column >= REPROMPIB_BIN_N_COLUMNS) {
+        return "";
+    }
+    return column_names[column];
+}
+
+
+static size_t put_varint(unsigned char* p, int64_t value) {
+    uint64_t v = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);     // zigzag
+    size_t n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+static int get_varint(const unsigned char** p, const unsigned char* end, int64_t* value) {
+    uint64_t v = 0;
+    int shift = 0;
+
+    while (*p < end && shift < 64) {
+        unsigned char b = *(*p)++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            *value = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+            return 0;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+/*
+ * consecutive timestamps of a process share sign and exponent, so the
+ * difference of their IEEE 754 bit patterns is small and the encoding lossless
+ */
+static size_t encode_times(unsigned char* p, const double* values, long nrep) {
+    size_t n = sizeof(double);
+    uint64_t prev, bits;
+
+    memcpy(p, &values[0], sizeof(double));
+    memcpy(&prev, &values[0], sizeof(double));
+    for (long i = 1; i < nrep; i++) {
+        memcpy(&bits, &values[i], sizeof(double));
+        n += put_varint(p + n, (int64_t)(bits - prev));
+        prev = bits;
+    }
+    return n;
+}
+
+static int decode_times(const unsigned char** p, const unsigned char* end, double* values, long nrep) {
+    uint64_t bits;
+
+    if (end - *p < (long)sizeof(double)) {
+        return -1;
+    }
+    memcpy(&values[0], *p, sizeof(double));
+    memcpy(&bits, *p, sizeof(double));
+    *p += sizeof(double);
+    for (long i = 1; i < nrep; i++) {
+        int64_t delta;
+        if (get_varint(p, end, &delta) != 0) {
+            return -1;
+        }
+        bits += (uint64_t)delta;
+        memcpy(&values[i], &bits, sizeof(double));
+    }
+    return 0;
+}
+
+
+void reprompib_init_binary_header(reprompib_bin_header_t* header, const char* name, uint32_t flags, int nprocs,
+        long first_rep, long nrep, size_t msize, const int* errorcodes, double* const* columns) {
+    memset(header, 0, sizeof(*header));
+    header->magic = REPROMPIB_BIN_MAGIC;
+    header->flags = flags;
+    header->nprocs = nprocs;
+    header->name_length = strlen(name);
+    header->first_rep = first_rep;
+    header->nrep = nrep;
+    header->msize = msize;
+
+    if (errorcodes == NULL) {
+        header->flags &= ~REPROMPIB_BIN_FLAG_ERRORCODES;
+    }
+    for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+        if (columns[c] != NULL) {
+            header->columns |= (1u << c);
+        }
+    }
+}
+
+size_t reprompib_get_max_binary_process_size(const reprompib_bin_header_t* header) {
+    size_t ncolumns = 0;
+
+    for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+        if (header->columns & (1u << c)) {
+            ncolumns++;
+        }
+    }
+    return header->nrep * (ncolumns + 1) * MAX_VARINT_BYTES + ncolumns * sizeof(double);
+}
+
+size_t reprompib_encode_binary_process(unsigned char* buf, const reprompib_bin_header_t* header,
+        const int* errorcodes, double* const* columns) {
+    size_t size = 0;
+    long nrep = header->nrep;
+
+    if (header->flags & REPROMPIB_BIN_FLAG_ERRORCODES) {
+        for (long i = 0; i < nrep; i++) {
+            size += put_varint(buf + size, errorcodes[i]);
+        }
+    }
+    for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+        if (header->columns & (1u << c)) {
+            size += encode_times(buf + size, columns[c], nrep);
+        }
+    }
+    return size;
+}
+
+
+void reprompib_write_binary_chunk(FILE* f, const char* name, uint32_t flags, int nprocs,
+        long first_rep, long nrep, size_t msize, const int* errorcodes, double* const* columns) {
+    reprompib_bin_header_t header;
+    unsigned char* payload;
+    size_t size = 0;
+
+    if (nrep <= 0) {
+        return;
+    }
+
+    reprompib_init_binary_header(&header, name, flags, nprocs, first_rep, nrep, msize, errorcodes, columns);
+    payload = (unsigned char*)malloc(nprocs * reprompib_get_max_binary_process_size(&header));
+
+    for (int p = 0; p < nprocs; p++) {
+        double* proc_columns[REPROMPIB_BIN_N_COLUMNS] = { NULL };
+
+        for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+            if (columns[c] != NULL) {
+                proc_columns[c] = columns[c] + p * nrep;
+            }
+        }
+        size += reprompib_encode_binary_process(payload + size, &header,
+                (errorcodes != NULL) ? errorcodes + p * nrep : NULL, proc_columns);
+    }
+    header.payload_size = size;
+
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(name, 1, header.name_length, f);
+    fwrite(payload, 1, size, f);
+
+    free(payload);
+}
+
+
+int reprompib_read_binary_chunk(FILE* f, reprompib_bin_chunk_t* chunk) {
+    reprompib_bin_header_t* header = &chunk->header;
+    unsigned char* payload;
+    const unsigned char* p;
+    const unsigned char* end;
+    size_t nvalues;
+    int c, ret = 0;
+
+    memset(chunk, 0, sizeof(*chunk));
+    if (fread(header, sizeof(*header), 1, f) != 1) {
+        return 0;
+    }
+    if (header->magic != REPROMPIB_BIN_MAGIC || header->nprocs == 0 || header->nrep == 0) {
+        return -1;
+    }
+
+    chunk->name = (char*)calloc(header->name_length + 1, sizeof(char));
+    payload = (unsigned char*)malloc(header->payload_size);
+    if (chunk->name == NULL || payload == NULL
+            || fread(chunk->name, 1, header->name_length, f) != header->name_length
+            || fread(payload, 1, header->payload_size, f) != header->payload_size) {
+        free(payload);
+        reprompib_free_binary_chunk(chunk);
+        return -1;
+    }
+
+    nvalues = (size_t)header->nprocs * header->nrep;
+    if (header->flags & REPROMPIB_BIN_FLAG_ERRORCODES) {
+        chunk->errorcodes = (int*)malloc(nvalues * sizeof(int));
+    }
+    for (c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+        if (header->columns & (1u << c)) {
+            chunk->columns[c] = (double*)malloc(nvalues * sizeof(double));
+        }
+    }
+
+    p = payload;
+    end = payload + header->payload_size;
+    for (uint32_t proc = 0; proc < header->nprocs && ret == 0; proc++) {
+        if (chunk->errorcodes != NULL) {
+            for (uint64_t i = 0; i < header->nrep && ret == 0; i++) {
+                int64_t code = 0;
+                ret = get_varint(&p, end, &code);
+                chunk->errorcodes[proc * header->nrep + i] = (int)code;
+            }
+        }
+        for (c = 0; c < REPROMPIB_BIN_N_COLUMNS && ret == 0; c++) {
+            if (chunk->columns[c] != NULL) {
+                ret = decode_times(&p, end, chunk->columns[c] + proc * header->nrep, header->nrep);
+            }
+        }
+    }
+    free(payload);
+
+    if (ret != 0) {
+        reprompib_free_binary_chunk(chunk);
+        return -1;
+    }
+    return 1;
+}
+
+
+void reprompib_free_binary_chunk(reprompib_bin_chunk_t* chunk) {
+    free(chunk->name);
+    free(chunk->errorcodes);
+    for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+        free(chunk->columns[c]);
+    }
+    memset(chunk, 0, sizeof(*chunk));
+}
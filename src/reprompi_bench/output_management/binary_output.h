@@ -0,0 +1,115 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_BINARY_OUTPUT_H_
+#define REPROMPIB_BINARY_OUTPUT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Binary results file (--output-format=binary)
+ *
+ * The file starts with the same "#" settings lines as the text output,
+ * followed by a sequence of chunks. Each chunk is a reprompib_bin_header_t
+ * (host byte order), the name of the test, and a payload with the
+ * measurements of the processes one after the other:
+ *   - nrep error codes (zigzag varints), if REPROMPIB_BIN_FLAG_ERRORCODES is set
+ *   - for each column in the columns mask: the first value as a double,
+ *     then nrep-1 zigzag varints with the difference between the bit
+ *     patterns of consecutive values
+ */
+
+#define REPROMPIB_BIN_MAGIC 0x31425052   /* "RPB1" */
+
+typedef enum reprompi_output_format {
+    REPROMPI_OUTPUT_TEXT = 0,
+    REPROMPI_OUTPUT_BINARY,
+    REPROMPI_N_OUTPUT_FORMATS
+} reprompi_output_format_t;
+
+typedef enum reprompib_bin_column {
+    REPROMPIB_BIN_COL_LOC_TSTART = 0,
+    REPROMPIB_BIN_COL_LOC_TEND,
+    REPROMPIB_BIN_COL_GL_TSTART,
+    REPROMPIB_BIN_COL_GL_TEND,
+    REPROMPIB_BIN_COL_MODEL_UNC,
+    REPROMPIB_BIN_COL_RUNTIME,
+    REPROMPIB_BIN_COL_WINDOW,
+    REPROMPIB_BIN_N_COLUMNS
+} reprompib_bin_column_t;
+
+enum {
+    REPROMPIB_BIN_FLAG_PER_PROCESS = 1,     /* measurements of each process (-v) */
+    REPROMPIB_BIN_FLAG_ERRORCODES = 2,      /* window-based synchronization */
+    REPROMPIB_BIN_FLAG_MSIZE_BYTES = 4      /* msize is given in bytes instead of counts */
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t flags;
+    uint32_t columns;           /* bitmask of reprompib_bin_column_t */
+    uint32_t nprocs;            /* number of processes in the chunk (1 without REPROMPIB_BIN_FLAG_PER_PROCESS) */
+    uint32_t name_length;
+    uint32_t reserved;
+    uint64_t first_rep;
+    uint64_t nrep;
+    uint64_t msize;
+    uint64_t payload_size;      /* bytes following the name */
+} reprompib_bin_header_t;
+
+typedef struct {
+    reprompib_bin_header_t header;
+    char* name;
+    int* errorcodes;                            /* nprocs * nrep values, NULL if missing */
+    double* columns[REPROMPIB_BIN_N_COLUMNS];   /* nprocs * nrep values, NULL if missing */
+} reprompib_bin_chunk_t;
+
+char* const* get_output_format_list(void);
+const char* reprompib_get_bin_column_name(reprompib_bin_column_t column);
+
+/*
+ * header of a chunk (without payload_size) and encoding of the measurements
+ * of a single process, used to write the chunk in parallel (--output-mpiio)
+ */
+void reprompib_init_binary_header(reprompib_bin_header_t* header, const char* name, uint32_t flags, int nprocs,
+        long first_rep, long nrep, size_t msize, const int* errorcodes, double* const* columns);
+size_t reprompib_get_max_binary_process_size(const reprompib_bin_header_t* header);
+size_t reprompib_encode_binary_process(unsigned char* buf, const reprompib_bin_header_t* header,
+        const int* errorcodes, double* const* columns);
+
+/*
+ * writes nprocs * nrep measurements (process-major) of a test; columns[c] and
+ * errorcodes may be NULL for missing columns
+ */
+void reprompib_write_binary_chunk(FILE* f, const char* name, uint32_t flags, int nprocs,
+        long first_rep, long nrep, size_t msize, const int* errorcodes, double* const* columns);
+
+/*
+ * reads the next chunk; returns 1 on success, 0 at the end of the file
+ * and -1 for a corrupted chunk
+ */
+int reprompib_read_binary_chunk(FILE* f, reprompib_bin_chunk_t* chunk);
+void reprompib_free_binary_chunk(reprompib_bin_chunk_t* chunk);
+
+#endif /* REPROMPIB_BINARY_OUTPUT_H_ */
@@ -0,0 +1,217 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+/*
+ * converts a binary results file (--output-format=binary) into the text
+ * output of mpibenchmark or into CSV
+ *
+ * reprompi_convert [--csv] <binary_file> [<output_file>]
+ */
+
+// getline with c99
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "binary_output.h"
+
+enum {
+    CONVERT_ARGS_CSV = 100,
+    CONVERT_ARGS_HELP
+};
+
+static const struct option convert_long_options[] = {
+        {"csv", no_argument, 0, CONVERT_ARGS_CSV},
+        {"help", no_argument, 0, CONVERT_ARGS_HELP},
+        {0, 0, 0, 0}
+};
+
+static void print_help(const char* name) {
+    printf("USAGE: %s [options] <binary_file> [<output_file>]\n", name);
+    printf("\nConverts a results file written with --output-format=binary into the text output\n");
+    printf("(or into CSV) and prints it to <output_file> or to stdout.\n");
+    printf("\nOPTIONS:\n");
+    printf("%-40s %-40s\n", "--csv", "write comma-separated values without the \"#\" settings lines");
+    printf("%-40s %-40s\n", "-h | --help", "print this help");
+}
+
+static void print_column_header(FILE* f, const reprompib_bin_header_t* header, int csv) {
+    const char* msize_str = (header->flags & REPROMPIB_BIN_FLAG_MSIZE_BYTES) ? "msize_bytes" : "count";
+    int per_process = (header->flags & REPROMPIB_BIN_FLAG_PER_PROCESS) != 0;
+    int has_errorcodes = (header->flags & REPROMPIB_BIN_FLAG_ERRORCODES) != 0;
+
+    if (csv) {
+        fprintf(f, "%s%s,%s,%s%s", per_process ? "process," : "", "test", "nrep", msize_str,
+                has_errorcodes ? ",errorcode" : "");
+        for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+            if (header->columns & (1u << c)) {
+                fprintf(f, ",%s", reprompib_get_bin_column_name(c));
+            }
+        }
+        fprintf(f, "\n");
+        return;
+    }
+
+    if (per_process) {
+        fprintf(f, "process ");
+    }
+    fprintf(f, "%50s %10s %12s ", "test", "nrep", msize_str);
+    if (has_errorcodes) {
+        fprintf(f, "%10s ", "errorcode");
+    }
+    for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+        if (header->columns & (1u << c)) {
+            fprintf(f, "%14s ", reprompib_get_bin_column_name(c));
+        }
+    }
+    fprintf(f, "\n");
+}
+
+static void print_chunk(FILE* f, const reprompib_bin_chunk_t* chunk, int csv) {
+    const reprompib_bin_header_t* header = &chunk->header;
+    int per_process = (header->flags & REPROMPIB_BIN_FLAG_PER_PROCESS) != 0;
+
+    for (uint32_t proc_id = 0; proc_id < header->nprocs; proc_id++) {
+        for (uint64_t i = 0; i < header->nrep; i++) {
+            size_t index = proc_id * header->nrep + i;
+            long current_rep_id = (long)(header->first_rep + i);
+
+            if (csv) {
+                if (per_process) {
+                    fprintf(f, "%u,", proc_id);
+                }
+                fprintf(f, "%s,%ld,%lu", chunk->name, current_rep_id, (unsigned long)header->msize);
+                if (chunk->errorcodes != NULL) {
+                    fprintf(f, ",%d", chunk->errorcodes[index]);
+                }
+                for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+                    if (chunk->columns[c] != NULL) {
+                        fprintf(f, ",%.10f", chunk->columns[c][index]);
+                    }
+                }
+                fprintf(f, "\n");
+            } else {
+                if (per_process) {
+                    fprintf(f, "%7u ", proc_id);
+                }
+                fprintf(f, "%50s %10ld %12lu", chunk->name, current_rep_id, (unsigned long)header->msize);
+                if (chunk->errorcodes != NULL) {
+                    fprintf(f, " %10d", chunk->errorcodes[index]);
+                }
+                for (int c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+                    if (chunk->columns[c] != NULL) {
+                        fprintf(f, " %14.10f", chunk->columns[c][index]);
+                    }
+                }
+                fprintf(f, "\n");
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    FILE* in;
+    FILE* out = stdout;
+    int csv = 0;
+    int c, ret;
+    char* line = NULL;
+    size_t line_size = 0;
+    uint32_t last_flags = 0, last_columns = 0;
+    int nchunks = 0;
+
+    while ((c = getopt_long(argc, argv, "h", convert_long_options, NULL)) != -1) {
+        switch (c) {
+        case CONVERT_ARGS_CSV:
+            csv = 1;
+            break;
+        case 'h':
+        case CONVERT_ARGS_HELP:
+            print_help(argv[0]);
+            return 0;
+        default:
+            print_help(argv[0]);
+            return 1;
+        }
+    }
+
+    if (optind >= argc) {
+        print_help(argv[0]);
+        return 1;
+    }
+
+    in = fopen(argv[optind], "rb");
+    if (in == NULL) {
+        fprintf(stderr, "ERROR: Cannot open input file %s\n", argv[optind]);
+        return 1;
+    }
+    if (optind + 1 < argc) {
+        out = fopen(argv[optind + 1], "w");
+        if (out == NULL) {
+            fprintf(stderr, "ERROR: Cannot open output file %s\n", argv[optind + 1]);
+            fclose(in);
+            return 1;
+        }
+    }
+
+    // settings lines ("#...") may precede and follow the binary chunks
+    while ((c = getc(in)) != EOF) {
+        reprompib_bin_chunk_t chunk;
+
+        if (c == '#') {
+            ungetc(c, in);
+            if (getline(&line, &line_size, in) < 0) {
+                break;
+            }
+            if (!csv) {
+                fputs(line, out);
+            }
+            continue;
+        }
+
+        ungetc(c, in);
+        ret = reprompib_read_binary_chunk(in, &chunk);
+        if (ret <= 0) {
+            fprintf(stderr, "ERROR: Corrupted chunk %d in %s\n", nchunks, argv[optind]);
+            break;
+        }
+
+        if (nchunks == 0 || chunk.header.flags != last_flags || chunk.header.columns != last_columns) {
+            print_column_header(out, &chunk.header, csv);
+            last_flags = chunk.header.flags;
+            last_columns = chunk.header.columns;
+        }
+        print_chunk(out, &chunk, csv);
+        reprompib_free_binary_chunk(&chunk);
+        nchunks++;
+    }
+
+    free(line);
+    fclose(in);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return (c == EOF) ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+
+#include "collective_ops/collectives.h"
+#include "latency_histogram.h"
+#include "reprompi_bench/utils/node_topology.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+static const int OUTPUT_ROOT_PROC = 0;
+
+static reprompi_histogram_scope_t histogram_scope = REPROMPI_HISTOGRAM_NONE;
+static char* node_names = NULL;                 // names of the nodes on the root (histograms per node)
+static int n_nodes = 0;
+static int* leader_counts = NULL;               // receive counts and displacements of the node histograms
+static int* leader_displs = NULL;               // (non-zero for the node leaders only, on the root)
+
+
+void reprompib_reset_histogram(reprompib_histogram_t* hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+void reprompib_init_histograms(reprompi_histogram_scope_t scope) {
+    int* rank_nodes;
+    int nprocs = icmb_global_size();
+    int p, node;
+
+    histogram_scope = scope;
+    if (scope != REPROMPI_HISTOGRAM_NODE) {
+        return;
+    }
+
+    reprompib_init_node_topology();
+    n_nodes = reprompib_get_n_nodes();
+    reprompib_gather_node_info(icmb_lookup_global_rank(OUTPUT_ROOT_PROC), &rank_nodes, &node_names);
+    if (rank_nodes == NULL) {
+        return;
+    }
+
+    // the leader of a node is its first rank
+    leader_counts = (int*)calloc(nprocs, sizeof(int));
+    leader_displs = (int*)calloc(nprocs, sizeof(int));
+    for (p = 0, node = 0; p < nprocs; p++) {
+        if (rank_nodes[p] == node) {
+            leader_counts[p] = REPROMPIB_HIST_N_BUCKETS;
+            leader_displs[p] = node++ * REPROMPIB_HIST_N_BUCKETS;
+        }
+    }
+    free(rank_nodes);
+}
+
+void reprompib_cleanup_histograms(void) {
+    if (histogram_scope == REPROMPI_HISTOGRAM_NODE) {
+        reprompib_cleanup_node_topology();
+    }
+    free(node_names);
+    free(leader_counts);
+    free(leader_displs);
+    node_names = NULL;
+    leader_counts = NULL;
+    leader_displs = NULL;
+    n_nodes = 0;
+    histogram_scope = REPROMPI_HISTOGRAM_NONE;
+}
+
+
+static void print_buckets(FILE* f, const long long* counts) {
+    int i;
+
+    for (i = 0; i < REPROMPIB_HIST_N_BUCKETS; i++) {
+        if (counts[i] > 0) {
+            unsigned long long lower, upper;
+
+            reprompib_get_bucket_bounds(i, &lower, &upper);
+            fprintf(f, "#   %14.10f %14.10f %12lld\n", lower * 1e-9, upper * 1e-9, counts[i]);
+        }
+    }
+}
+
+void reprompib_print_histogram(job_t job, const reprompib_histogram_t* hist, const char* output_file_path) {
+    reprompib_histogram_t* merged = NULL;
+    reprompib_histogram_t* nodes = NULL;
+    int is_root = icmb_has_initiator_rank(OUTPUT_ROOT_PROC);
+    FILE* f = stdout;
+    int n;
+
+    if (histogram_scope == REPROMPI_HISTOGRAM_NONE) {
+        return;
+    }
+
+    if (histogram_scope == REPROMPI_HISTOGRAM_GLOBAL) {
+        if (is_root) {
+            merged = (reprompib_histogram_t*)malloc(sizeof(reprompib_histogram_t));
+        }
+        MPI_Reduce(hist->counts, (is_root) ? merged->counts : NULL, REPROMPIB_HIST_N_BUCKETS,
+                MPI_LONG_LONG, MPI_SUM, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+    } else {
+        // merge within each node, then collect the histograms of the node leaders on the root
+        reprompib_histogram_t node_hist;
+        int is_leader = (reprompib_get_leader_comm() != MPI_COMM_NULL);
+
+        MPI_Reduce(hist->counts, node_hist.counts, REPROMPIB_HIST_N_BUCKETS,
+                MPI_LONG_LONG, MPI_SUM, 0, reprompib_get_node_comm());
+
+        if (is_root) {
+            nodes = (reprompib_histogram_t*)malloc(n_nodes * sizeof(reprompib_histogram_t));
+        }
+        MPI_Gatherv(node_hist.counts, (is_leader) ? REPROMPIB_HIST_N_BUCKETS : 0, MPI_LONG_LONG,
+                (is_root) ? nodes->counts : NULL, leader_counts, leader_displs, MPI_LONG_LONG,
+                icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+    }
+
+    if (!is_root) {
+        return;
+    }
+
+    if (output_file_path != NULL) {
+        f = fopen(output_file_path, "a");
+    }
+    fprintf(f, "# histogram %s count=%ld nprocs=%d\n", get_call_from_index(job.call_index), (long)job.count,
+            icmb_global_size());
+    if (histogram_scope == REPROMPI_HISTOGRAM_GLOBAL) {
+        fprintf(f, "#   %14s %14s %12s\n", "lower_sec", "upper_sec", "count");
+        print_buckets(f, merged->counts);
+    } else {
+        for (n = 0; n < n_nodes; n++) {
+            fprintf(f, "#  node %s\n", node_names + n * MPI_MAX_PROCESSOR_NAME);
+            fprintf(f, "#   %14s %14s %12s\n", "lower_sec", "upper_sec", "count");
+            print_buckets(f, nodes[n].counts);
+        }
+    }
+    if (output_file_path != NULL) {
+        fflush(f);
+        fclose(f);
+    }
+
+    free(merged);
+    free(nodes);
+}
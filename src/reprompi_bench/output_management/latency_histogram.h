@@ -0,0 +1,98 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_LATENCY_HISTOGRAM_H_
+#define REPROMPIB_LATENCY_HISTOGRAM_H_
+
+#include "benchmark_job.h"
+#include "reprompi_bench/option_parser/parse_options.h"
+
+/*
+ * Log-linear latency histogram (--histogram): runtimes are counted in
+ * nanoseconds, exactly below 2^REPROMPIB_HIST_SUB_BITS ns and above that in
+ * 2^(REPROMPIB_HIST_SUB_BITS-1) linear buckets per power of two (a relative
+ * bucket width below 1.6%), up to 2^REPROMPIB_HIST_MAX_EXP ns (about 18 min).
+ * Each process fills its own histogram; they are merged with MPI_SUM.
+ */
+
+enum {
+    REPROMPIB_HIST_SUB_BITS = 7,
+    REPROMPIB_HIST_MAX_EXP = 40,
+    REPROMPIB_HIST_HALF_SUB_COUNT = 1 << (REPROMPIB_HIST_SUB_BITS - 1),
+    REPROMPIB_HIST_N_BUCKETS = (REPROMPIB_HIST_MAX_EXP - REPROMPIB_HIST_SUB_BITS + 2) * REPROMPIB_HIST_HALF_SUB_COUNT
+};
+
+typedef struct {
+    long long counts[REPROMPIB_HIST_N_BUCKETS];
+} reprompib_histogram_t;
+
+// counts a runtime in seconds (called in the measurement loop)
+static inline void reprompib_record_latency(reprompib_histogram_t* hist, double runtime_sec) {
+    double ns = runtime_sec * 1e9;
+    unsigned long long v;
+    int index;
+
+    if (!(ns > 0)) {
+        v = 0;
+    } else if (ns >= (double)(1ULL << REPROMPIB_HIST_MAX_EXP)) {
+        v = (1ULL << REPROMPIB_HIST_MAX_EXP) - 1;
+    } else {
+        v = (unsigned long long)ns;
+    }
+
+    if (v < 2 * REPROMPIB_HIST_HALF_SUB_COUNT) {
+        index = (int)v;
+    } else {
+        int shift = 63 - __builtin_clzll(v) - REPROMPIB_HIST_SUB_BITS + 1;
+        index = shift * REPROMPIB_HIST_HALF_SUB_COUNT + (int)(v >> shift);
+    }
+    hist->counts[index]++;
+}
+
+// [lower, upper) bounds of a bucket in nanoseconds
+static inline void reprompib_get_bucket_bounds(int index, unsigned long long* lower, unsigned long long* upper) {
+    int shift = index / REPROMPIB_HIST_HALF_SUB_COUNT - 1;
+    unsigned long long sub;
+
+    if (shift < 0) {
+        shift = 0;
+    }
+    sub = index - shift * REPROMPIB_HIST_HALF_SUB_COUNT;
+    *lower = sub << shift;
+    *upper = (sub + 1) << shift;
+}
+
+void reprompib_reset_histogram(reprompib_histogram_t* hist);
+
+// sets up the node topology and the node names for histograms per node (collective)
+void reprompib_init_histograms(reprompi_histogram_scope_t scope);
+void reprompib_cleanup_histograms(void);
+
+/*
+ * merges the histograms of a job (over all processes or over the processes of
+ * each node) and prints the non-empty buckets as "#" lines into the output
+ * file, or to stdout without one (collective)
+ */
+void reprompib_print_histogram(job_t job, const reprompib_histogram_t* hist, const char* output_file_path);
+
+#endif /* REPROMPIB_LATENCY_HISTOGRAM_H_ */
@@ -0,0 +1,189 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mpi.h"
+
+#include "results_output.h"
+#include "runtimes_computation.h"
+#include "pipelined_output.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+static const int OUTPUT_ROOT_PROC = 0;
+
+// results of a job handed to the writer thread (root only)
+typedef struct {
+    reprompib_job_results_t results;
+    reprompib_rep_bounds_t* bounds;     // reduced start/end times and error codes with global clocks
+} writer_job_t;
+
+typedef struct {
+    int pending;
+    MPI_Request request;
+
+    // local send buffers, kept until the reduction completes
+    reprompib_rep_bounds_t* local_bounds;   // with global clocks
+    double* local_runtimes_sec;             // with local clocks
+
+    writer_job_t* wjob;
+} pipeline_t;
+
+static pipeline_t pipeline;
+static pthread_t writer_thread;
+static int writer_running = 0;
+static int use_writer_thread = 1;
+
+static int summary_methods = 0;
+static const char* output_file = NULL;
+
+
+static void write_job(writer_job_t* wjob) {
+    reprompib_job_results_t* results = &wjob->results;
+
+    if (results->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        for (long i = 0; i < results->job.n_rep; i++) {
+            results->maxRuntimes_sec[i] = wjob->bounds[i].end_sec - wjob->bounds[i].start_sec;
+            results->sync_errorcodes[i] = wjob->bounds[i].errorcode;
+        }
+    }
+
+    print_job_results(results, summary_methods, output_file);
+
+    free(wjob->bounds);
+    free(results->maxRuntimes_sec);
+    free(results->sync_errorcodes);
+    free(results->windows_sec);
+    free(wjob);
+}
+
+static void* writer_main(void* arg) {
+    write_job((writer_job_t*)arg);
+    return NULL;
+}
+
+static void join_writer(void) {
+    if (writer_running) {
+        pthread_join(writer_thread, NULL);
+        writer_running = 0;
+    }
+}
+
+
+void reprompib_init_pipelined_output(int print_summary_methods, const char* output_file_path) {
+    int provided;
+
+    summary_methods = print_summary_methods;
+    output_file = output_file_path;
+    memset(&pipeline, 0, sizeof(pipeline));
+
+    // the writer thread makes no MPI calls, but the MPI library has to allow other threads
+    MPI_Query_thread(&provided);
+    use_writer_thread = (provided >= MPI_THREAD_FUNNELED);
+}
+
+
+void reprompib_start_pipelined_output(job_t job, const double* tstart_sec, const double* tend_sec,
+        const reprompib_sync_functions_t* sync_f) {
+    int root = icmb_lookup_global_rank(OUTPUT_ROOT_PROC);
+    long n_rep = job.n_rep;
+    writer_job_t* wjob = NULL;
+    MPI_Datatype bounds_type;
+    MPI_Op bounds_op;
+    long i;
+
+    reprompib_complete_pipelined_output();
+
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
+        wjob = (writer_job_t*) calloc(1, sizeof(writer_job_t));
+        wjob->results.job = job;
+        wjob->results.clocktype = sync_f->clocktype;
+        wjob->results.maxRuntimes_sec = (double*) malloc(n_rep * sizeof(double));
+
+        // the window sizes are released with the sync module
+        if (sync_f->get_window_sizes != NULL && sync_f->get_window_sizes() != NULL) {
+            wjob->results.windows_sec = (double*) malloc(n_rep * sizeof(double));
+            memcpy(wjob->results.windows_sec, sync_f->get_window_sizes(), n_rep * sizeof(double));
+        }
+    }
+
+    if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        // the error codes are copied as well, so the sync module may be released
+        pipeline.local_bounds = (reprompib_rep_bounds_t*) malloc(n_rep * sizeof(reprompib_rep_bounds_t));
+        reprompib_init_rep_bounds(tstart_sec, tend_sec, sync_f->get_errorcodes(), n_rep,
+                sync_f->get_normalized_times, pipeline.local_bounds);
+
+        if (wjob != NULL) {
+            wjob->results.sync_errorcodes = (int*) malloc(n_rep * sizeof(int));
+            wjob->bounds = (reprompib_rep_bounds_t*) malloc(n_rep * sizeof(reprompib_rep_bounds_t));
+        }
+        reprompib_get_rep_bounds_op(&bounds_type, &bounds_op);
+        MPI_Ireduce(pipeline.local_bounds, (wjob != NULL) ? wjob->bounds : NULL, n_rep,
+                bounds_type, bounds_op, root, icmb_global_communicator(), &pipeline.request);
+    } else {
+        pipeline.local_runtimes_sec = (double*) malloc(n_rep * sizeof(double));
+        for (i = 0; i < n_rep; i++) {
+            pipeline.local_runtimes_sec[i] = tend_sec[i] - tstart_sec[i];
+        }
+        MPI_Ireduce(pipeline.local_runtimes_sec, (wjob != NULL) ? wjob->results.maxRuntimes_sec : NULL, n_rep,
+                MPI_DOUBLE, MPI_MAX, root, icmb_global_communicator(), &pipeline.request);
+    }
+
+    pipeline.wjob = wjob;
+    pipeline.pending = 1;
+}
+
+
+void reprompib_complete_pipelined_output(void) {
+    if (!pipeline.pending) {
+        return;
+    }
+
+    MPI_Wait(&pipeline.request, MPI_STATUS_IGNORE);
+    free(pipeline.local_bounds);
+    free(pipeline.local_runtimes_sec);
+    pipeline.local_bounds = NULL;
+    pipeline.local_runtimes_sec = NULL;
+    pipeline.pending = 0;
+
+    if (pipeline.wjob != NULL) {
+        // keep the output of the jobs in order
+        join_writer();
+
+        if (use_writer_thread && pthread_create(&writer_thread, NULL, writer_main, pipeline.wjob) == 0) {
+            writer_running = 1;
+        } else {
+            write_job(pipeline.wjob);
+        }
+        pipeline.wjob = NULL;
+    }
+}
+
+
+void reprompib_finish_pipelined_output(void) {
+    reprompib_complete_pipelined_output();
+    join_writer();
+}
@@ -0,0 +1,55 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_PIPELINED_OUTPUT_H_
+#define REPROMPIB_PIPELINED_OUTPUT_H_
+
+#include "benchmark_job.h"
+#include "reprompi_bench/sync/synchronization.h"
+
+/*
+ * Pipelined output (--pipelined-output): the results of a job are reduced
+ * with nonblocking collectives while the next job is initialized, and a
+ * writer thread on the root formats and writes them in the background.
+ */
+
+void reprompib_init_pipelined_output(int print_summary_methods, const char* output_file_path);
+
+/*
+ * normalizes the timestamps of the job that just finished (with the clock
+ * model of the job) and starts their reduction; the timestamps and the sync
+ * module may be released afterwards
+ */
+void reprompib_start_pipelined_output(job_t job, const double* tstart_sec, const double* tend_sec,
+        const reprompib_sync_functions_t* sync_f);
+
+/*
+ * completes the pending reduction and passes the results to the writer thread;
+ * called before the next timing-sensitive phase (clock synchronization)
+ */
+void reprompib_complete_pipelined_output(void);
+
+// completes the pending reduction and waits for the writer thread
+void reprompib_finish_pipelined_output(void);
+
+#endif /* REPROMPIB_PIPELINED_OUTPUT_H_ */
@@ -26,15 +26,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <gsl/gsl_statistics.h>
-#include <gsl/gsl_sort.h>
 #include "mpi.h"
 
 #include "benchmark_job.h"
 #include "reprompi_bench/sync/synchronization.h"
 #include "reprompi_bench/option_parser/parse_options.h"
 #include "collective_ops/collectives.h"
+#include "reprompi_bench/misc.h"
 #include "runtimes_computation.h"
+#include "binary_output.h"
+#include "streaming_stats.h"
+#include "summary_computation.h"
 #include "results_output.h"
 
 #include "contrib/intercommunication/intercommunication.h"
@@ -53,7 +55,51 @@ static const output_msize_t OUTPUT_MSIZE_TYPE = OUTPUT_MSIZE_BYTES;
 static const output_msize_t OUTPUT_MSIZE_TYPE = OUTPUT_COUNT;
 #endif
 
-void print_results_header(const reprompib_options_t* opts, const char* output_file_path, int verbose) {
+static reprompi_output_format_t output_format = REPROMPI_OUTPUT_TEXT;
+static const char* output_mpiio_path = NULL;
+static int summary_streaming = 0;
+
+void set_results_output_format(reprompi_output_format_t format) {
+    output_format = format;
+}
+
+void set_results_output_mpiio(const char* output_file_path) {
+    output_mpiio_path = output_file_path;
+}
+
+void set_results_summary_streaming(int enable) {
+    summary_streaming = enable;
+}
+
+// flags of the binary chunks written for a job
+static uint32_t get_binary_flags(reprompi_clock_type_t clocktype, int verbose) {
+    uint32_t flags = 0;
+
+    if (verbose) {
+        flags |= REPROMPIB_BIN_FLAG_PER_PROCESS;
+    }
+    if (clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        flags |= REPROMPIB_BIN_FLAG_ERRORCODES;
+    }
+    if (OUTPUT_MSIZE_TYPE == OUTPUT_MSIZE_BYTES) {
+        flags |= REPROMPIB_BIN_FLAG_MSIZE_BYTES;
+    }
+    return flags;
+}
+
+// the sync method tracks its clock models online and reports their uncertainty for each repetition
+static int has_model_uncertainties(const reprompib_sync_functions_t* sync_f) {
+    return (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL && sync_f->get_uncertainties != NULL
+            && sync_f->get_uncertainties() != NULL);
+}
+
+// the sync method adapts its window size (--auto-window) and reports the window used for each repetition
+static int has_adaptive_window(const reprompib_sync_functions_t* sync_f) {
+    return (sync_f->get_window_sizes != NULL && sync_f->get_window_sizes() != NULL);
+}
+
+void print_results_header(const reprompib_options_t* opts, const reprompib_sync_functions_t* sync_f,
+        const char* output_file_path, int verbose) {
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
         FILE * f;
@@ -77,6 +123,9 @@ void print_results_header(const reprompib_options_t* opts, const char* output_fi
               fprintf(f, "%10s_sec ", s->name);
             }
           }
+          if (has_adaptive_window(sync_f)) {
+              fprintf(f, "%14s ", "window_sec");
+          }
           fprintf(f, "\n");
         }
 
@@ -86,23 +135,30 @@ void print_results_header(const reprompib_options_t* opts, const char* output_fi
             f = fopen(output_file_path, "a");
         }
 
-        if (output_file_path != NULL || opts->print_summary_methods == 0) {
+        // binary results files describe their columns in each chunk
+        if ((output_file_path != NULL && output_format == REPROMPI_OUTPUT_TEXT)
+                || (output_file_path == NULL && opts->print_summary_methods == 0)) {
             if (verbose == 1) {    // print measurement times for each process
                 fprintf(f, "process ");
             }
 
-#ifdef ENABLE_WINDOWSYNC
-            fprintf(f, "%50s %10s %12s %10s ", "test", "nrep", msize_str, "errorcode");
-#else
-            fprintf(f, "%50s %10s %12s ", "test", "nrep", msize_str);
-#endif
+            if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                fprintf(f, "%50s %10s %12s %10s ", "test", "nrep", msize_str, "errorcode");
+            } else {
+                fprintf(f, "%50s %10s %12s ", "test", "nrep", msize_str);
+            }
 
             if (verbose == 1) {
-#ifdef ENABLE_WINDOWSYNC
-                fprintf(f, "%14s %14s %14s %14s \n", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
-#else
-                fprintf(f,  "%14s %14s \n", "loc_tstart_sec", "loc_tend_sec");
-#endif
+                if (has_model_uncertainties(sync_f)) {
+                    fprintf(f, "%14s %14s %14s %14s %14s \n", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec",
+                            "model_unc_sec");
+                } else if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                    fprintf(f, "%14s %14s %14s %14s \n", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
+                } else {
+                    fprintf(f,  "%14s %14s \n", "loc_tstart_sec", "loc_tend_sec");
+                }
+            } else if (has_adaptive_window(sync_f)) {
+                fprintf(f,  "%14s %14s \n", "runtime_sec", "window_sec");
             } else {
                 fprintf(f,  "%14s \n", "runtime_sec");
             }
@@ -122,75 +178,364 @@ void print_results_header(const reprompib_options_t* opts, const char* output_fi
 
 
 
-void print_runtimes(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time) {
+static size_t get_msize_value(const job_t* job) {
+    if (OUTPUT_MSIZE_TYPE == OUTPUT_MSIZE_BYTES) {
+      // print msize in bytes
+      return job->msize;
+    } else {    // print counts
+      return job->count;
+    }
+}
+
+static void write_runtimes(FILE* f, const reprompib_job_results_t* results) {
+    const job_t* job = &results->job;
+    size_t msize_value = get_msize_value(job);
+    const char* call_name = get_call_from_index(job->call_index);
+    int i;
+
+    if (output_format == REPROMPI_OUTPUT_BINARY) {
+        double* columns[REPROMPIB_BIN_N_COLUMNS] = { NULL };
+
+        columns[REPROMPIB_BIN_COL_RUNTIME] = results->maxRuntimes_sec;
+        columns[REPROMPIB_BIN_COL_WINDOW] = results->windows_sec;
+        reprompib_write_binary_chunk(f, call_name, get_binary_flags(results->clocktype, 0), 1,
+                0, job->n_rep, msize_value, results->sync_errorcodes, columns);
+        return;
+    }
+
+    for (i = 0; i < job->n_rep; i++) {
+
+        if (results->windows_sec != NULL) {
+            fprintf(f, "%50s %10d %12ld %10d %14.10f %14.10f\n", call_name, i,
+                    msize_value, results->sync_errorcodes[i],
+                    results->maxRuntimes_sec[i], results->windows_sec[i]);
+        } else if (results->clocktype == REPROMPI_CLOCKS_GLOBAL) {   // measurements with window-based synchronization
+            fprintf(f, "%50s %10d %12ld %10d %14.10f\n", call_name, i,
+                    msize_value, results->sync_errorcodes[i],
+                    results->maxRuntimes_sec[i]);
+        } else {    // measurements with Barrier-based synchronization
+            fprintf(f, "%50s %10d %12ld %14.10f\n", call_name, i,
+                    msize_value, results->maxRuntimes_sec[i]);
+        }
+    }
+}
+
+// value of a summary method computed from the streaming statistics (--streaming-summary)
+static double get_streaming_summary_value(const char* name, const reprompib_streaming_stats_t* stats) {
+    double value = 0;
+
+    if (strcmp(name, "mean") == 0) {
+      value = stats->mean;
+    }
+    else if (strcmp(name, "median") == 0) {
+      value = reprompib_get_streaming_quantile(stats, 0.5);
+    }
+    else if (strcmp(name, "min") == 0) {
+      value = stats->min;
+    }
+    else if (strcmp(name, "max") == 0) {
+      value = stats->max;
+    }
+    else if (strcmp(name, "p90") == 0) {
+      value = reprompib_get_streaming_quantile(stats, 0.9);
+    }
+    else if (strcmp(name, "p99") == 0) {
+      value = reprompib_get_streaming_quantile(stats, 0.99);
+    }
+    else if (strcmp(name, "p99.9") == 0) {
+      value = reprompib_get_streaming_quantile(stats, 0.999);
+    }
+    else if (strcmp(name, "iqr") == 0) {
+      value = reprompib_get_streaming_quantile(stats, 0.75) - reprompib_get_streaming_quantile(stats, 0.25);
+    }
+    return value;
+}
+
+/*
+ * prints the summary line of a job from the valid runtimes (which are
+ * reordered) or, if runtimes_sec is NULL, from the streaming statistics
+ */
+static void write_summary_line(FILE* f, const job_t* job, const int print_summary_methods,
+        double* runtimes_sec, const reprompib_streaming_stats_t* stats, long nreps,
+        const double* last_window_sec) {
+    int i;
+
+    fprintf(f, "%50s %12ld %10ld %10ld ", get_call_from_index(job->call_index), get_msize_value(job), job->n_rep, nreps);
+
+    if (print_summary_methods > 0) {
+      for (i=0; i<reprompib_get_number_summary_methods(); i++) {
+        summary_method_info_t* s = reprompib_get_summary_method(i);
+
+        if (print_summary_methods & s->mask) {
+          double value;
+
+          if (runtimes_sec != NULL) {
+            value = reprompib_compute_summary(s->name, runtimes_sec, nreps);
+          } else {
+            value = get_streaming_summary_value(s->name, stats);
+          }
+          fprintf(f, "  %.10f ", value);
+        }
+      }
+    }
+    if (last_window_sec != NULL) {
+        // window size chosen by the last adaptation of the job
+        fprintf(f, "%14.10f ", *last_window_sec);
+    }
+    fprintf(f, "\n");
+}
 
+static void write_summary(FILE* f, const reprompib_job_results_t* results, const int print_summary_methods) {
+    const job_t* job = &results->job;
+    const double* last_window_sec = (results->windows_sec != NULL) ? &results->windows_sec[job->n_rep - 1] : NULL;
     double* maxRuntimes_sec;
+    long nreps = 0;
     int i;
-    long current_start_index;
-    size_t msize_value;
-#ifdef ENABLE_WINDOWSYNC
-    int* sync_errorcodes = NULL;
-#endif
 
-    if (OUTPUT_MSIZE_TYPE == OUTPUT_MSIZE_BYTES) {
-      // print msize in bytes
-      msize_value = job.msize;
-    } else {    // print counts
-      msize_value = job.count;
+    if (summary_streaming) {
+        reprompib_streaming_stats_t stats;
+
+        reprompib_init_streaming_stats(&stats);
+        reprompib_add_to_streaming_stats(&stats, results->maxRuntimes_sec, results->sync_errorcodes, job->n_rep);
+        write_summary_line(f, job, print_summary_methods, NULL, &stats, stats.count, last_window_sec);
+        reprompib_free_streaming_stats(&stats);
+        return;
     }
 
+    // remove measurements with out-of-window errors
+    maxRuntimes_sec = (double*) malloc(job->n_rep * sizeof(double));
+    for (i = 0; i < job->n_rep; i++) {
+        if (results->sync_errorcodes == NULL || results->sync_errorcodes[i] == 0) {
+            maxRuntimes_sec[nreps] = results->maxRuntimes_sec[i];
+            nreps++;
+        }
+    }
+
+    write_summary_line(f, job, print_summary_methods, maxRuntimes_sec, NULL, nreps, last_window_sec);
 
-    maxRuntimes_sec = NULL;
+    free(maxRuntimes_sec);
+}
+
+/*
+ * reduces the runtimes of a job at the root (results->maxRuntimes_sec and
+ * results->sync_errorcodes are only allocated on the root)
+ */
+static void reduce_job_results(job_t job, double* tstart_sec, double* tend_sec,
+        const reprompib_sync_functions_t* sync_f, reprompib_job_results_t* results) {
+    long current_start_index = 0;
+
+    memset(results, 0, sizeof(*results));
+    results->job = job;
+    results->clocktype = sync_f->clocktype;
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
-        maxRuntimes_sec = (double*) malloc(job.n_rep * sizeof(double));
+        results->maxRuntimes_sec = (double*) malloc(job.n_rep * sizeof(double));
+        results->sync_errorcodes = (int*) calloc(job.n_rep, sizeof(int));
+    }
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job.n_rep * sizeof(int));
-        for (i = 0; i < job.n_rep; i++) {
-            sync_errorcodes[i] = 0;
-        }
-#endif
+    if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
+                sync_f->get_errorcodes, sync_f->get_normalized_times,
+                results->maxRuntimes_sec, results->sync_errorcodes);
+    } else {
+        compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
+                results->maxRuntimes_sec);
     }
 
-    current_start_index = 0;
+    if (has_adaptive_window(sync_f)) {
+        results->windows_sec = sync_f->get_window_sizes();   // the same on all processes
+    }
+}
 
-#ifdef ENABLE_WINDOWSYNC
-    compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            get_errorcodes, get_global_time,
-            maxRuntimes_sec, sync_errorcodes);
-#else
-    compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            maxRuntimes_sec);
-#endif
+
+void print_job_results(const reprompib_job_results_t* results, const int print_summary_methods,
+        const char* output_file_path) {
+    FILE* f = stdout;
+
+    if (print_summary_methods > 0) {
+        write_summary(stdout, results, print_summary_methods);
+    }
+    if (output_file_path != NULL) {
+        f = fopen(output_file_path, "a");
+        write_runtimes(f, results);
+        fflush(f);
+        fclose(f);
+    } else if (print_summary_methods == 0) {
+        write_runtimes(f, results);
+    }
+}
+
+
+static void print_runtimes(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompib_sync_functions_t* sync_f) {
+    reprompib_job_results_t results;
+
+    reduce_job_results(job, tstart_sec, tend_sec, sync_f, &results);
 
     if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
+        write_runtimes(f, &results);
 
-        for (i = 0; i < job.n_rep; i++) {
+        free(results.sync_errorcodes);
+        free(results.maxRuntimes_sec);
+    }
+}
 
-#if defined(ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-            fprintf(f, "%50s %10d %12ld %10d %14.10f\n", get_call_from_index(job.call_index), i,
-                    msize_value, sync_errorcodes[i],
-                    maxRuntimes_sec[i]);
-#else   // measurements with Barrier-based synchronization
-            fprintf(f, "%50s %10d %12ld %14.10f\n", get_call_from_index(job.call_index), i,
-                    msize_value, maxRuntimes_sec[i]);
-#endif
-        }
 
-#ifdef ENABLE_WINDOWSYNC
-        free(sync_errorcodes);
-#endif
+/*
+ * formats the measurements of this process for the repetitions
+ * [first_rep, first_rep + chunk_nrep) into buf (text lines or a binary
+ * chunk segment) and returns the number of bytes
+ */
+static size_t format_process_results(char* buf, size_t buf_size, const reprompib_bin_header_t* bin_header,
+        job_t job, size_t msize_value, long first_rep, int chunk_nrep, double* const* columns, const int* errorcodes) {
+    size_t size = 0;
+    const char* call_name = get_call_from_index(job.call_index);
+    int proc_id = icmb_global_rank();
+    int i;
 
-        free(maxRuntimes_sec);
+    if (output_format == REPROMPI_OUTPUT_BINARY) {
+        return reprompib_encode_binary_process((unsigned char*)buf, bin_header, errorcodes, columns);
     }
+
+    for (i = 0; i < chunk_nrep && size < buf_size; i++) {
+        int current_rep_id = first_rep + i;
+
+        if (columns[REPROMPIB_BIN_COL_MODEL_UNC] != NULL) {
+            size += snprintf(buf + size, buf_size - size, "%7d %50s %10d %12ld %10d %14.10f %14.10f %14.10f %14.10f %14.10f\n",
+                    proc_id, call_name, current_rep_id, msize_value, errorcodes[i],
+                    columns[REPROMPIB_BIN_COL_LOC_TSTART][i], columns[REPROMPIB_BIN_COL_LOC_TEND][i],
+                    columns[REPROMPIB_BIN_COL_GL_TSTART][i], columns[REPROMPIB_BIN_COL_GL_TEND][i],
+                    columns[REPROMPIB_BIN_COL_MODEL_UNC][i]);
+        } else if (errorcodes != NULL) {
+            size += snprintf(buf + size, buf_size - size, "%7d %50s %10d %12ld %10d %14.10f %14.10f %14.10f %14.10f\n",
+                    proc_id, call_name, current_rep_id, msize_value, errorcodes[i],
+                    columns[REPROMPIB_BIN_COL_LOC_TSTART][i], columns[REPROMPIB_BIN_COL_LOC_TEND][i],
+                    columns[REPROMPIB_BIN_COL_GL_TSTART][i], columns[REPROMPIB_BIN_COL_GL_TEND][i]);
+        } else {
+            size += snprintf(buf + size, buf_size - size, "%7d %50s %10d %12ld %14.10f %14.10f\n",
+                    proc_id, call_name, current_rep_id, msize_value,
+                    columns[REPROMPIB_BIN_COL_LOC_TSTART][i], columns[REPROMPIB_BIN_COL_LOC_TEND][i]);
+        }
+    }
+    if (size >= buf_size) {
+        reprompib_print_error_and_exit("Output buffer too small for the measurement results");
+    }
+    return size;
 }
 
+/*
+ * each process writes its own measurements into the results file with
+ * collective MPI-IO, in the same order as the results gathered at the root
+ * (chunks of OUTPUT_NITERATIONS_CHUNK repetitions, one process after the other)
+ */
+static void print_process_results_mpiio(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompib_sync_functions_t* sync_f, size_t msize_value) {
+    MPI_File fh;
+    MPI_Offset base_offset;
+    int chunk_id, nchunks;
+    int* local_errorcodes = NULL;
+    double* local_uncertainties = NULL;
+    double* global_start_sec = NULL;
+    double* global_end_sec = NULL;
+    char* buf;
+    size_t buf_size;
+    const char* call_name = get_call_from_index(job.call_index);
+    int is_root = icmb_has_initiator_rank(OUTPUT_ROOT_PROC);
+
+    // the text lines written by the root so far must be in the file
+    if (is_root) {
+        fflush(f);
+    }
+    MPI_Barrier(icmb_global_communicator());
+    if (MPI_File_open(icmb_global_communicator(), (char*)output_mpiio_path, MPI_MODE_WRONLY,
+            MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        reprompib_print_error_and_exit("Cannot open output file with MPI-IO");
+    }
+    MPI_File_get_size(fh, &base_offset);
+
+    if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        local_errorcodes = sync_f->get_errorcodes();
+        global_start_sec = (double*) malloc(job.n_rep * sizeof(double));
+        global_end_sec = (double*) malloc(job.n_rep * sizeof(double));
+        sync_f->get_normalized_times(tstart_sec, global_start_sec, job.n_rep);
+        sync_f->get_normalized_times(tend_sec, global_end_sec, job.n_rep);
+    }
+    if (has_model_uncertainties(sync_f)) {
+        local_uncertainties = sync_f->get_uncertainties();
+    }
+
+    // large enough for a text line (or the binary encoding) of each repetition of a chunk
+    buf_size = sizeof(reprompib_bin_header_t) + strlen(call_name)
+            + OUTPUT_NITERATIONS_CHUNK * (strlen(call_name) + 8 * 32);
+    buf = (char*) malloc(buf_size);
+
+    nchunks = job.n_rep/OUTPUT_NITERATIONS_CHUNK + (job.n_rep % OUTPUT_NITERATIONS_CHUNK != 0);
+    for (chunk_id = 0; chunk_id < nchunks; chunk_id++) {
+        long first_rep = chunk_id * OUTPUT_NITERATIONS_CHUNK;
+        int chunk_nrep = OUTPUT_NITERATIONS_CHUNK;
+        double* columns[REPROMPIB_BIN_N_COLUMNS] = { NULL };
+        const int* errorcodes = NULL;
+        reprompib_bin_header_t bin_header;
+        size_t header_size = 0;
+        long long local_size, offset = 0, total_size = 0;
+        MPI_Status status;
+
+        //the last chunk may be smaller than OUTPUT_NITERATIONS_CHUNK
+        if ((chunk_id == nchunks - 1) && (job.n_rep % OUTPUT_NITERATIONS_CHUNK != 0)) {
+            chunk_nrep = job.n_rep % OUTPUT_NITERATIONS_CHUNK;
+        }
+
+        columns[REPROMPIB_BIN_COL_LOC_TSTART] = tstart_sec + first_rep;
+        columns[REPROMPIB_BIN_COL_LOC_TEND] = tend_sec + first_rep;
+        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+            columns[REPROMPIB_BIN_COL_GL_TSTART] = global_start_sec + first_rep;
+            columns[REPROMPIB_BIN_COL_GL_TEND] = global_end_sec + first_rep;
+            errorcodes = local_errorcodes + first_rep;
+        }
+        if (local_uncertainties != NULL) {
+            columns[REPROMPIB_BIN_COL_MODEL_UNC] = local_uncertainties + first_rep;
+        }
+
+        // the root starts a binary chunk with its header and the test name
+        reprompib_init_binary_header(&bin_header, call_name, get_binary_flags(sync_f->clocktype, 1), icmb_global_size(),
+                first_rep, chunk_nrep, msize_value, errorcodes, columns);
+        if (is_root && output_format == REPROMPI_OUTPUT_BINARY) {
+            header_size = sizeof(bin_header) + bin_header.name_length;
+        }
+
+        local_size = format_process_results(buf + header_size, buf_size - header_size, &bin_header, job,
+                msize_value, first_rep, chunk_nrep, columns, errorcodes);
+
+        MPI_Exscan(&local_size, &offset, 1, MPI_LONG_LONG, MPI_SUM, icmb_global_communicator());
+        MPI_Allreduce(&local_size, &total_size, 1, MPI_LONG_LONG, MPI_SUM, icmb_global_communicator());
+        if (is_root) {
+            offset = 0;     // undefined result of MPI_Exscan
+            if (header_size > 0) {
+                bin_header.payload_size = total_size;
+                memcpy(buf, &bin_header, sizeof(bin_header));
+                memcpy(buf + sizeof(bin_header), call_name, bin_header.name_length);
+            }
+        } else {
+            offset += (output_format == REPROMPI_OUTPUT_BINARY) ? sizeof(bin_header) + bin_header.name_length : 0;
+        }
+
+        MPI_File_write_at_all(fh, base_offset + offset, buf, header_size + local_size, MPI_BYTE, &status);
+
+        base_offset += total_size;
+        if (output_format == REPROMPI_OUTPUT_BINARY) {
+            base_offset += sizeof(bin_header) + bin_header.name_length;
+        }
+    }
+
+    MPI_File_close(&fh);
+
+    free(buf);
+    free(global_start_sec);
+    free(global_end_sec);
+}
 
 
 void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
-        int verbose) {
+        const reprompib_sync_functions_t* sync_f, int verbose) {
 
     int i, proc_id;
     double* local_start_sec = NULL;
@@ -200,26 +545,27 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
     int chunk_id, nchunks;
     int current_rep_id, chunk_nrep = 0;
     size_t msize_value;
-#ifdef ENABLE_WINDOWSYNC
     int* errorcodes = NULL;
-#endif
+    double* uncertainties = NULL;
+    double* normalized_start_sec = NULL;
+    double* normalized_end_sec = NULL;
 
-    if (OUTPUT_MSIZE_TYPE == OUTPUT_MSIZE_BYTES) {
-      // print msize in bytes
-      msize_value = job.msize;
-    } else {    // print counts
-      msize_value = job.count;
-    }
+    msize_value = get_msize_value(&job);
 
     if (verbose == 0) {
-        print_runtimes(f, job, tstart_sec, tend_sec, get_errorcodes,
-                get_global_time);
+        print_runtimes(f, job, tstart_sec, tend_sec, sync_f);
+    } else if (output_mpiio_path != NULL) {
+        print_process_results_mpiio(f, job, tstart_sec, tend_sec, sync_f, msize_value);
     } else {
 
         // we gather data from processes in chunks of OUTPUT_NITERATIONS_CHUNK elements
         // the total number of chunks depends on the number of repetitions of the current exp job.n_rep
         nchunks = job.n_rep/OUTPUT_NITERATIONS_CHUNK + (job.n_rep % OUTPUT_NITERATIONS_CHUNK != 0);
 
+        // the timestamps of the caller are left unchanged (they are used after the output)
+        normalized_start_sec = (double*) malloc(OUTPUT_NITERATIONS_CHUNK * sizeof(double));
+        normalized_end_sec = (double*) malloc(OUTPUT_NITERATIONS_CHUNK * sizeof(double));
+
         for (chunk_id = 0; chunk_id < nchunks; chunk_id++) {
             //the last chunk may be smaller than OUTPUT_NITERATIONS_CHUNK
             if ((chunk_id == nchunks - 1) &&
@@ -230,24 +576,28 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
                 chunk_nrep = OUTPUT_NITERATIONS_CHUNK;
             }
 
-#ifdef ENABLE_WINDOWSYNC
-            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
-            {
-              errorcodes = (int*)malloc(chunk_nrep * icmb_global_size() * sizeof(int));
-              for (i = 0; i < chunk_nrep * icmb_global_size(); i++) {
-                errorcodes[i] = 0;
-              }
-            }
-#ifndef ENABLE_BARRIERSYNC	// gather measurement results
-            {
-                int* local_errorcodes = get_errorcodes();
+            if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                int* local_errorcodes = sync_f->get_errorcodes();
 
+                if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+                {
+                  errorcodes = (int*)calloc(chunk_nrep * icmb_global_size(), sizeof(int));
+                }
+                // gather measurement results
                 MPI_Gather(local_errorcodes + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_INT,
                         errorcodes, chunk_nrep, MPI_INT, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
             }
-#endif
 
-#endif
+            if (has_model_uncertainties(sync_f)) {
+                double* local_uncertainties = sync_f->get_uncertainties();
+
+                if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC))
+                {
+                  uncertainties = (double*)calloc(chunk_nrep * icmb_global_size(), sizeof(double));
+                }
+                MPI_Gather(local_uncertainties + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE,
+                        uncertainties, chunk_nrep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
+            }
 
             if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
                 local_start_sec = (double*) malloc(
@@ -267,154 +617,148 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
             MPI_Gather(tend_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, local_end_sec, chunk_nrep,
                     MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
 
-            for (i = 0; i < chunk_nrep; i++) {
-                current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
-                tstart_sec[current_rep_id] = get_global_time(tstart_sec[current_rep_id]);
-                tend_sec[current_rep_id] = get_global_time(tend_sec[current_rep_id]);
-            }
-            MPI_Gather(tstart_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, global_start_sec,
+            sync_f->get_normalized_times(tstart_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), normalized_start_sec, chunk_nrep);
+            sync_f->get_normalized_times(tend_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), normalized_end_sec, chunk_nrep);
+            MPI_Gather(normalized_start_sec, chunk_nrep, MPI_DOUBLE, global_start_sec,
                     chunk_nrep, MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
 
-            MPI_Gather(tend_sec + (chunk_id * OUTPUT_NITERATIONS_CHUNK), chunk_nrep, MPI_DOUBLE, global_end_sec, chunk_nrep,
+            MPI_Gather(normalized_end_sec, chunk_nrep, MPI_DOUBLE, global_end_sec, chunk_nrep,
                     MPI_DOUBLE, icmb_lookup_global_rank(OUTPUT_ROOT_PROC), icmb_global_communicator());
 
-            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
+            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC) && output_format == REPROMPI_OUTPUT_BINARY) {
+                double* columns[REPROMPIB_BIN_N_COLUMNS] = { NULL };
+
+                columns[REPROMPIB_BIN_COL_LOC_TSTART] = local_start_sec;
+                columns[REPROMPIB_BIN_COL_LOC_TEND] = local_end_sec;
+                if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                    columns[REPROMPIB_BIN_COL_GL_TSTART] = global_start_sec;
+                    columns[REPROMPIB_BIN_COL_GL_TEND] = global_end_sec;
+                }
+                columns[REPROMPIB_BIN_COL_MODEL_UNC] = uncertainties;
+                reprompib_write_binary_chunk(f, get_call_from_index(job.call_index), get_binary_flags(sync_f->clocktype, 1),
+                        icmb_global_size(), chunk_id * OUTPUT_NITERATIONS_CHUNK, chunk_nrep, msize_value,
+                        errorcodes, columns);
+            } else if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
 
                 for (proc_id = 0; proc_id < icmb_global_size(); proc_id++) {
                     for (i = 0; i < chunk_nrep; i++) {
                         current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
-#ifdef ENABLE_WINDOWSYNC
-                        fprintf(f, "%7d %50s %10d %12ld %10d %14.10f %14.10f %14.10f %14.10f\n", proc_id,
-                                get_call_from_index(job.call_index), current_rep_id, msize_value,
-                                errorcodes[proc_id * chunk_nrep + i],
-                                local_start_sec[proc_id * chunk_nrep + i],
-                                local_end_sec[proc_id * chunk_nrep + i],
-                                global_start_sec[proc_id * chunk_nrep + i],
-                                global_end_sec[proc_id * chunk_nrep + i]);
-
-#else
-                        fprintf(f, "%7d %50s %10d %12ld %14.10f %14.10f\n", proc_id,
-                                get_call_from_index(job.call_index), current_rep_id, msize_value,
-                                local_start_sec[proc_id * chunk_nrep + i],
-                                local_end_sec[proc_id * chunk_nrep + i]);
-#endif
+                        if (uncertainties != NULL) {
+                            fprintf(f, "%7d %50s %10d %12ld %10d %14.10f %14.10f %14.10f %14.10f %14.10f\n", proc_id,
+                                    get_call_from_index(job.call_index), current_rep_id, msize_value,
+                                    errorcodes[proc_id * chunk_nrep + i],
+                                    local_start_sec[proc_id * chunk_nrep + i],
+                                    local_end_sec[proc_id * chunk_nrep + i],
+                                    global_start_sec[proc_id * chunk_nrep + i],
+                                    global_end_sec[proc_id * chunk_nrep + i],
+                                    uncertainties[proc_id * chunk_nrep + i]);
+                        } else if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+                            fprintf(f, "%7d %50s %10d %12ld %10d %14.10f %14.10f %14.10f %14.10f\n", proc_id,
+                                    get_call_from_index(job.call_index), current_rep_id, msize_value,
+                                    errorcodes[proc_id * chunk_nrep + i],
+                                    local_start_sec[proc_id * chunk_nrep + i],
+                                    local_end_sec[proc_id * chunk_nrep + i],
+                                    global_start_sec[proc_id * chunk_nrep + i],
+                                    global_end_sec[proc_id * chunk_nrep + i]);
+                        } else {
+                            fprintf(f, "%7d %50s %10d %12ld %14.10f %14.10f\n", proc_id,
+                                    get_call_from_index(job.call_index), current_rep_id, msize_value,
+                                    local_start_sec[proc_id * chunk_nrep + i],
+                                    local_end_sec[proc_id * chunk_nrep + i]);
+                        }
                     }
                 }
+            }
 
+            if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
                 free(local_start_sec);
                 free(local_end_sec);
                 free(global_start_sec);
                 free(global_end_sec);
-#ifdef ENABLE_WINDOWSYNC
                 free(errorcodes);
-#endif
+                free(uncertainties);
+                uncertainties = NULL;
             }
 
         }
 
+        free(normalized_start_sec);
+        free(normalized_end_sec);
     }
 }
 
 
 
-void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
-        const int print_summary_methods) {
-
-    double* maxRuntimes_sec;
-    long current_start_index;
-    size_t msize_value;
-#ifdef ENABLE_WINDOWSYNC
-    int i;
+/*
+ * reduces the runtimes in batches of OUTPUT_NITERATIONS_CHUNK repetitions and
+ * adds them to streaming statistics, so the memory of the root does not grow with nrep
+ */
+static void print_streaming_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompib_sync_functions_t* sync_f, const int print_summary_methods) {
+    reprompib_streaming_stats_t stats;
+    double* maxRuntimes_sec = NULL;
     int* sync_errorcodes = NULL;
-#endif
+    int is_root = icmb_has_initiator_rank(OUTPUT_ROOT_PROC);
+    long current_start_index;
 
-    if (OUTPUT_MSIZE_TYPE == OUTPUT_MSIZE_BYTES) {
-      // print msize in bytes
-      msize_value = job.msize;
-    } else {    // print counts
-      msize_value = job.count;
+    if (is_root) {
+        reprompib_init_streaming_stats(&stats);
+        maxRuntimes_sec = (double*) malloc(OUTPUT_NITERATIONS_CHUNK * sizeof(double));
+        sync_errorcodes = (int*) calloc(OUTPUT_NITERATIONS_CHUNK, sizeof(int));
     }
 
+    for (current_start_index = 0; current_start_index < job.n_rep; current_start_index += OUTPUT_NITERATIONS_CHUNK) {
+        long chunk_nrep = job.n_rep - current_start_index;
 
-    maxRuntimes_sec = NULL;
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
-        maxRuntimes_sec = (double*) malloc(job.n_rep * sizeof(double));
+        if (chunk_nrep > OUTPUT_NITERATIONS_CHUNK) {
+            chunk_nrep = OUTPUT_NITERATIONS_CHUNK;
+        }
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job.n_rep * sizeof(int));
-        for (i = 0; i < job.n_rep; i++) {
-            sync_errorcodes[i] = 0;
+        if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+            compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, chunk_nrep, OUTPUT_ROOT_PROC,
+                    sync_f->get_errorcodes, sync_f->get_normalized_times,
+                    maxRuntimes_sec, sync_errorcodes);
+        } else {
+            compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, chunk_nrep, OUTPUT_ROOT_PROC,
+                    maxRuntimes_sec);
+        }
+
+        if (is_root) {
+            reprompib_add_to_streaming_stats(&stats, maxRuntimes_sec, sync_errorcodes, chunk_nrep);
         }
-#endif
     }
 
-    current_start_index = 0;
+    if (is_root) {
+        const double* last_window_sec = NULL;
 
-#ifdef ENABLE_WINDOWSYNC
-    compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            get_errorcodes, get_global_time,
-            maxRuntimes_sec, sync_errorcodes);
-#else
-    compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            maxRuntimes_sec);
-#endif
+        if (has_adaptive_window(sync_f)) {
+            last_window_sec = &sync_f->get_window_sizes()[job.n_rep - 1];
+        }
+        write_summary_line(f, &job, print_summary_methods, NULL, &stats, stats.count, last_window_sec);
 
+        reprompib_free_streaming_stats(&stats);
+        free(maxRuntimes_sec);
+        free(sync_errorcodes);
+    }
+}
 
-    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
-        long nreps = 0;
-
-        // remove measurements with out-of-window errors
-#ifdef ENABLE_WINDOWSYNC
-        for (i = 0; i < job.n_rep; i++) {
-            if (sync_errorcodes[i] == 0) {
-                if (nreps < i) {
-                    maxRuntimes_sec[nreps] = maxRuntimes_sec[i];
-                }
-                nreps++;
-            }
-        }
-#else
-        nreps = job.n_rep;
-#endif
 
-        gsl_sort(maxRuntimes_sec, 1, nreps);
-        fprintf(f, "%50s %12ld %10ld %10ld ", get_call_from_index(job.call_index), msize_value, job.n_rep, nreps);
+void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompib_sync_functions_t* sync_f,
+        const int print_summary_methods) {
+    reprompib_job_results_t results;
 
-        if (print_summary_methods > 0) {
-          int i;
-          for (i=0; i<reprompib_get_number_summary_methods(); i++) {
-            summary_method_info_t* s = reprompib_get_summary_method(i);
+    if (summary_streaming) {
+        print_streaming_summary(f, job, tstart_sec, tend_sec, sync_f, print_summary_methods);
+        return;
+    }
 
-            if (print_summary_methods & s->mask) {
-              double value = 0;
-
-              if (strcmp(s->name, "mean") == 0) {
-                value = gsl_stats_mean(maxRuntimes_sec, 1, nreps);
-              }
-              else if (strcmp(s->name, "median") == 0) {
-                value = gsl_stats_quantile_from_sorted_data (maxRuntimes_sec, 1, nreps, 0.5);
-              }
-              else if (strcmp(s->name, "min") == 0) {
-                if (nreps > 0) {
-                  value = maxRuntimes_sec[0];
-                }
-              }
-              else if (strcmp(s->name, "max") == 0) {
-                if (nreps > 0) {
-                  value = maxRuntimes_sec[nreps-1];
-                }
-              }
-              fprintf(f, "  %.10f ", value);
-            }
-          }
-        }
-        fprintf(f, "\n");
+    reduce_job_results(job, tstart_sec, tend_sec, sync_f, &results);
 
-#ifdef ENABLE_WINDOWSYNC
-        free(sync_errorcodes);
-#endif
+    if (icmb_has_initiator_rank(OUTPUT_ROOT_PROC)) {
+        write_summary(f, &results, print_summary_methods);
 
-        free(maxRuntimes_sec);
+        free(results.sync_errorcodes);
+        free(results.maxRuntimes_sec);
     }
 }
@@ -26,16 +26,43 @@
 
 #include "benchmark_job.h"
 #include "reprompi_bench/sync/synchronization.h"
+#include "reprompi_bench/option_parser/parse_options.h"
+#include "binary_output.h"
 
-void print_results_header(const reprompib_options_t* opts, const char* output_file_path, int verbose);
+// format of the measurement results written to the output file (text by default)
+void set_results_output_format(reprompi_output_format_t format);
+
+// write the measurements of each process (-v) with collective MPI-IO into the given file instead of gathering them
+void set_results_output_mpiio(const char* output_file_path);
+
+// compute the summary from streaming statistics with bounded memory on the root (--streaming-summary)
+void set_results_summary_streaming(int enable);
+
+void print_results_header(const reprompib_options_t* opts, const reprompib_sync_functions_t* sync_f,
+        const char* output_file_path, int verbose);
 
 void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
-		sync_errorcodes_t get_errorcodes,
-		sync_normtime_t get_global_time,
+		const reprompib_sync_functions_t* sync_f,
 		int verbose);
 
+/*
+ * runtimes of a job reduced at the root (sync_errorcodes is unused with local
+ * clocks and windows_sec is NULL without --auto-window)
+ */
+typedef struct {
+    job_t job;
+    reprompi_clock_type_t clocktype;
+    double* maxRuntimes_sec;
+    int* sync_errorcodes;
+    double* windows_sec;
+} reprompib_job_results_t;
+
+// prints reduced results on the root like print_summary and print_measurement_results (without -v)
+void print_job_results(const reprompib_job_results_t* results, const int print_summary_methods,
+        const char* output_file_path);
+
 void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        const reprompib_sync_functions_t* sync_f,
         const int print_summary_methods);
 
 #endif /* RESULTS_OUTPUT_H_ */
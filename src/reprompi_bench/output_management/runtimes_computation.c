@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include "mpi.h"
 
 #include "runtimes_computation.h"
@@ -32,6 +33,65 @@
 
 #include "contrib/intercommunication/intercommunication.h"
 
+static MPI_Datatype rep_bounds_type = MPI_DATATYPE_NULL;
+static MPI_Op rep_bounds_op = MPI_OP_NULL;
+
+static void reduce_rep_bounds(void* invec, void* inoutvec, int* len, MPI_Datatype* dtype) {
+    const reprompib_rep_bounds_t* in = (const reprompib_rep_bounds_t*)invec;
+    reprompib_rep_bounds_t* inout = (reprompib_rep_bounds_t*)inoutvec;
+    int i;
+
+    for (i = 0; i < *len; i++) {
+        if (in[i].start_sec < inout[i].start_sec) {
+            inout[i].start_sec = in[i].start_sec;
+        }
+        if (in[i].end_sec > inout[i].end_sec) {
+            inout[i].end_sec = in[i].end_sec;
+        }
+        if (in[i].errorcode > inout[i].errorcode) {
+            inout[i].errorcode = in[i].errorcode;
+        }
+    }
+}
+
+void reprompib_get_rep_bounds_op(MPI_Datatype* dtype, MPI_Op* op) {
+    if (rep_bounds_type == MPI_DATATYPE_NULL) {
+        int blocklengths[3] = { 1, 1, 1 };
+        MPI_Aint displacements[3] = { offsetof(reprompib_rep_bounds_t, start_sec),
+                offsetof(reprompib_rep_bounds_t, end_sec), offsetof(reprompib_rep_bounds_t, errorcode) };
+        MPI_Datatype types[3] = { MPI_DOUBLE, MPI_DOUBLE, MPI_INT };
+        MPI_Datatype tmp_type;
+
+        MPI_Type_create_struct(3, blocklengths, displacements, types, &tmp_type);
+        // the extent has to include the padding to reduce arrays of the struct
+        MPI_Type_create_resized(tmp_type, 0, sizeof(reprompib_rep_bounds_t), &rep_bounds_type);
+        MPI_Type_commit(&rep_bounds_type);
+        MPI_Type_free(&tmp_type);
+
+        MPI_Op_create(reduce_rep_bounds, 1, &rep_bounds_op);
+    }
+    *dtype = rep_bounds_type;
+    *op = rep_bounds_op;
+}
+
+void reprompib_init_rep_bounds(const double* tstart_sec, const double* tend_sec, const int* errorcodes,
+        long n, sync_normtimes_t get_global_times, reprompib_rep_bounds_t* bounds) {
+    double* norm_sec;
+    long i;
+
+    // normalize the start and end times as two batches, then interleave them
+    norm_sec = (double*)malloc(2 * n * sizeof(double));
+    get_global_times(tstart_sec, norm_sec, n);
+    get_global_times(tend_sec, norm_sec + n, n);
+
+    for (i = 0; i < n; i++) {
+        bounds[i].start_sec = norm_sec[i];
+        bounds[i].end_sec = norm_sec[n + i];
+        bounds[i].errorcode = (errorcodes != NULL) ? errorcodes[i] : 0;
+    }
+    free(norm_sec);
+}
+
 void compute_runtimes_local_clocks(const double* tstart_sec, const double* tend_sec,
         long current_start_index, long current_nreps, int root_proc,
         double* maxRuntimes_sec) {
@@ -57,55 +117,111 @@ void compute_runtimes_local_clocks(const double* tstart_sec, const double* tend_
 
 void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend_sec,
         long current_start_index, long current_nreps, int root_proc,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        sync_errorcodes_t get_errorcodes, sync_normtimes_t get_global_times,
         double* maxRuntimes_sec, int* sync_errorcodes) {
+    reprompib_rep_bounds_t* local_bounds;
+    reprompib_rep_bounds_t* bounds = NULL;
+    MPI_Datatype bounds_type;
+    MPI_Op bounds_op;
+    int i;
 
-    double* start_sec = NULL;
-    double* end_sec = NULL;
-    double* norm_tstart_sec;
-    double* norm_tend_sec;
-    int i, index;
-    int* local_errorcodes;
+    reprompib_get_rep_bounds_op(&bounds_type, &bounds_op);
 
-    // gather error codes in the  [current_start_index, current_start_index + current_nreps) interval
-    local_errorcodes = get_errorcodes() + current_start_index;
+    // normalize results in the  [current_start_index, current_start_index + current_nreps) interval
+    local_bounds = (reprompib_rep_bounds_t*)malloc(current_nreps * sizeof(reprompib_rep_bounds_t));
+    reprompib_init_rep_bounds(tstart_sec + current_start_index, tend_sec + current_start_index,
+            get_errorcodes() + current_start_index, current_nreps, get_global_times, local_bounds);
 
-    MPI_Reduce(local_errorcodes, sync_errorcodes, current_nreps,
-            MPI_INT, MPI_MAX, icmb_lookup_global_rank(root_proc), icmb_global_communicator());
+    if (icmb_has_initiator_rank(root_proc)) {
+        bounds = (reprompib_rep_bounds_t*)malloc(current_nreps * sizeof(reprompib_rep_bounds_t));
+    }
+
+    // reduce start times, end times and error codes at the root process in one pass
+    MPI_Reduce(local_bounds, bounds, current_nreps, bounds_type, bounds_op,
+            icmb_lookup_global_rank(root_proc), icmb_global_communicator());
 
-    if (icmb_has_initiator_rank(root_proc))
-    {
-        start_sec = (double*)malloc(current_nreps * sizeof(double));
-        end_sec = (double*)malloc(current_nreps * sizeof(double));
+    if (icmb_has_initiator_rank(root_proc)) {
+        for (i = 0; i < current_nreps; i++) {
+            maxRuntimes_sec[i] = bounds[i].end_sec - bounds[i].start_sec;
+            sync_errorcodes[i] = bounds[i].errorcode;
+        }
+        free(bounds);
     }
 
-    norm_tstart_sec = (double*)malloc(current_nreps * sizeof(double));
-    norm_tend_sec = (double*)malloc(current_nreps * sizeof(double));
+    free(local_bounds);
+}
 
-    // normalize results in the  [current_start_index, current_start_index + current_nreps) interval
-    for (i = 0; i < current_nreps; i++) {
-        index = i + current_start_index;
-        norm_tstart_sec[i] = get_global_time(tstart_sec[index]);
-        norm_tend_sec[i] = get_global_time(tend_sec[index]);
+
+// MPI_DOUBLE_INT pair for MPI_MINLOC/MPI_MAXLOC
+typedef struct {
+    double value;
+    int rank;
+} double_int_t;
+
+void compute_straggler_ranks(const double* tstart_sec, const double* tend_sec,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtimes_t get_global_times,
+        int* last_ranks, int* first_ranks) {
+    double_int_t* local_end;
+    double_int_t* end = NULL;
+    double_int_t* local_start = NULL;
+    double_int_t* start = NULL;
+    int* sync_errorcodes = NULL;
+    int root = icmb_lookup_global_rank(root_proc);
+    int is_root = icmb_has_initiator_rank(root_proc);
+    int my_rank = icmb_global_rank();
+    int i;
+
+    local_end = (double_int_t*)malloc(current_nreps * sizeof(double_int_t));
+    if (is_root) {
+        end = (double_int_t*)malloc(current_nreps * sizeof(double_int_t));
     }
 
-    // gather results at the root process and compute runtimes
-    MPI_Reduce(norm_tstart_sec, start_sec, current_nreps, MPI_DOUBLE, MPI_MIN, icmb_lookup_global_rank(root_proc), icmb_global_communicator());
-    MPI_Reduce(norm_tend_sec, end_sec, current_nreps, MPI_DOUBLE, MPI_MAX, icmb_lookup_global_rank(root_proc), icmb_global_communicator());
+    if (get_global_times == NULL) {
+        for (i = 0; i < current_nreps; i++) {
+            local_end[i].value = tend_sec[current_start_index + i] - tstart_sec[current_start_index + i];
+            local_end[i].rank = my_rank;
+        }
+        MPI_Reduce(local_end, end, current_nreps, MPI_DOUBLE_INT, MPI_MAXLOC, root, icmb_global_communicator());
+    } else {
+        double* norm_sec = (double*)malloc(2 * current_nreps * sizeof(double));
+
+        get_global_times(tstart_sec + current_start_index, norm_sec, current_nreps);
+        get_global_times(tend_sec + current_start_index, norm_sec + current_nreps, current_nreps);
+
+        local_start = (double_int_t*)malloc(current_nreps * sizeof(double_int_t));
+        for (i = 0; i < current_nreps; i++) {
+            local_start[i].value = norm_sec[i];
+            local_start[i].rank = my_rank;
+            local_end[i].value = norm_sec[current_nreps + i];
+            local_end[i].rank = my_rank;
+        }
+        free(norm_sec);
 
-    if (icmb_has_initiator_rank(root_proc)) {
-        for (i = 0; i< current_nreps; i++) {
-            index = i + current_start_index;
-            maxRuntimes_sec[index] = end_sec[index] - start_sec[index];
+        if (is_root) {
+            start = (double_int_t*)malloc(current_nreps * sizeof(double_int_t));
+            sync_errorcodes = (int*)malloc(current_nreps * sizeof(int));
         }
+        MPI_Reduce(get_errorcodes() + current_start_index, sync_errorcodes, current_nreps,
+                MPI_INT, MPI_MAX, root, icmb_global_communicator());
+        MPI_Reduce(local_start, start, current_nreps, MPI_DOUBLE_INT, MPI_MINLOC, root, icmb_global_communicator());
+        MPI_Reduce(local_end, end, current_nreps, MPI_DOUBLE_INT, MPI_MAXLOC, root, icmb_global_communicator());
+    }
 
+    if (is_root) {
+        for (i = 0; i < current_nreps; i++) {
+            int valid = (sync_errorcodes == NULL || sync_errorcodes[i] == 0);
 
-        free(start_sec);
-        free(end_sec);
+            last_ranks[i] = valid ? end[i].rank : -1;
+            if (start != NULL) {
+                first_ranks[i] = valid ? start[i].rank : -1;
+            }
+        }
     }
 
-    free(norm_tstart_sec);
-    free(norm_tend_sec);
-
+    free(local_end);
+    free(local_start);
+    free(end);
+    free(start);
+    free(sync_errorcodes);
 }
-
@@ -24,16 +24,49 @@
 #ifndef RUNTIMES_COMPUTATION_H_
 #define RUNTIMES_COMPUTATION_H_
 
+#include "mpi.h"
 #include "reprompi_bench/sync/synchronization.h"
 
+// normalized start/end time and sync error code of a repetition
+typedef struct {
+    double start_sec;
+    double end_sec;
+    int errorcode;
+} reprompib_rep_bounds_t;
+
+/*
+ * datatype and operation reducing reprompib_rep_bounds_t elements in a single
+ * pass (minimum start, maximum end and maximum error code); created on first use
+ */
+void reprompib_get_rep_bounds_op(MPI_Datatype* dtype, MPI_Op* op);
+
+/*
+ * fills bounds[i] with the normalized times tstart_sec[i], tend_sec[i] and
+ * errorcodes[i] (0 if errorcodes is NULL)
+ */
+void reprompib_init_rep_bounds(const double* tstart_sec, const double* tend_sec, const int* errorcodes,
+        long n, sync_normtimes_t get_global_times, reprompib_rep_bounds_t* bounds);
+
 void compute_runtimes_local_clocks(const double* tstart_sec, const double* tend_sec,
         long current_start_index, long current_nreps, int root_proc,
         double* maxRuntimes_sec);
 void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend_sec,
         long current_start_index, long current_nreps, int root_proc,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        sync_errorcodes_t get_errorcodes, sync_normtimes_t get_global_times,
         double* maxRuntimes_sec, int* sync_errorcodes);
 
+/*
+ * global rank of the process with the latest end time (last_ranks) and of the
+ * one with the earliest start time (first_ranks) in each repetition, reduced
+ * with MPI_MAXLOC/MPI_MINLOC; -1 for repetitions with a sync error.
+ * With local clocks (get_global_times == NULL), last_ranks holds the process
+ * with the longest runtime and first_ranks is not set.
+ */
+void compute_straggler_ranks(const double* tstart_sec, const double* tend_sec,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtimes_t get_global_times,
+        int* last_ranks, int* first_ranks);
+
 
 
 #endif /* RUNTIMES_COMPUTATION_H_ */
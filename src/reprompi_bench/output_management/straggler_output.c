@@ -0,0 +1,192 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+
+#include "collective_ops/collectives.h"
+#include "runtimes_computation.h"
+#include "straggler_output.h"
+#include "reprompi_bench/utils/node_topology.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+static const int OUTPUT_ROOT_PROC = 0;
+static const int STRAGGLER_NITERATIONS_CHUNK = 3000;
+
+// node of each rank and the node names, only on the root
+static int* rank_nodes = NULL;
+static char* node_names = NULL;
+static int n_nodes = 0;
+
+typedef struct {
+    int id;
+    long count;
+} straggler_count_t;
+
+
+void reprompib_init_straggler_output(void) {
+    reprompib_init_node_topology();
+    n_nodes = reprompib_get_n_nodes();
+    reprompib_gather_node_info(icmb_lookup_global_rank(OUTPUT_ROOT_PROC), &rank_nodes, &node_names);
+}
+
+void reprompib_cleanup_straggler_output(void) {
+    free(rank_nodes);
+    free(node_names);
+    rank_nodes = NULL;
+    node_names = NULL;
+    n_nodes = 0;
+    reprompib_cleanup_node_topology();
+}
+
+
+static int cmp_counts_desc(const void* a, const void* b) {
+    const straggler_count_t* x = (const straggler_count_t*)a;
+    const straggler_count_t* y = (const straggler_count_t*)b;
+
+    if (x->count != y->count) {
+        return (x->count < y->count) ? 1 : -1;
+    }
+    return x->id - y->id;
+}
+
+// prints the non-zero counts of ranks (or nodes), the most frequent first
+static void print_counts(FILE* f, const char* title, const long* counts, int n, int by_node) {
+    straggler_count_t* sorted;
+    int i, n_sorted = 0;
+
+    sorted = (straggler_count_t*)malloc(n * sizeof(straggler_count_t));
+    for (i = 0; i < n; i++) {
+        if (counts[i] > 0) {
+            sorted[n_sorted].id = i;
+            sorted[n_sorted].count = counts[i];
+            n_sorted++;
+        }
+    }
+    qsort(sorted, n_sorted, sizeof(straggler_count_t), cmp_counts_desc);
+
+    fprintf(f, "#   %s (%s):", title, by_node ? "nodes" : "ranks");
+    for (i = 0; i < n_sorted; i++) {
+        if (by_node) {
+            fprintf(f, " %s:%ld", node_names + sorted[i].id * MPI_MAX_PROCESSOR_NAME, sorted[i].count);
+        } else {
+            fprintf(f, " %d:%ld", sorted[i].id, sorted[i].count);
+        }
+    }
+    fprintf(f, "\n");
+    free(sorted);
+}
+
+static void print_straggler_block(FILE* f, job_t job, long nvalid, const long* last_counts,
+        const long* first_counts, reprompi_clock_type_t clocktype) {
+    int nprocs = icmb_global_size();
+    const char* last_title = (clocktype == REPROMPI_CLOCKS_GLOBAL) ? "last to finish" : "longest runtime";
+    long* node_counts;
+    int p;
+
+    node_counts = (long*)calloc(n_nodes, sizeof(long));
+
+    fprintf(f, "# stragglers %s count=%ld valid_nrep=%ld\n", get_call_from_index(job.call_index), (long)job.count, nvalid);
+    print_counts(f, last_title, last_counts, nprocs, 0);
+    for (p = 0; p < nprocs; p++) {
+        node_counts[rank_nodes[p]] += last_counts[p];
+    }
+    print_counts(f, last_title, node_counts, n_nodes, 1);
+
+    if (clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        memset(node_counts, 0, n_nodes * sizeof(long));
+        print_counts(f, "first to start", first_counts, nprocs, 0);
+        for (p = 0; p < nprocs; p++) {
+            node_counts[rank_nodes[p]] += first_counts[p];
+        }
+        print_counts(f, "first to start", node_counts, n_nodes, 1);
+    }
+    free(node_counts);
+}
+
+
+void reprompib_print_stragglers(job_t job, const double* tstart_sec, const double* tend_sec,
+        const reprompib_sync_functions_t* sync_f, const char* output_file_path) {
+    int is_root = icmb_has_initiator_rank(OUTPUT_ROOT_PROC);
+    int nprocs = icmb_global_size();
+    sync_normtimes_t get_global_times = NULL;
+    int* last_ranks = NULL;
+    int* first_ranks = NULL;
+    long* last_counts = NULL;
+    long* first_counts = NULL;
+    long current_start_index, nvalid = 0;
+    long i;
+
+    if (sync_f->clocktype == REPROMPI_CLOCKS_GLOBAL) {
+        get_global_times = sync_f->get_normalized_times;
+    }
+    if (is_root) {
+        last_ranks = (int*)malloc(STRAGGLER_NITERATIONS_CHUNK * sizeof(int));
+        first_ranks = (int*)malloc(STRAGGLER_NITERATIONS_CHUNK * sizeof(int));
+        last_counts = (long*)calloc(nprocs, sizeof(long));
+        first_counts = (long*)calloc(nprocs, sizeof(long));
+    }
+
+    // reduce in chunks, so that the memory of the root does not grow with nrep
+    for (current_start_index = 0; current_start_index < job.n_rep; current_start_index += STRAGGLER_NITERATIONS_CHUNK) {
+        long chunk_nrep = job.n_rep - current_start_index;
+
+        if (chunk_nrep > STRAGGLER_NITERATIONS_CHUNK) {
+            chunk_nrep = STRAGGLER_NITERATIONS_CHUNK;
+        }
+        compute_straggler_ranks(tstart_sec, tend_sec, current_start_index, chunk_nrep, OUTPUT_ROOT_PROC,
+                sync_f->get_errorcodes, get_global_times, last_ranks, first_ranks);
+
+        if (is_root) {
+            for (i = 0; i < chunk_nrep; i++) {
+                if (last_ranks[i] < 0) {
+                    continue;
+                }
+                nvalid++;
+                last_counts[last_ranks[i]]++;
+                if (get_global_times != NULL) {
+                    first_counts[first_ranks[i]]++;
+                }
+            }
+        }
+    }
+
+    if (is_root) {
+        print_straggler_block(stdout, job, nvalid, last_counts, first_counts, sync_f->clocktype);
+        if (output_file_path != NULL) {
+            FILE* f = fopen(output_file_path, "a");
+
+            print_straggler_block(f, job, nvalid, last_counts, first_counts, sync_f->clocktype);
+            fflush(f);
+            fclose(f);
+        }
+
+        free(last_ranks);
+        free(first_ranks);
+        free(last_counts);
+        free(first_counts);
+    }
+}
@@ -0,0 +1,44 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_STRAGGLER_OUTPUT_H_
+#define REPROMPIB_STRAGGLER_OUTPUT_H_
+
+#include "benchmark_job.h"
+#include "reprompi_bench/sync/synchronization.h"
+
+/*
+ * Straggler attribution (--stragglers): for each job, how often each rank
+ * and each node finished last (or had the longest runtime with local clocks)
+ * and started first in the valid repetitions. The counts are printed as "#"
+ * lines to stdout and to the output file.
+ */
+
+// gathers the node of each rank and the node names on the root (collective)
+void reprompib_init_straggler_output(void);
+void reprompib_cleanup_straggler_output(void);
+
+void reprompib_print_stragglers(job_t job, const double* tstart_sec, const double* tend_sec,
+        const reprompib_sync_functions_t* sync_f, const char* output_file_path);
+
+#endif /* REPROMPIB_STRAGGLER_OUTPUT_H_ */
@@ -0,0 +1,253 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "reprompi_bench/misc.h"
+#include "streaming_stats.h"
+
+static const int MIN_LEVEL_CAPACITY = 8;
+
+typedef struct {
+    double value;
+    long weight;
+} weighted_value_t;
+
+
+static int cmp_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_weighted_values(const void* a, const void* b) {
+    return cmp_doubles(&((const weighted_value_t*)a)->value, &((const weighted_value_t*)b)->value);
+}
+
+// the capacity shrinks by 2/3 with each level below the top one
+static int get_level_capacity(const reprompib_streaming_stats_t* stats, int level) {
+    int depth = stats->n_levels - 1 - level;
+    double capacity = REPROMPIB_STATS_SKETCH_K;
+
+    while (depth-- > 0 && capacity > MIN_LEVEL_CAPACITY) {
+        capacity *= 2.0 / 3.0;
+    }
+    return (capacity > MIN_LEVEL_CAPACITY) ? (int)ceil(capacity) : MIN_LEVEL_CAPACITY;
+}
+
+static void push_to_level(reprompib_streaming_stats_t* stats, int level, double value) {
+    if (stats->level_sizes[level] == stats->level_alloc[level]) {
+        int alloc = (stats->level_alloc[level] > 0) ? 2 * stats->level_alloc[level] : MIN_LEVEL_CAPACITY;
+
+        stats->levels[level] = (double*) realloc(stats->levels[level], alloc * sizeof(double));
+        if (stats->levels[level] == NULL) {
+            reprompib_print_error_and_exit("Cannot allocate memory for the summary statistics");
+        }
+        stats->level_alloc[level] = alloc;
+    }
+    stats->levels[level][stats->level_sizes[level]++] = value;
+    stats->sketch_size++;
+}
+
+static void add_level(reprompib_streaming_stats_t* stats) {
+    int level;
+
+    if (stats->n_levels == REPROMPIB_STATS_MAX_LEVELS) {
+        reprompib_print_error_and_exit("Too many values for the summary statistics");
+    }
+    stats->n_levels++;
+
+    stats->sketch_capacity = 0;
+    for (level = 0; level < stats->n_levels; level++) {
+        stats->sketch_capacity += get_level_capacity(stats, level);
+    }
+}
+
+/*
+ * sorts the first level that exceeds its capacity and promotes every other
+ * value to the next level (with twice the weight); the kept half alternates
+ * between compactions, and one value stays if the level has an odd size
+ */
+static void compact_sketch(reprompib_streaming_stats_t* stats) {
+    int level, i, n, first;
+
+    for (level = 0; level < stats->n_levels; level++) {
+        if (stats->level_sizes[level] > get_level_capacity(stats, level)) {
+            break;
+        }
+    }
+    if (level == stats->n_levels) {
+        return;
+    }
+    if (level == stats->n_levels - 1) {
+        add_level(stats);
+    }
+
+    n = stats->level_sizes[level];
+    qsort(stats->levels[level], n, sizeof(double), cmp_doubles);
+
+    first = n % 2;
+    for (i = first + (stats->n_compactions++ % 2); i < n; i += 2) {
+        push_to_level(stats, level + 1, stats->levels[level][i]);
+    }
+    stats->sketch_size -= n - first;
+    stats->level_sizes[level] = first;
+}
+
+static int is_sketch_full(const reprompib_streaming_stats_t* stats) {
+    return stats->sketch_size > stats->sketch_capacity;
+}
+
+
+void reprompib_init_streaming_stats(reprompib_streaming_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    add_level(stats);
+}
+
+void reprompib_free_streaming_stats(reprompib_streaming_stats_t* stats) {
+    int level;
+
+    for (level = 0; level < REPROMPIB_STATS_MAX_LEVELS; level++) {
+        free(stats->levels[level]);
+    }
+    reprompib_init_streaming_stats(stats);
+}
+
+void reprompib_add_to_streaming_stats(reprompib_streaming_stats_t* stats, const double* values,
+        const int* errorcodes, long n) {
+    long i;
+
+    for (i = 0; i < n; i++) {
+        double delta;
+
+        if (errorcodes != NULL && errorcodes[i] != 0) {
+            continue;
+        }
+
+        stats->count++;
+        delta = values[i] - stats->mean;
+        stats->mean += delta / stats->count;
+        stats->m2 += delta * (values[i] - stats->mean);
+        if (stats->count == 1 || values[i] < stats->min) {
+            stats->min = values[i];
+        }
+        if (stats->count == 1 || values[i] > stats->max) {
+            stats->max = values[i];
+        }
+
+        push_to_level(stats, 0, values[i]);
+        if (is_sketch_full(stats)) {
+            compact_sketch(stats);
+        }
+    }
+}
+
+void reprompib_merge_streaming_stats(reprompib_streaming_stats_t* stats, const reprompib_streaming_stats_t* other) {
+    long count;
+    double delta;
+    int level, i;
+
+    if (other->count == 0) {
+        return;
+    }
+
+    count = stats->count + other->count;
+    delta = other->mean - stats->mean;
+    stats->m2 += other->m2 + delta * delta * ((double)stats->count * other->count / count);
+    stats->mean += delta * other->count / count;
+    if (stats->count == 0 || other->min < stats->min) {
+        stats->min = other->min;
+    }
+    if (stats->count == 0 || other->max > stats->max) {
+        stats->max = other->max;
+    }
+    stats->count = count;
+
+    while (stats->n_levels < other->n_levels) {
+        add_level(stats);
+    }
+    for (level = 0; level < other->n_levels; level++) {
+        for (i = 0; i < other->level_sizes[level]; i++) {
+            push_to_level(stats, level, other->levels[level][i]);
+        }
+    }
+    while (is_sketch_full(stats)) {
+        compact_sketch(stats);
+    }
+}
+
+double reprompib_get_streaming_variance(const reprompib_streaming_stats_t* stats) {
+    if (stats->count < 2) {
+        return 0;
+    }
+    return stats->m2 / (stats->count - 1);
+}
+
+double reprompib_get_streaming_quantile(const reprompib_streaming_stats_t* stats, double q) {
+    weighted_value_t* values;
+    long n = 0, cum_weight = 0, lhs;
+    double pos, delta, lhs_value = 0, rhs_value = 0;
+    int level, i;
+
+    if (stats->count == 0) {
+        return 0;
+    }
+    if (q <= 0) {
+        return stats->min;
+    }
+    if (q >= 1) {
+        return stats->max;
+    }
+
+    for (level = 0; level < stats->n_levels; level++) {
+        n += stats->level_sizes[level];
+    }
+    values = (weighted_value_t*) malloc(n * sizeof(weighted_value_t));
+    n = 0;
+    for (level = 0; level < stats->n_levels; level++) {
+        for (i = 0; i < stats->level_sizes[level]; i++) {
+            values[n].value = stats->levels[level][i];
+            values[n].weight = 1L << level;
+            n++;
+        }
+    }
+    qsort(values, n, sizeof(weighted_value_t), cmp_weighted_values);
+
+    // the total weight of the sketch equals the number of values
+    pos = (stats->count - 1) * q;
+    lhs = (long)pos;
+    delta = pos - lhs;
+    for (i = 0; i < n; i++) {
+        cum_weight += values[i].weight;
+        if (cum_weight > lhs) {
+            lhs_value = values[i].value;
+            rhs_value = (cum_weight > lhs + 1 || i == n - 1) ? lhs_value : values[i + 1].value;
+            break;
+        }
+    }
+    free(values);
+
+    return (1 - delta) * lhs_value + delta * rhs_value;
+}
@@ -0,0 +1,73 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_STREAMING_STATS_H_
+#define REPROMPIB_STREAMING_STATS_H_
+
+/*
+ * Streaming statistics of the runtimes of a job (--streaming-summary): the
+ * runtimes are added in batches, without keeping them, and the statistics of
+ * several batches (or processes) can be merged.
+ *   - count, mean and variance (Welford's algorithm)
+ *   - minimum and maximum
+ *   - quantiles from a KLL sketch, exact while at most
+ *     REPROMPIB_STATS_SKETCH_K values were added
+ */
+
+enum {
+    REPROMPIB_STATS_SKETCH_K = 1024,
+    REPROMPIB_STATS_MAX_LEVELS = 48
+};
+
+typedef struct {
+    long count;
+    double mean;
+    double m2;          // sum of squared differences from the mean
+    double min;
+    double max;
+
+    // the values in level h of the sketch stand for 2^h values each
+    int n_levels;
+    int level_sizes[REPROMPIB_STATS_MAX_LEVELS];
+    int level_alloc[REPROMPIB_STATS_MAX_LEVELS];
+    double* levels[REPROMPIB_STATS_MAX_LEVELS];
+    long sketch_size;
+    long sketch_capacity;
+    unsigned long n_compactions;
+} reprompib_streaming_stats_t;
+
+void reprompib_init_streaming_stats(reprompib_streaming_stats_t* stats);
+void reprompib_free_streaming_stats(reprompib_streaming_stats_t* stats);
+
+// adds values[i] for each i with errorcodes[i] == 0 (all values if errorcodes is NULL)
+void reprompib_add_to_streaming_stats(reprompib_streaming_stats_t* stats, const double* values,
+        const int* errorcodes, long n);
+
+void reprompib_merge_streaming_stats(reprompib_streaming_stats_t* stats, const reprompib_streaming_stats_t* other);
+
+double reprompib_get_streaming_variance(const reprompib_streaming_stats_t* stats);
+
+// quantile q in [0,1], interpolated between neighbouring ranks like gsl_stats_quantile_from_sorted_data
+double reprompib_get_streaming_quantile(const reprompib_streaming_stats_t* stats, double q);
+
+#endif /* REPROMPIB_STREAMING_STATS_H_ */
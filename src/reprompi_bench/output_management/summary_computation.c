@@ -0,0 +1,225 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <gsl/gsl_statistics.h>
+#include <gsl/gsl_sort.h>
+
+#include "summary_computation.h"
+
+// share of the values removed at each end for the trimmed mean
+static const double TRIMMED_MEAN_FRACTION = 0.1;
+// standard normal quantile of the 95% confidence interval of the median
+static const double MEDIAN_CI_Z = 1.959964;
+
+static inline void swap_values(double* a, double* b) {
+    double tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+/*
+ * quickselect with a median-of-three pivot; if the partitioning does not
+ * converge after 2*log2(n) steps, the remaining range is sorted instead
+ */
+void reprompib_select(double* data, long n, long k) {
+    long lo = 0, hi = n - 1;
+    int depth_limit = 2 * (int)log2((double)n + 1);
+
+    while (hi > lo) {
+        long i, j, mid;
+        double pivot;
+
+        if (depth_limit-- == 0) {
+            gsl_sort(data + lo, 1, hi - lo + 1);
+            return;
+        }
+
+        mid = lo + (hi - lo) / 2;
+        if (data[mid] < data[lo]) {
+            swap_values(&data[mid], &data[lo]);
+        }
+        if (data[hi] < data[lo]) {
+            swap_values(&data[hi], &data[lo]);
+        }
+        if (data[hi] < data[mid]) {
+            swap_values(&data[hi], &data[mid]);
+        }
+        pivot = data[mid];
+
+        i = lo;
+        j = hi;
+        while (i <= j) {
+            while (data[i] < pivot) {
+                i++;
+            }
+            while (data[j] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                swap_values(&data[i], &data[j]);
+                i++;
+                j--;
+            }
+        }
+
+        // values in (j, i) are equal to the pivot
+        if (k <= j) {
+            hi = j;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            return;
+        }
+    }
+}
+
+// after a selection, the minimum of the values behind data[k] is its successor
+static double get_min(const double* data, long n) {
+    double min = data[0];
+    long i;
+
+    for (i = 1; i < n; i++) {
+        if (data[i] < min) {
+            min = data[i];
+        }
+    }
+    return min;
+}
+
+static double get_max(const double* data, long n) {
+    double max = data[0];
+    long i;
+
+    for (i = 1; i < n; i++) {
+        if (data[i] > max) {
+            max = data[i];
+        }
+    }
+    return max;
+}
+
+double reprompib_select_quantile(double* data, long n, double q) {
+    double index = (n - 1) * q;
+    long lhs = (long)index;
+    double delta = index - lhs;
+
+    if (n == 0) {
+        return 0;
+    }
+
+    reprompib_select(data, n, lhs);
+    if (lhs == n - 1 || delta == 0) {
+        return data[lhs];
+    }
+    return (1 - delta) * data[lhs] + delta * get_min(data + lhs + 1, n - lhs - 1);
+}
+
+// mean without the TRIMMED_MEAN_FRACTION smallest and largest values
+static double compute_trimmed_mean(double* data, long n) {
+    long ntrim = (long)(n * TRIMMED_MEAN_FRACTION);
+    long nkept = n - 2 * ntrim;
+
+    if (ntrim > 0) {
+        reprompib_select(data, n, ntrim);
+        reprompib_select(data + ntrim, n - ntrim, nkept - 1);
+    }
+    return gsl_stats_mean(data + ntrim, 1, nkept);
+}
+
+// median absolute deviation from the median (unscaled)
+static double compute_mad(double* data, long n) {
+    double median = reprompib_select_quantile(data, n, 0.5);
+    double* deviations;
+    double mad;
+    long i;
+
+    deviations = (double*) malloc(n * sizeof(double));
+    for (i = 0; i < n; i++) {
+        deviations[i] = fabs(data[i] - median);
+    }
+    mad = reprompib_select_quantile(deviations, n, 0.5);
+    free(deviations);
+
+    return mad;
+}
+
+/*
+ * distribution-free 95% confidence interval of the median: the order
+ * statistics whose ranks bracket n/2 by MEDIAN_CI_Z * sqrt(n)/2
+ */
+static double compute_median_ci_bound(double* data, long n, int upper) {
+    double half_width = MEDIAN_CI_Z * sqrt((double)n) / 2;
+    long rank;
+
+    if (upper) {
+        rank = (long)ceil(n / 2.0 + half_width);     // 0-based rank of the (rank+1)-th value
+        if (rank > n - 1) {
+            rank = n - 1;
+        }
+    } else {
+        rank = (long)floor(n / 2.0 - half_width) - 1;
+        if (rank < 0) {
+            rank = 0;
+        }
+    }
+    reprompib_select(data, n, rank);
+    return data[rank];
+}
+
+
+double reprompib_compute_summary(const char* method_name, double* data, long n) {
+    if (n == 0) {
+        return 0;
+    }
+
+    if (strcmp(method_name, "mean") == 0) {
+        return gsl_stats_mean(data, 1, n);
+    } else if (strcmp(method_name, "median") == 0) {
+        return reprompib_select_quantile(data, n, 0.5);
+    } else if (strcmp(method_name, "min") == 0) {
+        return get_min(data, n);
+    } else if (strcmp(method_name, "max") == 0) {
+        return get_max(data, n);
+    } else if (strcmp(method_name, "p90") == 0) {
+        return reprompib_select_quantile(data, n, 0.9);
+    } else if (strcmp(method_name, "p99") == 0) {
+        return reprompib_select_quantile(data, n, 0.99);
+    } else if (strcmp(method_name, "p99.9") == 0) {
+        return reprompib_select_quantile(data, n, 0.999);
+    } else if (strcmp(method_name, "trimmed_mean") == 0) {
+        return compute_trimmed_mean(data, n);
+    } else if (strcmp(method_name, "mad") == 0) {
+        return compute_mad(data, n);
+    } else if (strcmp(method_name, "iqr") == 0) {
+        double q1 = reprompib_select_quantile(data, n, 0.25);
+        return reprompib_select_quantile(data, n, 0.75) - q1;
+    } else if (strcmp(method_name, "median_ci_lo") == 0) {
+        return compute_median_ci_bound(data, n, 0);
+    } else if (strcmp(method_name, "median_ci_hi") == 0) {
+        return compute_median_ci_bound(data, n, 1);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_SUMMARY_COMPUTATION_H_
+#define REPROMPIB_SUMMARY_COMPUTATION_H_
+
+/*
+ * Summary methods of --summary computed with selection (introselect) instead
+ * of sorting the runtimes; the functions reorder data.
+ */
+
+// moves the k-th smallest value to data[k], with smaller values before and larger values after it
+void reprompib_select(double* data, long n, long k);
+
+// quantile q in [0,1], interpolated between neighbouring ranks like gsl_stats_quantile_from_sorted_data
+double reprompib_select_quantile(double* data, long n, double q);
+
+/*
+ * value of the summary method with the given name (see reprompib_get_summary_method)
+ * for the n values in data (0 if n is 0)
+ */
+double reprompib_compute_summary(const char* method_name, double* data, long n);
+
+#endif /* REPROMPIB_SUMMARY_COMPUTATION_H_ */
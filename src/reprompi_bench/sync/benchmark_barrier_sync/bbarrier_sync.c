@@ -23,24 +23,143 @@
 </license>
 */
 
+// avoid getsubopt bug
+#define _XOPEN_SOURCE 500
+
 #include "mpi.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <getopt.h>
 
+#include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/utils/node_topology.h"
 #include "bbarrier_sync.h"
 
 #include "contrib/intercommunication/intercommunication.h"
 
+enum {
+    BBARRIER_CACHE_LINE_INTS = 64 / sizeof(int)     /* distance between two flags in shared memory */
+};
+
+// names accepted by --bbarrier-alg (same order as bbarrier_alg_t)
+static char* const bbarrier_alg_names[] = {
+        [BBARRIER_ALG_DISSEMINATION] = "dissemination",
+        [BBARRIER_ALG_TREE] = "tree",
+        [BBARRIER_ALG_TOURNAMENT] = "tournament",
+        [BBARRIER_ALG_BUTTERFLY] = "butterfly",
+        [BBARRIER_ALG_TWO_LEVEL] = "two-level",
+        NULL
+};
+
+static void (* const bbarrier_functions[])(void) = {
+        [BBARRIER_ALG_DISSEMINATION] = dissemination_barrier,
+        [BBARRIER_ALG_TREE] = binomial_tree_barrier,
+        [BBARRIER_ALG_TOURNAMENT] = tournament_barrier,
+        [BBARRIER_ALG_BUTTERFLY] = butterfly_barrier,
+        [BBARRIER_ALG_TWO_LEVEL] = two_level_barrier
+};
+
+static bbarrier_alg_t barrier_alg = BBARRIER_ALG_DISSEMINATION;
+
+// state of the two-level barrier
+typedef struct {
+    int n_users;                /* init calls not yet matched by a cleanup */
+    MPI_Comm node_comm;         /* processes on the same node (shared node topology) */
+    MPI_Comm leader_comm;       /* one leader per node (MPI_COMM_NULL on other processes) */
+    MPI_Win win;
+    volatile int* flags;        /* flag i is the arrival of node rank i, flag 0 the release by the leader */
+    int node_rank;
+    int node_size;
+    int generation;             /* barriers completed so far */
+} two_level_barrier_t;
+
+static two_level_barrier_t two_level = { 0, MPI_COMM_NULL, MPI_COMM_NULL, MPI_WIN_NULL, NULL, 0, 0, 0 };
+
+// set once the synchronization module holds the two-level barrier for the rest of the program
+static int two_level_kept = 0;
+
+
 inline double bbarrier_get_normalized_time(double local_time) {
     return local_time;
 }
 
+void bbarrier_get_normalized_times(const double* local_times, double* global_times, long n) {
+    memcpy(global_times, local_times, n * sizeof(double));
+}
+
+// called at the beginning of MPI_Finalize, while MPI can still be used
+static int free_two_level_at_finalize(MPI_Comm comm, int keyval, void* attribute_val, void* extra_state) {
+    bbarrier_cleanup_two_level();
+    two_level_kept = 0;
+    return MPI_SUCCESS;
+}
+
 void bbarrier_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep) {
+    int keyval;
+
+    barrier_alg = (bbarrier_alg_t)parsed_opts.bbarrier_alg;
+    if (barrier_alg != BBARRIER_ALG_TWO_LEVEL || two_level_kept) {
+        return;
+    }
+    two_level_kept = 1;
+
+    // the shared memory window is kept for all jobs and freed at the end of the program
+    bbarrier_init_two_level();
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, free_two_level_at_finalize, &keyval, NULL);
+    MPI_Comm_set_attr(MPI_COMM_SELF, keyval, NULL);
+    MPI_Comm_free_keyval(&keyval);
+}
+
+int bbarrier_parse_alg(int argc, char **argv, reprompib_sync_options_t* opts_p) {
+    int c;
+    int alg_given = 0;
+
+    optind = 1;
+    optopt = 0;
+    opterr = 0; // ignore invalid options
+    while (1) {
+
+        /* getopt_long stores the option index here. */
+        int option_index = 0;
+
+        c = getopt_long(argc, argv, reprompi_sync_opts_str, reprompi_sync_long_options,
+                &option_index);
+
+        /* Detect the end of the options. */
+        if (c == -1)
+            break;
+
+        switch (c) {
+        case REPROMPI_ARGS_WINSYNC_BBARRIER_ALG: /* barrier algorithm */
+        {
+            char* subopts = optarg;
+            char* value;
+
+            opts_p->bbarrier_alg = getsubopt(&subopts, bbarrier_alg_names, &value);
+            if (opts_p->bbarrier_alg < 0) {
+                reprompib_print_error_and_exit("Unknown barrier algorithm (should be one of dissemination, tree, tournament, butterfly, two-level)");
+            }
+            alg_given = 1;
+            break;
+        }
+
+        case '?':
+            break;
+        }
+    }
+
+    optind = 1;	// reset optind to enable option re-parsing
+    opterr = 1; // reset opterr
+
+    return alg_given;
 }
 
 void bbarrier_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
+    reprompi_init_sync_parameters(opts_p);
+    bbarrier_parse_alg(argc, argv, opts_p);
 }
 
 void bbarrier_init_synchronization(void) {
@@ -48,15 +167,16 @@ void bbarrier_init_synchronization(void) {
 }
 
 
-void dissemination_barrier(void) {
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+static void dissemination_barrier_comm(MPI_Comm comm) {
+    int my_rank, np;
     int send_rank, recv_rank;
     int i, nrounds;
     MPI_Status status;
     int send_value = 1;
     int recv_value = 1;
 
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
     nrounds = ceil(log2((double) np));
 
     for (i = 0; i < nrounds; i++) {
@@ -66,16 +186,203 @@ void dissemination_barrier(void) {
         //printf("[%d] Sending from %d to %d; receive from %d\n", i, my_rank, send_rank, recv_rank);
         MPI_Sendrecv(&send_value, 1, MPI_INT, send_rank, 0,
                 &recv_value, 1, MPI_INT, recv_rank, 0,
-                icmb_global_communicator(), &status);
+                comm, &status);
+    }
+}
+
+
+void dissemination_barrier(void) {
+    dissemination_barrier_comm(icmb_global_communicator());
+}
+
+
+/*
+ * arrival phase of the binomial tree (or tournament): in round k, rank r
+ * with r mod 2^(k+1) == 2^k reports to r - 2^k and leaves, so that rank 0
+ * knows that all processes have arrived
+ *
+ * returns the round in which the process reported to its parent
+ * (the number of rounds for rank 0)
+ */
+static int binomial_arrival(MPI_Comm comm, int my_rank, int np) {
+    int value = 1;
+    int round = 0;
+
+    while ((1 << round) < np) {
+        if (my_rank & (1 << round)) {
+            MPI_Send(&value, 1, MPI_INT, my_rank - (1 << round), 0, comm);
+            break;
+        }
+        if (my_rank + (1 << round) < np) {
+            MPI_Recv(&value, 1, MPI_INT, my_rank + (1 << round), 0, comm, MPI_STATUS_IGNORE);
+        }
+        round++;
     }
+    return round;
+}
+
 
+void binomial_tree_barrier(void) {
+    MPI_Comm comm = icmb_global_communicator();
+    int my_rank = icmb_global_rank();
+    int np = icmb_global_size();
+    int value = 1;
+
+    binomial_arrival(comm, my_rank, np);
+
+    // release all processes with the broadcast of the MPI library
+    MPI_Bcast(&value, 1, MPI_INT, 0, comm);
+}
+
+
+void tournament_barrier(void) {
+    MPI_Comm comm = icmb_global_communicator();
+    int my_rank = icmb_global_rank();
+    int np = icmb_global_size();
+    int value = 1;
+    int lost_round, round;
+
+    lost_round = binomial_arrival(comm, my_rank, np);
+
+    // wake-up: wait for the winner of the lost match, then wake up
+    // the processes beaten in the previous rounds (latest match first)
+    if (my_rank != 0) {
+        MPI_Recv(&value, 1, MPI_INT, my_rank - (1 << lost_round), 0, comm, MPI_STATUS_IGNORE);
+    }
+    for (round = lost_round - 1; round >= 0; round--) {
+        if (my_rank + (1 << round) < np) {
+            MPI_Send(&value, 1, MPI_INT, my_rank + (1 << round), 0, comm);
+        }
+    }
+}
+
+
+void butterfly_barrier(void) {
+    MPI_Comm comm = icmb_global_communicator();
+    int my_rank = icmb_global_rank();
+    int np = icmb_global_size();
+    int send_value = 1;
+    int recv_value = 1;
+    int pof2, mask;
+
+    pof2 = 1;
+    while (pof2 * 2 <= np) {
+        pof2 *= 2;
+    }
+
+    // processes beyond the largest power of two are represented by a partner
+    if (my_rank >= pof2) {
+        MPI_Send(&send_value, 1, MPI_INT, my_rank - pof2, 0, comm);
+        MPI_Recv(&recv_value, 1, MPI_INT, my_rank - pof2, 0, comm, MPI_STATUS_IGNORE);
+        return;
+    }
+    if (my_rank + pof2 < np) {
+        MPI_Recv(&recv_value, 1, MPI_INT, my_rank + pof2, 0, comm, MPI_STATUS_IGNORE);
+    }
+
+    for (mask = 1; mask < pof2; mask <<= 1) {
+        MPI_Sendrecv(&send_value, 1, MPI_INT, my_rank ^ mask, 0,
+                &recv_value, 1, MPI_INT, my_rank ^ mask, 0,
+                comm, MPI_STATUS_IGNORE);
+    }
+
+    if (my_rank + pof2 < np) {
+        MPI_Send(&send_value, 1, MPI_INT, my_rank + pof2, 0, comm);
+    }
+}
+
+
+void bbarrier_init_two_level(void) {
+    int* base;
+    MPI_Aint size;
+    int disp_unit;
+
+    if (two_level.n_users++ > 0) {
+        return;
+    }
+
+    reprompib_init_node_topology();
+    two_level.node_comm = reprompib_get_node_comm();
+    two_level.leader_comm = reprompib_get_leader_comm();
+    MPI_Comm_rank(two_level.node_comm, &two_level.node_rank);
+    MPI_Comm_size(two_level.node_comm, &two_level.node_size);
+
+    // the leader allocates one cache line per process of the node
+    size = (two_level.node_rank == 0) ? two_level.node_size * BBARRIER_CACHE_LINE_INTS * sizeof(int) : 0;
+    MPI_Win_allocate_shared(size, sizeof(int), MPI_INFO_NULL, two_level.node_comm,
+            &base, &two_level.win);
+    MPI_Win_shared_query(two_level.win, 0, &size, &disp_unit, &base);
+    two_level.flags = base;
+    two_level.generation = 0;
+
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, two_level.win);
+    if (two_level.node_rank == 0) {
+        int i;
+        for (i = 0; i < two_level.node_size; i++) {
+            two_level.flags[i * BBARRIER_CACHE_LINE_INTS] = 0;
+        }
+        MPI_Win_sync(two_level.win);
+    }
+    MPI_Barrier(two_level.node_comm);
+}
+
+
+void bbarrier_cleanup_two_level(void) {
+    if (two_level.n_users == 0 || --two_level.n_users > 0) {
+        return;
+    }
+
+    MPI_Win_unlock_all(two_level.win);
+    MPI_Win_free(&two_level.win);
+    two_level.flags = NULL;
+    two_level.node_comm = MPI_COMM_NULL;
+    two_level.leader_comm = MPI_COMM_NULL;
+    reprompib_cleanup_node_topology();
+}
+
+
+/*
+ * the processes of a node report to their leader through shared memory,
+ * the leaders synchronize with a dissemination barrier, and each leader
+ * releases the processes of its node through shared memory
+ */
+void two_level_barrier(void) {
+    volatile int* flags;
+    int generation;
+    int i;
+
+    if (two_level.n_users == 0) {
+        reprompib_print_error_and_exit("The two-level barrier has not been initialized");
+    }
+    flags = two_level.flags;
+    generation = ++two_level.generation;
+
+    if (two_level.node_rank == 0) {
+        for (i = 1; i < two_level.node_size; i++) {
+            while (flags[i * BBARRIER_CACHE_LINE_INTS] != generation) {
+                MPI_Win_sync(two_level.win);
+            }
+        }
+        dissemination_barrier_comm(two_level.leader_comm);
+
+        flags[0] = generation;
+        MPI_Win_sync(two_level.win);
+    }
+    else {
+        flags[two_level.node_rank * BBARRIER_CACHE_LINE_INTS] = generation;
+        MPI_Win_sync(two_level.win);
+
+        while (flags[0] != generation) {
+            MPI_Win_sync(two_level.win);
+        }
+    }
 }
 
 
 void bbarrier_start_synchronization(void) {
-    dissemination_barrier();
+    bbarrier_functions[barrier_alg]();
 #ifdef ENABLE_DOUBLE_BARRIER
-    dissemination_barrier();
+    bbarrier_functions[barrier_alg]();
 #endif
 }
 
@@ -87,8 +394,8 @@ void bbarrier_cleanup_synchronization_module(void) {
 
 void bbarrier_print_sync_parameters(FILE* f) {
     fprintf(f, "#@sync=BBarrier\n");
+    fprintf(f, "#@bbarrier_alg=%s\n", bbarrier_alg_names[barrier_alg]);
 #ifdef ENABLE_DOUBLE_BARRIER
     fprintf(f, "#@doublebarrier=true\n");
 #endif
 }
-
@@ -26,8 +26,19 @@
 
 #include "reprompi_bench/sync/sync_info.h"
 
+typedef enum {
+    BBARRIER_ALG_DISSEMINATION = 0,
+    BBARRIER_ALG_TREE,          /* binomial tree, released with MPI_Bcast */
+    BBARRIER_ALG_TOURNAMENT,
+    BBARRIER_ALG_BUTTERFLY,
+    BBARRIER_ALG_TWO_LEVEL      /* shared memory within a node, dissemination between nodes */
+} bbarrier_alg_t;
+
 void bbarrier_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
 void bbarrier_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p);
+
+// parses --bbarrier-alg only (keeps the other options); returns 1 if it was given
+int bbarrier_parse_alg(int argc, char **argv, reprompib_sync_options_t* opts_p);
 void bbarrier_init_synchronization(void);
 void bbarrier_start_synchronization(void);
 void bbarrier_stop_synchronization(void);
@@ -36,9 +47,22 @@ void bbarrier_cleanup_synchronization_module(void);
 int* bbarrier_get_local_sync_errorcodes(void);
 
 double bbarrier_get_normalized_time(double local_time);
+void bbarrier_get_normalized_times(const double* local_times, double* global_times, long n);
 
 void bbarrier_print_sync_parameters(FILE* f);
 
 void dissemination_barrier(void);
+void binomial_tree_barrier(void);
+void tournament_barrier(void);
+void butterfly_barrier(void);
+
+/*
+ * the two-level barrier needs a node communicator and a shared memory window,
+ * which are created by the first init call (collective on the global communicator)
+ * and freed by the matching cleanup call
+ */
+void bbarrier_init_two_level(void);
+void bbarrier_cleanup_two_level(void);
+void two_level_barrier(void);
 
 #endif /* BBARRIER_SYNC_H_ */
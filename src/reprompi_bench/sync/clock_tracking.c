@@ -0,0 +1,202 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+ *
+ * Copyright (c) 2021 Stefan Christians
+ *
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "mpi.h"
+
+#include "reprompi_bench/misc.h"
+#include "clock_tracking.h"
+#include "sync_topology.h"
+
+/*
+ * Online tracking of a linear clock model
+ *      offset(x) = intercept + slope * x
+ * (x is the local time) with a recursive least-squares estimator.
+ * The state is (offset at x_ref, slope) and its covariance P. Every
+ * offset measurement is weighted by its error bound (half the RTT of the
+ * exchange). The covariance is inflated by 1/lambda per update, so that
+ * older measurements are gradually forgotten and the model can follow a
+ * drift that is not linear over the whole run.
+ */
+
+static const double CLOCK_TRACKING_LAMBDA = 0.98;               /* forgetting factor */
+static const double CLOCK_TRACKING_PRIOR_OFFSET_SEC = 1e-6;     /* std. dev. of the learned offset */
+static const double CLOCK_TRACKING_PRIOR_SLOPE = 1e-6;          /* std. dev. of the learned slope */
+
+enum {
+    CLOCK_TRACKING_N_EXCHANGES = 3,     /* timestamp exchanges per measurement (the fastest is used) */
+    CLOCK_TRACKING_TAG = 44
+};
+
+
+void reprompi_clock_tracker_init(reprompi_clock_tracker_t* tracker, const double intercept,
+        const double slope, const double x_ref) {
+    tracker->x_ref = x_ref;
+    tracker->offset = intercept + slope * x_ref;
+    tracker->slope = slope;
+
+    tracker->P[0][0] = CLOCK_TRACKING_PRIOR_OFFSET_SEC * CLOCK_TRACKING_PRIOR_OFFSET_SEC;
+    tracker->P[0][1] = 0;
+    tracker->P[1][0] = 0;
+    tracker->P[1][1] = CLOCK_TRACKING_PRIOR_SLOPE * CLOCK_TRACKING_PRIOR_SLOPE;
+    tracker->n_updates = 0;
+
+    // the learned model is valid from the beginning of the job
+    tracker->n_segments = 0;
+    reprompi_clock_tracker_add_segment(tracker, -HUGE_VAL);
+}
+
+
+void reprompi_clock_tracker_cleanup(reprompi_clock_tracker_t* tracker) {
+    free(tracker->segments);
+    tracker->segments = NULL;
+    tracker->n_segments = 0;
+    tracker->max_segments = 0;
+}
+
+
+void reprompi_clock_tracker_get_model(const reprompi_clock_tracker_t* tracker,
+        double* intercept, double* slope) {
+    *slope = tracker->slope;
+    *intercept = tracker->offset - tracker->slope * tracker->x_ref;
+}
+
+
+void reprompi_clock_tracker_add_segment(reprompi_clock_tracker_t* tracker, const double valid_from) {
+    reprompi_clock_model_segment_t* segment;
+
+    if (tracker->n_segments == tracker->max_segments) {
+        tracker->max_segments = (tracker->max_segments == 0) ? 16 : 2 * tracker->max_segments;
+        tracker->segments = (reprompi_clock_model_segment_t*) realloc(tracker->segments,
+                tracker->max_segments * sizeof(reprompi_clock_model_segment_t));
+    }
+
+    segment = &(tracker->segments[tracker->n_segments]);
+    segment->valid_from = valid_from;
+    reprompi_clock_tracker_get_model(tracker, &(segment->intercept), &(segment->slope));
+    tracker->n_segments++;
+}
+
+
+void reprompi_clock_tracker_update(reprompi_clock_tracker_t* tracker, const double x,
+        const double offset, const double error_bound) {
+    double phi[2], Pphi[2], K[2];
+    double s, e, r;
+    int i, j;
+
+    phi[0] = 1;
+    phi[1] = x - tracker->x_ref;
+
+    // measurement variance of an error uniformly distributed in [-error_bound, error_bound]
+    r = error_bound * error_bound / 3.0;
+
+    for (i = 0; i < 2; i++) {
+        Pphi[i] = tracker->P[i][0] * phi[0] + tracker->P[i][1] * phi[1];
+    }
+    s = phi[0] * Pphi[0] + phi[1] * Pphi[1] + r;
+
+    e = offset - (tracker->offset + tracker->slope * phi[1]);
+    for (i = 0; i < 2; i++) {
+        K[i] = Pphi[i] / s;
+    }
+    tracker->offset += K[0] * e;
+    tracker->slope += K[1] * e;
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < 2; j++) {
+            tracker->P[i][j] = (tracker->P[i][j] - K[i] * Pphi[j]) / CLOCK_TRACKING_LAMBDA;
+        }
+    }
+    tracker->n_updates++;
+
+    reprompi_clock_tracker_add_segment(tracker, x);
+}
+
+
+double reprompi_clock_tracker_uncertainty(const reprompi_clock_tracker_t* tracker, const double x) {
+    double dx = x - tracker->x_ref;
+    double var;
+
+    var = tracker->P[0][0] + 2 * dx * tracker->P[0][1] + dx * dx * tracker->P[1][1];
+    return sqrt(repro_max(var, 0));
+}
+
+
+void reprompi_clock_tracker_model_at(const reprompi_clock_tracker_t* tracker, const double x,
+        double* intercept, double* slope) {
+    int low = 0, high = tracker->n_segments - 1, mid;
+
+    // last segment that starts at or before x (most timestamps fall into the last one)
+    if (x < tracker->segments[high].valid_from) {
+        while (low < high) {
+            mid = (low + high + 1) / 2;
+            if (tracker->segments[mid].valid_from <= x) {
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+    }
+    *intercept = tracker->segments[high].intercept;
+    *slope = tracker->segments[high].slope;
+}
+
+
+int reprompi_clock_tracker_measure_offset(const int root, const int client,
+        double (*get_time_f)(void), double* x, double* offset, double* error_bound) {
+    int my_rank = reprompi_sync_rank();
+    int i;
+    double t_send, t_recv, t_root, rtt;
+    MPI_Status status;
+
+    if (my_rank == root) {
+        for (i = 0; i < CLOCK_TRACKING_N_EXCHANGES; i++) {
+            MPI_Recv(&t_root, 1, MPI_DOUBLE, client, CLOCK_TRACKING_TAG, reprompi_sync_comm(), &status);
+            t_root = get_time_f();
+            MPI_Send(&t_root, 1, MPI_DOUBLE, client, CLOCK_TRACKING_TAG, reprompi_sync_comm());
+        }
+    }
+    else if (my_rank == client) {
+        *error_bound = HUGE_VAL;
+        for (i = 0; i < CLOCK_TRACKING_N_EXCHANGES; i++) {
+            t_send = get_time_f();
+            MPI_Send(&t_send, 1, MPI_DOUBLE, root, CLOCK_TRACKING_TAG, reprompi_sync_comm());
+            MPI_Recv(&t_root, 1, MPI_DOUBLE, root, CLOCK_TRACKING_TAG, reprompi_sync_comm(), &status);
+            t_recv = get_time_f();
+
+            rtt = t_recv - t_send;
+            if (rtt / 2.0 < *error_bound) {
+                *x = (t_send + t_recv) / 2.0;
+                *offset = *x - t_root;
+                *error_bound = rtt / 2.0;
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_CLOCK_TRACKING_H_
+#define REPROMPIB_CLOCK_TRACKING_H_
+
+typedef struct {
+    double valid_from;      /* local time from which the model was used */
+    double intercept;
+    double slope;
+} reprompi_clock_model_segment_t;
+
+typedef struct {
+    double x_ref;           /* local time at which the tracked model was initialized */
+    double offset;          /* estimated offset at x_ref */
+    double slope;
+    double P[2][2];         /* covariance of (offset, slope) */
+    long n_updates;
+
+    reprompi_clock_model_segment_t* segments;  /* models used during the current job */
+    int n_segments;
+    int max_segments;
+} reprompi_clock_tracker_t;
+
+/*
+ * starts tracking the given model of the offset to the root (offset = intercept + slope * local_time);
+ * the tracker has to be zero-initialized before its first use
+ */
+void reprompi_clock_tracker_init(reprompi_clock_tracker_t* tracker, const double intercept,
+        const double slope, const double x_ref);
+void reprompi_clock_tracker_cleanup(reprompi_clock_tracker_t* tracker);
+
+/* updates the model with an offset measured at local time x, accurate to +/- error_bound */
+void reprompi_clock_tracker_update(reprompi_clock_tracker_t* tracker, const double x,
+        const double offset, const double error_bound);
+void reprompi_clock_tracker_add_segment(reprompi_clock_tracker_t* tracker, const double valid_from);
+
+void reprompi_clock_tracker_get_model(const reprompi_clock_tracker_t* tracker,
+        double* intercept, double* slope);
+
+/* model that was in use at local time x (used to normalize timestamps after the measurements) */
+void reprompi_clock_tracker_model_at(const reprompi_clock_tracker_t* tracker, const double x,
+        double* intercept, double* slope);
+
+/* standard deviation of the offset predicted for local time x */
+double reprompi_clock_tracker_uncertainty(const reprompi_clock_tracker_t* tracker, const double x);
+
+/*
+ * a few timestamp exchanges between root and client (on the synchronization
+ * communicator); returns 1 on the client, which gets the measured offset
+ */
+int reprompi_clock_tracker_measure_offset(const int root, const int client,
+        double (*get_time_f)(void), double* x, double* offset, double* error_bound);
+
+#endif /* REPROMPIB_CLOCK_TRACKING_H_ */
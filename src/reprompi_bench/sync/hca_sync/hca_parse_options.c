@@ -72,6 +72,22 @@ void hca_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p)
             opts_p->wait_time_sec = atof(optarg) * 1e-6;
             break;
 
+        case REPROMPI_ARGS_WINSYNC_HCA_DRIFT_BOUND: /* maximum residual offset before re-learning the model (in usec) */
+            opts_p->hca_drift_bound_sec = atof(optarg) * 1e-6;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_NODE_LEADERS: /* only one process per node learns the clock model */
+            opts_p->node_leaders_only = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_CLOCK_TRACKING: /* repetitions between two online updates of the clock model */
+            opts_p->clock_tracking_interval = atoi(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_AUTO_WINDOW: /* repetitions between two adaptations of the window size */
+            opts_p->auto_window_batch = atoi(optarg);
+            break;
+
         case '?':
              break;
         }
@@ -90,6 +106,18 @@ void hca_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p)
     if (opts_p->n_exchanges <= 0) {
       reprompib_print_error_and_exit("Invalid number of ping-pong exchanges (should be a positive integer)");
     }
+    if (opts_p->clock_tracking_interval < 0) {
+      reprompib_print_error_and_exit("Invalid clock tracking interval (should be a positive number of repetitions, or 0 to disable tracking)");
+    }
+    if (opts_p->clock_tracking_interval > 0 && opts_p->node_leaders_only) {
+      reprompib_print_error_and_exit("Online clock tracking cannot be combined with node-leader synchronization");
+    }
+    if (opts_p->hca_drift_bound_sec < 0) {
+      reprompib_print_error_and_exit("Invalid HCA drift bound (should be positive, or 0 to re-learn the clock model for every job)");
+    }
+    if (opts_p->auto_window_batch < 0) {
+      reprompib_print_error_and_exit("Invalid window adaptation batch (should be a positive number of repetitions, or 0 for a fixed window)");
+    }
 
 
     optind = 1;	// reset optind to enable option re-parsing
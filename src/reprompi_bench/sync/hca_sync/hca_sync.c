@@ -37,6 +37,9 @@
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/time_measurement.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/sync_topology.h"
+#include "reprompi_bench/sync/clock_tracking.h"
+#include "reprompi_bench/sync/window_adaptation.h"
 #include "hca_parse_options.h"
 #include "hca_sync.h"
 
@@ -64,6 +67,30 @@ typedef struct {
 
 lm_t lm;
 
+// model reuse across jobs (enabled with --hca-drift-bound)
+static int model_is_valid = 0;      /* a model has been learned and can be checked instead of re-learned */
+
+typedef struct {
+    long n_sync_calls;      /* calls to hca_synchronize_clocks */
+    long n_learns;          /* calls that (re-)learned the clock models */
+    long n_checks;          /* calls that checked the drift of the previous model */
+    double learn_time_sec;  /* total time spent learning models */
+    double check_time_sec;  /* total time spent checking the drift */
+    double max_residual_sec; /* largest residual offset measured by a check */
+} hca_model_stats_t;
+
+static hca_model_stats_t model_stats;
+
+// online tracking of the clock model (enabled with --clock-tracking)
+static reprompi_clock_tracker_t tracker;
+static double* uncertainty = NULL;         /* uncertainty of the clock model for each repetition */
+static long tracking_update_index = 0;     /* selects the process updating its model */
+static long n_tracking_updates = 0;        /* offset measurements served by the master */
+
+// adaptive window size (enabled with --auto-window)
+static reprompi_window_adapter_t window_adapter;
+static double window_entry_time = 0;   /* global time at which the current measurement started */
+
 
 
 enum {
@@ -71,6 +98,10 @@ enum {
     Minimum_ping_pongs1 = 8
 };
 
+enum {
+    HCA_N_REFERENCE_RANKS = 4   /* ranks checked for drift before re-using the clock model */
+};
+
 
 inline double hca_get_adjusted_time(void) {
     return get_time() - initial_timestamp;
@@ -89,22 +120,50 @@ inline static lm_t merge_linear_models(lm_t lm1, lm_t lm2) {
     return new_model;
 }
 
-static double ping_pong_skampi(int p1, int p2)
+/*
+ * minimum ping-pong time to each process, kept across jobs and re-synchronizations
+ * (negative if not yet determined), so that later ping-pongs can stop early
+ * if the RTT stays within 110% of the minimum
+ */
+static double *ping_pong_min_time = NULL;
+static int ping_pong_cache_size = 0;
+
+enum {
+    PP_CALLS = 0,           /* ping_pong_skampi calls */
+    PP_CACHE_HITS,          /* calls with a known minimum ping-pong time */
+    PP_EXCHANGES,           /* ping-pong exchanges performed */
+    PP_N_COUNTERS
+};
+static long pp_counters[PP_N_COUNTERS];        /* counted by p1 during the current synchronization */
+static long pp_total_counters[PP_N_COUNTERS];  /* summed over all synchronizations and processes (on the master) */
+
+static void init_ping_pong_cache(int np)
+{
+    int i;
+
+    if (ping_pong_cache_size == np) {
+        return;
+    }
+    free(ping_pong_min_time);
+    ping_pong_min_time = (double*)malloc(np * sizeof(double));
+    for( i = 0; i < np; i++) ping_pong_min_time[i] = -1.0;
+    ping_pong_cache_size = np;
+}
+
+static double ping_pong_skampi(int p1, int p2, double (*get_time_f)(void))
 {
     int i, other_global_id;
     double s_now, s_last, t_last, t_now;
     double td_min, td_max;
     double invalid_time = -1.0;
     MPI_Status status;
-    static double *ping_pong_min_time;
     int pp_tag = 43;
     double offset = 0;
 
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
 
-    ping_pong_min_time = (double*)malloc(np * sizeof(double));
-    for( i = 0; i < np; i++) ping_pong_min_time[i] = -1.0;
+    init_ping_pong_cache(np);
 
 
     /* I had to unroll the main loop because I didn't find a portable way
@@ -112,11 +171,11 @@ static double ping_pong_skampi(int p1, int p2)
     if( my_rank == p1 ) {
         other_global_id = p2;
 
-        s_last = hca_get_adjusted_time();
-        MPI_Send(&s_last, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
-        MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator(), &status);
-        s_now = hca_get_adjusted_time();
-        MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
+        s_last = get_time_f();
+        MPI_Send(&s_last, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
+        MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm(), &status);
+        s_now = get_time_f();
+        MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
 
 
         td_min = t_last - s_now;
@@ -126,11 +185,11 @@ static double ping_pong_skampi(int p1, int p2)
     } else {
         other_global_id = p1;
 
-        MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator(), &status);
-        t_last = hca_get_adjusted_time();
-        MPI_Send(&t_last, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator());
-        MPI_Recv(&s_now, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator(), &status);
-        t_now = hca_get_adjusted_time();
+        MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm(), &status);
+        t_last = get_time_f();
+        MPI_Send(&t_last, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm());
+        MPI_Recv(&s_now, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm(), &status);
+        t_now = get_time_f();
 
 
         td_min = s_last - t_last;
@@ -144,11 +203,11 @@ static double ping_pong_skampi(int p1, int p2)
         i = 1;
         while( 1 ) {
 
-            MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator(), &status);
+            MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm(), &status);
             if( t_last < 0.0 ) break;
 
             s_last = s_now;
-            s_now = hca_get_adjusted_time();
+            s_now = get_time_f();
 
             td_min = repro_max(td_min, t_last - s_now);
             td_max = repro_min(td_max, t_last - s_last);
@@ -156,24 +215,24 @@ static double ping_pong_skampi(int p1, int p2)
             if( ping_pong_min_time[other_global_id] >= 0.0  &&
                     i >= Minimum_ping_pongs1 &&
                     s_now - s_last < ping_pong_min_time[other_global_id]*1.10 ) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
+                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
                 break;
             }
             i++;
             if( i == Number_ping_pongs1 ) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
+                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
                 break;
             }
-            MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
+            MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
 
         }
     } else {
         i = 1;
         while( 1 ) {
-            MPI_Send(&t_now, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator());
-            MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator(), &status);
+            MPI_Send(&t_now, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm());
+            MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm(), &status);
             t_last = t_now;
-            t_now = hca_get_adjusted_time();
+            t_now = get_time_f();
 
             if( s_last < 0.0 ) break;
 
@@ -183,13 +242,21 @@ static double ping_pong_skampi(int p1, int p2)
             if( ping_pong_min_time[other_global_id] >= 0.0 &&
                     i >= Minimum_ping_pongs1 &&
                     t_now - t_last < ping_pong_min_time[other_global_id]*1.10 ) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator());
+                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm());
                 break;
             }
             i++;
         }
     }
 
+    if( my_rank == p1 ) {
+        pp_counters[PP_CALLS]++;
+        pp_counters[PP_EXCHANGES] += i;
+        if( ping_pong_min_time[other_global_id] >= 0.0 ) {
+            pp_counters[PP_CACHE_HITS]++;
+        }
+    }
+
     if( ping_pong_min_time[other_global_id] < 0.0) {
         ping_pong_min_time[other_global_id] = td_max-td_min;
     }
@@ -198,24 +265,22 @@ static double ping_pong_skampi(int p1, int p2)
     }
     offset = (td_min+td_max)/2.0;
 
-    free(ping_pong_min_time);
-
     return offset;
 }
 
 
 
 void compute_and_set_intercept(lm_t* lm, int client, int p_ref) {
-    int my_rank = icmb_global_rank();
+    int my_rank = reprompi_sync_rank();
 
     if (my_rank == p_ref) {
         //compute intercept with SKaMPI ping-pong
-        ping_pong_skampi(my_rank, client);
+        ping_pong_skampi(my_rank, client, hca_get_adjusted_time);
     } else
         if (my_rank == client) {
             //compute intercept with SKaMPI ping-pong
             double intercept_time;
-            double offset = -ping_pong_skampi(p_ref, my_rank);
+            double offset = -ping_pong_skampi(p_ref, my_rank, hca_get_adjusted_time);
 
             intercept_time = hca_get_adjusted_time();
             lm->intercept = (lm->slope) * (-intercept_time) + offset;
@@ -225,8 +290,8 @@ void compute_and_set_intercept(lm_t* lm, int client, int p_ref) {
 void compute_and_set_all_intercepts(lm_t* lm)
 {
     int i;
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
     int master_rank = 0;
 
     if (my_rank != master_rank) {
@@ -245,8 +310,8 @@ void compute_and_set_all_intercepts(lm_t* lm)
 
 
 void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double *rtt) {
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
     MPI_Status stat;
     int i;
     double tmp;
@@ -259,16 +324,16 @@ void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double
         /* warm up */
         for (i = 0; i < HCA_WARMUP_ROUNDS; i++) {
             tmp = hca_get_adjusted_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator());
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator(), &stat);
+            MPI_Send(&tmp, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm());
+            MPI_Recv(&tmp, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm(), &stat);
         }
 
         rtts  = (double*) malloc(n_pingpongs * sizeof(double));
 
         for (i = 0; i < n_pingpongs; i++) {
             tstart = hca_get_adjusted_time();
-            MPI_Send(&tstart, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator());
-            MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator(), &stat);
+            MPI_Send(&tstart, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm());
+            MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm(), &stat);
             rtts[i] = hca_get_adjusted_time() - tstart;
         }
 
@@ -277,15 +342,15 @@ void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double
 
         /* warm up */
         for (i = 0; i < HCA_WARMUP_ROUNDS; i++) {
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator(), &stat);
+            MPI_Recv(&tmp, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm(), &stat);
             tmp = hca_get_adjusted_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator());
+            MPI_Send(&tmp, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm());
         }
 
         for (i = 0; i < n_pingpongs; i++) {
-            MPI_Recv(&troot, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator(), &stat);
+            MPI_Recv(&troot, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm(), &stat);
             tlocal = hca_get_adjusted_time();
-            MPI_Send(&tlocal, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator());
+            MPI_Send(&tlocal, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm());
         }
     }
 
@@ -316,9 +381,9 @@ void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double
         free(rtts);
         free(rtts2);
 
-        MPI_Send(&mean, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator());
+        MPI_Send(&mean, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm());
     } else {
-        MPI_Recv(&mean, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator(), &stat);
+        MPI_Recv(&mean, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm(), &stat);
     }
 
     *rtt = mean;
@@ -328,8 +393,8 @@ void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double
 lm_t hca_learn_model(const int root_rank, const int other_rank,
         const reprompi_hca_params_t params, const double my_rtt) {
     int i, j;
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
     MPI_Status status;
     lm_t lm;
 
@@ -343,9 +408,9 @@ lm_t hca_learn_model(const int root_rank, const int other_rank,
         for (j = 0; j < params.n_fitpoints; j++) {
 
             for (i = 0; i < params.n_exchanges; i++) {
-                MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator(), &status);
+                MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm(), &status);
                 tlocal = hca_get_adjusted_time();
-                MPI_Ssend(&tlocal, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator());
+                MPI_Ssend(&tlocal, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm());
             }
         }
     } else {
@@ -370,8 +435,8 @@ lm_t hca_learn_model(const int root_rank, const int other_rank,
 
             for (i = 0; i < params.n_exchanges; i++) {
                 dummy = hca_get_adjusted_time();
-                MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, icmb_global_communicator());
-                MPI_Recv(&master_time, 1, MPI_DOUBLE, root_rank, 0, icmb_global_communicator(),
+                MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, reprompi_sync_comm());
+                MPI_Recv(&master_time, 1, MPI_DOUBLE, root_rank, 0, reprompi_sync_comm(),
                         &status);
                 local_time[i] = hca_get_adjusted_time();
                 time_var[i] = local_time[i] - master_time - my_rtt / 2.0;
@@ -414,9 +479,32 @@ lm_t hca_learn_model(const int root_rank, const int other_rank,
 }
 
 inline double hca_get_normalized_time(double local_time) {
+    if (tracker.n_segments > 1) {   // the model was updated during the measurements
+        double intercept, slope;
+
+        reprompi_clock_tracker_model_at(&tracker, local_time, &intercept, &slope);
+        return local_time - (local_time * slope + intercept);
+    }
     return local_time- (local_time * lm.slope + lm.intercept);
 }
 
+void hca_get_normalized_times(const double* restrict local_times, double* restrict global_times, long n) {
+    const double slope = lm.slope;
+    const double intercept = lm.intercept;
+    long i;
+
+    if (tracker.n_segments > 1) {
+        for (i = 0; i < n; i++) {
+            global_times[i] = hca_get_normalized_time(local_times[i]);
+        }
+        return;
+    }
+    // the model is loop-invariant, so the loop vectorizes
+    for (i = 0; i < n; i++) {
+        global_times[i] = local_times[i] - (local_times[i] * slope + intercept);
+    }
+}
+
 inline int my_pow_2(int exp) {
     return (int)pow(2.0, (double)exp);
 }
@@ -440,6 +528,9 @@ void hca_init_synchronization_module(const reprompib_sync_options_t parsed_opts,
     parameters.n_fitpoints = parsed_opts.n_fitpoints;
     parameters.wait_time_sec = parsed_opts.wait_time_sec;
     parameters.window_size_sec = parsed_opts.window_size_sec;
+    parameters.drift_bound_sec = parsed_opts.hca_drift_bound_sec;
+    parameters.node_leaders_only = parsed_opts.node_leaders_only;
+    parameters.clock_tracking_interval = parsed_opts.clock_tracking_interval;
     parameters.n_rep = nrep;
 
     invalid  = (int*)calloc(parameters.n_rep, sizeof(int));
@@ -447,17 +538,27 @@ void hca_init_synchronization_module(const reprompib_sync_options_t parsed_opts,
     {
         invalid[i] = 0;
     }
+    if (parameters.clock_tracking_interval > 0) {
+        uncertainty = (double*)calloc(parameters.n_rep, sizeof(double));
+    }
     repetition_counter = 0;
 
-    initial_timestamp = get_time();
+    reprompi_init_sync_topology(parameters.node_leaders_only);
+    reprompi_window_adapter_init(&window_adapter, parsed_opts.auto_window_batch,
+            parameters.window_size_sec, parameters.wait_time_sec, parameters.n_rep);
+
+    // a model kept from a previous job is only valid with its original time origin
+    if (!model_is_valid || parameters.drift_bound_sec <= 0) {
+        initial_timestamp = get_time();
+    }
 }
 
 
 
-void hca_synchronize_clocks(void)
+static void hca_learn_clock_models(void)
 {
-    int my_rank = icmb_global_rank();
-    int nprocs = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int nprocs = reprompi_sync_size();
     int i, j, p;
 
     int master_rank = 0;
@@ -524,7 +625,7 @@ void hca_synchronize_clocks(void)
                 nb_lm_to_comm = my_pow_2(i);
 
                 if( nb_lm_to_comm > 0 ) {
-                    MPI_Recv(&tmp_linear_models[0], nb_lm_to_comm, mpi_lm_t, other_rank, 0, icmb_global_communicator(), &stat);
+                    MPI_Recv(&tmp_linear_models[0], nb_lm_to_comm, mpi_lm_t, other_rank, 0, reprompi_sync_comm(), &stat);
 
                     linear_models[other_rank] = tmp_linear_models[0];
                     for(j=1; j<nb_lm_to_comm; j++) {
@@ -550,15 +651,15 @@ void hca_synchronize_clocks(void)
                 nb_lm_to_comm = my_pow_2(i);
 
                 if( nb_lm_to_comm > 0 ) {
-                    MPI_Send(&linear_models[my_rank], nb_lm_to_comm, mpi_lm_t, other_rank, 0, icmb_global_communicator());
+                    MPI_Send(&linear_models[my_rank], nb_lm_to_comm, mpi_lm_t, other_rank, 0, reprompi_sync_comm());
                 }
             }
         }
-        MPI_Barrier(icmb_global_communicator());
+        MPI_Barrier(reprompi_sync_comm());
     }
 
 
-    MPI_Comm_group(icmb_global_communicator(), &orig_group);
+    MPI_Comm_group(reprompi_sync_comm(), &orig_group);
     step_two_nb_ranks = nprocs - max_power_two + 1;
     step_two_group_ranks = (int*) calloc(step_two_nb_ranks, sizeof(int));
 
@@ -572,7 +673,7 @@ void hca_synchronize_clocks(void)
     MPI_Group_incl(orig_group, step_two_nb_ranks, step_two_group_ranks,
             &step_two_group);
 
-    MPI_Comm_create(icmb_global_communicator(), step_two_group, &step_two_comm);
+    MPI_Comm_create(reprompi_sync_comm(), step_two_group, &step_two_comm);
 
     // now step 2
     // synchronize processes with ranks > 2^max_power_two
@@ -627,12 +728,12 @@ void hca_synchronize_clocks(void)
         }
     }
 
-    MPI_Scatter(linear_models, 1, mpi_lm_t, &lm, 1, mpi_lm_t, master_rank, icmb_global_communicator());
+    MPI_Scatter(linear_models, 1, mpi_lm_t, &lm, 1, mpi_lm_t, master_rank, reprompi_sync_comm());
 
 #ifndef ENABLE_LOGP_SYNC
     compute_and_set_all_intercepts(&lm);
 #endif
-    MPI_Barrier(icmb_global_communicator());
+    MPI_Barrier(reprompi_sync_comm());
 
     free(linear_models);
     free(tmp_linear_models);
@@ -646,16 +747,148 @@ void hca_synchronize_clocks(void)
 }
 
 
+static double hca_get_global_time(void) {
+    return hca_get_normalized_time(hca_get_adjusted_time());
+}
+
+/*
+ * measures the residual offset between the global clocks of the master
+ * and a few reference ranks spread over the communicator (including the
+ * last rank, whose model is merged over the most rounds);
+ * returns 1 on all processes if the largest offset exceeds the drift bound
+ */
+static int hca_model_has_drifted(void)
+{
+    int my_rank = reprompi_sync_rank();
+    int nprocs = reprompi_sync_size();
+    int master_rank = 0;
+    int i, n_refs, ref_rank;
+    int drifted = 0;
+    double residual, max_residual = 0;
+
+    n_refs = repro_min(HCA_N_REFERENCE_RANKS, nprocs - 1);
+    for (i = 0; i < n_refs; i++) {
+        ref_rank = (i + 1) * (nprocs - 1) / n_refs;
+
+        if (my_rank == master_rank || my_rank == ref_rank) {
+            residual = fabs(ping_pong_skampi(master_rank, ref_rank, hca_get_global_time));
+            if (my_rank == master_rank) {
+                max_residual = repro_max(max_residual, residual);
+            }
+        }
+    }
+
+    if (my_rank == master_rank) {
+        drifted = (max_residual > parameters.drift_bound_sec);
+        model_stats.max_residual_sec = repro_max(model_stats.max_residual_sec, max_residual);
+    }
+    MPI_Bcast(&drifted, 1, MPI_INT, master_rank, reprompi_sync_comm());
+
+    return drifted;
+}
+
+
+void hca_synchronize_clocks(void)
+{
+    int i;
+    double t_start;
+    int relearn = 1;
+    double model[3];
+    long total_counters[PP_N_COUNTERS];
+
+    model_stats.n_sync_calls++;
+
+    if (reprompi_is_sync_participant()) {
+        for (i = 0; i < PP_N_COUNTERS; i++) {
+            pp_counters[i] = 0;
+        }
+
+        if (model_is_valid && parameters.drift_bound_sec > 0) {
+            t_start = get_time();
+            relearn = hca_model_has_drifted();
+            model_stats.check_time_sec += get_time() - t_start;
+            model_stats.n_checks++;
+        }
+
+        if (relearn) {
+            t_start = get_time();
+            hca_learn_clock_models();
+            model_stats.learn_time_sec += get_time() - t_start;
+            model_stats.n_learns++;
+        }
+
+        MPI_Reduce(pp_counters, total_counters, PP_N_COUNTERS, MPI_LONG, MPI_SUM, 0,
+                reprompi_sync_comm());
+        if (reprompi_sync_rank() == 0) {
+            for (i = 0; i < PP_N_COUNTERS; i++) {
+                pp_total_counters[i] += total_counters[i];
+            }
+        }
+    }
+
+    // the model refers to the adjusted time of the node leader, so its time origin is shared as well
+    model[0] = lm.intercept;
+    model[1] = lm.slope;
+    model[2] = initial_timestamp;
+    reprompi_share_sync_model(model, 3, MPI_DOUBLE);
+    lm.intercept = model[0];
+    lm.slope = model[1];
+    initial_timestamp = model[2];
+
+    model_is_valid = 1;
+}
+
+
 void hca_init_synchronization(void) {
+    repetition_counter = 0;
+    hca_resume_synchronization();
+
+    if (parameters.clock_tracking_interval > 0) {
+        reprompi_clock_tracker_init(&tracker, lm.intercept, lm.slope, hca_get_adjusted_time());
+        tracking_update_index = 0;
+    }
+}
+
+/*
+ * moves the next window after the current time (on the master)
+ * without resetting the repetition counter
+ */
+void hca_resume_synchronization(void) {
     int my_rank = icmb_global_rank();
     int master_rank = 0;
 
-    repetition_counter = 0;
     if( my_rank == master_rank ) {
         start_sync = hca_get_adjusted_time() + parameters.wait_time_sec;
     }
     MPI_Bcast(&start_sync, 1, MPI_DOUBLE, master_rank, icmb_global_communicator());
+}
+
+/*
+ * one process per call measures its offset to the master and updates its
+ * clock model, so that each model is updated every (nprocs-1) calls
+ */
+static void hca_track_clock_model(void)
+{
+    int my_rank = reprompi_sync_rank();
+    int nprocs = reprompi_sync_size();
+    int master_rank = 0;
+    int client;
+    double x, offset, error_bound;
 
+    if (nprocs < 2) {
+        return;
+    }
+    client = 1 + tracking_update_index % (nprocs - 1);
+    tracking_update_index++;
+
+    if (reprompi_clock_tracker_measure_offset(master_rank, client, hca_get_adjusted_time,
+            &x, &offset, &error_bound)) {
+        reprompi_clock_tracker_update(&tracker, x, offset, error_bound);
+        reprompi_clock_tracker_get_model(&tracker, &lm.intercept, &lm.slope);
+    }
+    if (my_rank == master_rank) {
+        n_tracking_updates++;
+    }
 }
 
 void hca_start_synchronization(void)
@@ -663,6 +896,10 @@ void hca_start_synchronization(void)
     int is_first = 1;
     double global_time;
 
+    if (uncertainty != NULL && reprompi_sync_rank() != 0) {
+        uncertainty[repetition_counter] = reprompi_clock_tracker_uncertainty(&tracker, hca_get_adjusted_time());
+    }
+
     while(1) {
         global_time = hca_get_normalized_time(hca_get_adjusted_time());
 
@@ -670,6 +907,7 @@ void hca_start_synchronization(void)
             if( is_first == 1 ) {
                 invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
             }
+            window_entry_time = global_time;
             break;
         }
         is_first = 0;
@@ -679,15 +917,26 @@ void hca_start_synchronization(void)
 
 void hca_stop_synchronization(void)
 {
-    double global_time;
+    double global_time, next_start;
     global_time = hca_get_normalized_time(hca_get_adjusted_time());
 
     if( global_time > start_sync + parameters.window_size_sec ) {
         invalid[repetition_counter] |= FLAG_SYNC_WIN_EXPIRED;
     }
 
-    start_sync += parameters.window_size_sec;
+    if (reprompi_window_adapter_record(&window_adapter, global_time - window_entry_time, global_time, &next_start)) {
+        parameters.window_size_sec = window_adapter.window_sec;
+        start_sync = next_start;
+    } else {
+        start_sync += parameters.window_size_sec;
+    }
     repetition_counter++;
+
+    // measure between two windows
+    if (parameters.clock_tracking_interval > 0 &&
+            repetition_counter % parameters.clock_tracking_interval == 0) {
+        hca_track_clock_model();
+    }
 }
 
 
@@ -698,9 +947,26 @@ int* hca_get_local_sync_errorcodes(void)
 }
 
 
+double* hca_get_local_model_uncertainties(void)
+{
+    return uncertainty;
+}
+
+
+double* hca_get_window_sizes(void)
+{
+    return reprompi_window_adapter_get_windows(&window_adapter);
+}
+
+
 void hca_cleanup_synchronization_module(void)
 {
     free(invalid);
+    free(uncertainty);
+    uncertainty = NULL;
+    // keep the last model, but not the models used during the finished job
+    tracker.n_segments = 0;
+    reprompi_window_adapter_cleanup(&window_adapter);
 }
 
 
@@ -711,9 +977,53 @@ void hca_print_sync_parameters(FILE* f)
     fprintf(f, "#@fitpoints=%d\n", parameters.n_fitpoints);
     fprintf(f, "#@exchanges=%d\n", parameters.n_exchanges);
     fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
+    reprompi_print_sync_topology(f);
+    if (parameters.clock_tracking_interval > 0) {
+        fprintf(f, "#@clock_tracking_interval=%d\n", parameters.clock_tracking_interval);
+    }
+    if (parameters.drift_bound_sec > 0) {
+        fprintf(f, "#@hca_drift_bound_s=%.10f\n", parameters.drift_bound_sec);
+    }
+    reprompi_window_adapter_print(&window_adapter, f);
 #ifdef ENABLE_LOGP_SYNC
     fprintf(f, "#@hcasynctype=logp\n");
 #else
     fprintf(f, "#@hcasynctype=linear\n");
 #endif
 }
+
+
+void hca_print_sync_statistics(FILE* f)
+{
+    double saved_time = 0;
+    long saved_exchanges = pp_total_counters[PP_CALLS] * Number_ping_pongs1 - pp_total_counters[PP_EXCHANGES];
+
+    fprintf(f, "#@hca_pingpongs=%ld\n", pp_total_counters[PP_CALLS]);
+    if (pp_total_counters[PP_CALLS] > 0) {
+        fprintf(f, "#@hca_pingpong_cache_hit_rate=%.4f\n",
+                (double)pp_total_counters[PP_CACHE_HITS] / pp_total_counters[PP_CALLS]);
+    }
+    fprintf(f, "#@hca_pingpong_exchanges=%ld\n", pp_total_counters[PP_EXCHANGES]);
+    fprintf(f, "#@hca_pingpong_exchanges_saved=%ld\n", saved_exchanges);
+    if (parameters.clock_tracking_interval > 0) {
+        fprintf(f, "#@hca_clock_tracking_updates=%ld\n", n_tracking_updates);
+    }
+
+    if (parameters.drift_bound_sec <= 0) {  // models were re-learned for every job
+        return;
+    }
+
+    // each reused model saves the average learning time, minus the time of all drift checks
+    if (model_stats.n_learns > 0) {
+        saved_time = model_stats.learn_time_sec / model_stats.n_learns
+                * (model_stats.n_sync_calls - model_stats.n_learns) - model_stats.check_time_sec;
+    }
+
+    fprintf(f, "#@hca_model_learns=%ld\n", model_stats.n_learns);
+    fprintf(f, "#@hca_model_reuses=%ld\n", model_stats.n_sync_calls - model_stats.n_learns);
+    fprintf(f, "#@hca_drift_checks=%ld\n", model_stats.n_checks);
+    fprintf(f, "#@hca_max_residual_offset_s=%.10f\n", model_stats.max_residual_sec);
+    fprintf(f, "#@hca_learn_time_s=%.10f\n", model_stats.learn_time_sec);
+    fprintf(f, "#@hca_check_time_s=%.10f\n", model_stats.check_time_sec);
+    fprintf(f, "#@hca_sync_time_saved_s=%.10f\n", saved_time);
+}
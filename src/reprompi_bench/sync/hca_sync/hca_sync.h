@@ -34,21 +34,29 @@ typedef struct {
     int n_exchanges; /* --exchanges */
 
     double wait_time_sec; /* --wait-time */
+    double drift_bound_sec; /* --hca-drift-bound */
+    int node_leaders_only; /* --node-leader-sync */
+    int clock_tracking_interval; /* --clock-tracking */
 } reprompi_hca_params_t;
 
 void hca_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
 void hca_init_synchronization(void);
+void hca_resume_synchronization(void);
 void hca_synchronize_clocks(void);
 void hca_start_synchronization(void);
 void hca_stop_synchronization(void);
 void hca_cleanup_synchronization_module(void);
 
 int* hca_get_local_sync_errorcodes(void);
+double* hca_get_local_model_uncertainties(void);
+double* hca_get_window_sizes(void);
 
 double hca_get_normalized_time(double local_time);
+void hca_get_normalized_times(const double* local_times, double* global_times, long n);
 double hca_get_adjusted_time(void);
 
 void hca_print_sync_parameters(FILE* f);
+void hca_print_sync_statistics(FILE* f);
 
 int my_pow_2(int exp);
 
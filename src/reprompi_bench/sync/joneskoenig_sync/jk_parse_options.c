@@ -33,6 +33,13 @@
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/sync_info.h"
 #include "jk_parse_options.h"
+#include "jk_sync.h"
+
+static char* const jk_model_alg_names[] = {
+        [JK_MODELS_LINEAR] = "linear",
+        [JK_MODELS_TREE] = "tree",
+        NULL
+};
 
 void jk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
     int c;
@@ -71,6 +78,30 @@ void jk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
             opts_p->wait_time_sec = atof(optarg) * 1e-6;
             break;
 
+        case REPROMPI_ARGS_WINSYNC_JK_MODELS: /* scheme used to learn the clock models */
+        {
+            char* subopts = optarg;
+            char* value;
+
+            opts_p->jk_model_alg = getsubopt(&subopts, jk_model_alg_names, &value);
+            if (opts_p->jk_model_alg < 0) {
+                reprompib_print_error_and_exit("Unknown JK model scheme (should be linear or tree)");
+            }
+            break;
+        }
+
+        case REPROMPI_ARGS_WINSYNC_NODE_LEADERS: /* only one process per node learns the clock model */
+            opts_p->node_leaders_only = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_CLOCK_TRACKING: /* repetitions between two online updates of the clock model */
+            opts_p->clock_tracking_interval = atoi(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_AUTO_WINDOW: /* repetitions between two adaptations of the window size */
+            opts_p->auto_window_batch = atoi(optarg);
+            break;
+
         case '?':
             break;
         }
@@ -89,6 +120,15 @@ void jk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
     if (opts_p->n_exchanges <= 0) {
       reprompib_print_error_and_exit("Invalid number of ping-pong exchanges (should be a positive integer)");
     }
+    if (opts_p->clock_tracking_interval < 0) {
+      reprompib_print_error_and_exit("Invalid clock tracking interval (should be a positive number of repetitions, or 0 to disable tracking)");
+    }
+    if (opts_p->clock_tracking_interval > 0 && opts_p->node_leaders_only) {
+      reprompib_print_error_and_exit("Online clock tracking cannot be combined with node-leader synchronization");
+    }
+    if (opts_p->auto_window_batch < 0) {
+      reprompib_print_error_and_exit("Invalid window adaptation batch (should be a positive number of repetitions, or 0 for a fixed window)");
+    }
 
     optind = 1;	// reset optind to enable option re-parsing
     opterr = 1; // reset opterr
@@ -34,6 +34,9 @@
 
 #include "reprompi_bench/sync/time_measurement.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/sync_topology.h"
+#include "reprompi_bench/sync/clock_tracking.h"
+#include "reprompi_bench/sync/window_adaptation.h"
 #include "jk_parse_options.h"
 #include "jk_sync.h"
 
@@ -54,9 +57,18 @@ static double my_rtt;
 //linear model
 double slope, intercept;
 
+// online tracking of the clock model (enabled with --clock-tracking)
+static reprompi_clock_tracker_t tracker;
+static double* uncertainty = NULL;         /* uncertainty of the clock model for each repetition */
+static long tracking_update_index = 0;     /* selects the process updating its model */
+
+// adaptive window size (enabled with --auto-window)
+static reprompi_window_adapter_t window_adapter;
+static double window_entry_time = 0;   /* global time at which the current measurement started */
+
 void estimate_rtt(int master_rank, int other_rank, const int n_pingpongs,
         double *rtt) {
-    int my_rank = icmb_global_rank();
+    int my_rank = reprompi_sync_rank();
     MPI_Status stat;
     int i;
     double tmp;
@@ -68,16 +80,16 @@ void estimate_rtt(int master_rank, int other_rank, const int n_pingpongs,
         /* warm up */
         for (i = 0; i < WARMUP_ROUNDS; i++) {
             tmp = get_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator());
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator(), &stat);
+            MPI_Send(&tmp, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm());
+            MPI_Recv(&tmp, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm(), &stat);
         }
 
         rtts = (double*) malloc(n_pingpongs * sizeof(double));
 
         for (i = 0; i < n_pingpongs; i++) {
             tstart = get_time();
-            MPI_Send(&tstart, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator());
-            MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, icmb_global_communicator(),
+            MPI_Send(&tstart, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm());
+            MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, reprompi_sync_comm(),
                     &stat);
             rtts[i] = get_time() - tstart;
         }
@@ -87,17 +99,17 @@ void estimate_rtt(int master_rank, int other_rank, const int n_pingpongs,
 
         /* warm up */
         for (i = 0; i < WARMUP_ROUNDS; i++) {
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator(),
+            MPI_Recv(&tmp, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm(),
                     &stat);
             tmp = get_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator());
+            MPI_Send(&tmp, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm());
         }
 
         for (i = 0; i < n_pingpongs; i++) {
-            MPI_Recv(&troot, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator(),
+            MPI_Recv(&troot, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm(),
                     &stat);
             tlocal = get_time();
-            MPI_Send(&tlocal, 1, MPI_DOUBLE, master_rank, 0, icmb_global_communicator());
+            MPI_Send(&tlocal, 1, MPI_DOUBLE, master_rank, 0, reprompi_sync_comm());
         }
     }
 
@@ -138,8 +150,8 @@ void estimate_rtt(int master_rank, int other_rank, const int n_pingpongs,
 }
 
 void warmup(int root_rank) {
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
     MPI_Status status;
     int i, p;
     double tmp;
@@ -148,29 +160,109 @@ void warmup(int root_rank) {
         for (i = 0; i < WARMUP_ROUNDS; i++) {
             for (p = 0; p < np; p++) {
                 if (p != root_rank) {
-                    MPI_Send(&tmp, 1, MPI_DOUBLE, p, 0, icmb_global_communicator());
-                    MPI_Recv(&tmp, 1, MPI_DOUBLE, p, 0, icmb_global_communicator(),
+                    MPI_Send(&tmp, 1, MPI_DOUBLE, p, 0, reprompi_sync_comm());
+                    MPI_Recv(&tmp, 1, MPI_DOUBLE, p, 0, reprompi_sync_comm(),
                             &status);
                 }
             }
         }
     } else {
         for (i = 0; i < WARMUP_ROUNDS; i++) {
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, root_rank, 0, icmb_global_communicator(),
+            MPI_Recv(&tmp, 1, MPI_DOUBLE, root_rank, 0, reprompi_sync_comm(),
                     &status);
-            MPI_Send(&tmp, 1, MPI_DOUBLE, root_rank, 0, icmb_global_communicator());
+            MPI_Send(&tmp, 1, MPI_DOUBLE, root_rank, 0, reprompi_sync_comm());
         }
     }
 
 }
 
-void learn_clock(const int root_rank, double *intercept, double *slope,
+/*
+ * exchanges timestamps with root_rank and fits the linear model of the
+ * local clock offset to the clock of root_rank
+ */
+static void fit_clock_model(const int root_rank, double *intercept, double *slope,
         const long n_fitpoints, const long n_exchanges, const double my_rtt) {
-    int i, j, p;
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int i, j;
+    MPI_Status status;
+    double *time_var, *local_time, *time_var2;
+    double *xfit, *yfit;
+    double cov00, cov01, cov11, sumsq;
+    int fit;
+    double dummy;
+    double median, master_time;
+
+    time_var = (double*) calloc(n_exchanges, sizeof(double));
+    time_var2 = (double*) calloc(n_exchanges, sizeof(double));
+    local_time = (double*) calloc(n_exchanges, sizeof(double));
+
+    xfit = (double*) calloc(n_fitpoints, sizeof(double));
+    yfit = (double*) calloc(n_fitpoints, sizeof(double));
+
+    for (j = 0; j < n_fitpoints; j++) {
+
+        for (i = 0; i < n_exchanges; i++) {
+            dummy = get_time();
+            MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, reprompi_sync_comm());
+            MPI_Recv(&master_time, 1, MPI_DOUBLE, root_rank, 0,
+                    reprompi_sync_comm(), &status);
+            local_time[i] = get_time();
+            time_var[i] = local_time[i] - master_time - my_rtt / 2.0;
+            time_var2[i] = time_var[i];
+        }
+
+        gsl_sort(time_var2, 1, n_exchanges);
+
+        if (n_exchanges % 2 == 0) {
+            median = gsl_stats_median_from_sorted_data(time_var2, 1,
+                    n_exchanges - 1);
+        } else {
+            median = gsl_stats_median_from_sorted_data(time_var2, 1,
+                    n_exchanges);
+        }
+
+        for (i = 0; i < n_exchanges; i++) {
+            if (time_var[i] == median) {
+                xfit[j] = local_time[i];
+                yfit[j] = time_var[i];
+                break;
+            }
+        }
+
+    }
+
+    fit = gsl_fit_linear(xfit, 1, yfit, 1, n_fitpoints, intercept, slope,
+            &cov00, &cov01, &cov11, &sumsq);
+
+    //    printf("p%d: model: intercept=%10.5f slope=%.20f\n", my_rank, *intercept,
+    //        *slope);
+
+    free(time_var);
+    free(time_var2);
+    free(local_time);
+    free(xfit);
+    free(yfit);
+}
+
+/* answers the timestamp exchanges of fit_clock_model on the root side */
+static void serve_clock_exchanges(const int client_rank, const long n_exchanges) {
+    int i;
+    double tlocal, tremote;
     MPI_Status status;
 
+    for (i = 0; i < n_exchanges; i++) {
+        MPI_Recv(&tremote, 1, MPI_DOUBLE, client_rank, 0, reprompi_sync_comm(),
+                &status);
+        tlocal = get_time();
+        MPI_Ssend(&tlocal, 1, MPI_DOUBLE, client_rank, 0, reprompi_sync_comm());
+    }
+}
+
+void learn_clock(const int root_rank, double *intercept, double *slope,
+        const long n_fitpoints, const long n_exchanges, const double my_rtt) {
+    int j, p;
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
+
     //  struct timespec ts;
     //
     //  ts.tv_sec  = 0;
@@ -183,88 +275,46 @@ void learn_clock(const int root_rank, double *intercept, double *slope,
 
     if (my_rank == root_rank) {
 
-        double tlocal, tremote;
-
         for (j = 0; j < n_fitpoints; j++) {
 
             for (p = 0; p < np; p++) {
                 if (p != root_rank) {
-                    for (i = 0; i < n_exchanges; i++) {
-                        MPI_Recv(&tremote, 1, MPI_DOUBLE, p, 0, icmb_global_communicator(),
-                                &status);
-                        tlocal = get_time();
-                        MPI_Ssend(&tlocal, 1, MPI_DOUBLE, p, 0, icmb_global_communicator());
-                    }
+                    serve_clock_exchanges(p, n_exchanges);
                 }
             }
 
         }
 
     } else {
+        fit_clock_model(root_rank, intercept, slope, n_fitpoints, n_exchanges, my_rtt);
+    }
+}
 
-        double *time_var, *local_time, *time_var2;
-        double *xfit, *yfit;
-        double cov00, cov01, cov11, sumsq;
-        int fit;
-        double dummy;
-        double median, master_time;
-
-        time_var = (double*) calloc(n_exchanges, sizeof(double));
-        time_var2 = (double*) calloc(n_exchanges, sizeof(double));
-        local_time = (double*) calloc(n_exchanges, sizeof(double));
-
-        xfit = (double*) calloc(n_fitpoints, sizeof(double));
-        yfit = (double*) calloc(n_fitpoints, sizeof(double));
-
-        for (j = 0; j < n_fitpoints; j++) {
-
-            for (i = 0; i < n_exchanges; i++) {
-                dummy = get_time();
-                MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, icmb_global_communicator());
-                MPI_Recv(&master_time, 1, MPI_DOUBLE, root_rank, 0,
-                        icmb_global_communicator(), &status);
-                local_time[i] = get_time();
-                time_var[i] = local_time[i] - master_time - my_rtt / 2.0;
-                time_var2[i] = time_var[i];
-            }
-
-            gsl_sort(time_var2, 1, n_exchanges);
+inline double jk_get_normalized_time(double local_time) {
+    if (tracker.n_segments > 1) {   // the model was updated during the measurements
+        double seg_intercept, seg_slope;
 
-            if (n_exchanges % 2 == 0) {
-                median = gsl_stats_median_from_sorted_data(time_var2, 1,
-                        n_exchanges - 1);
-            } else {
-                median = gsl_stats_median_from_sorted_data(time_var2, 1,
-                        n_exchanges);
-            }
+        reprompi_clock_tracker_model_at(&tracker, local_time, &seg_intercept, &seg_slope);
+        return local_time - (local_time * seg_slope + seg_intercept);
+    }
+    return local_time - (local_time * slope + intercept);
+}
 
-            for (i = 0; i < n_exchanges; i++) {
-                if (time_var[i] == median) {
-                    xfit[j] = local_time[i];
-                    yfit[j] = time_var[i];
-                    break;
-                }
-            }
+void jk_get_normalized_times(const double* restrict local_times, double* restrict global_times, long n) {
+    const double s = slope;
+    const double c = intercept;
+    long i;
 
+    if (tracker.n_segments > 1) {
+        for (i = 0; i < n; i++) {
+            global_times[i] = jk_get_normalized_time(local_times[i]);
         }
-
-        fit = gsl_fit_linear(xfit, 1, yfit, 1, n_fitpoints, intercept, slope,
-                &cov00, &cov01, &cov11, &sumsq);
-
-        //    printf("p%d: model: intercept=%10.5f slope=%.20f\n", my_rank, *intercept,
-        //        *slope);
-
-        free(time_var);
-        free(time_var2);
-        free(local_time);
-        free(xfit);
-        free(yfit);
-
+        return;
+    }
+    // the model is loop-invariant, so the loop vectorizes
+    for (i = 0; i < n; i++) {
+        global_times[i] = local_times[i] - (local_times[i] * s + c);
     }
-}
-
-inline double jk_get_normalized_time(double local_time) {
-    return local_time - (local_time * slope + intercept);
 }
 
 
@@ -275,22 +325,31 @@ void jk_init_synchronization_module(const reprompib_sync_options_t parsed_opts,
     parameters.n_fitpoints = parsed_opts.n_fitpoints;
     parameters.wait_time_sec = parsed_opts.wait_time_sec;
     parameters.window_size_sec = parsed_opts.window_size_sec;
+    parameters.model_alg = (jk_model_alg_t)parsed_opts.jk_model_alg;
+    parameters.node_leaders_only = parsed_opts.node_leaders_only;
+    parameters.clock_tracking_interval = parsed_opts.clock_tracking_interval;
     parameters.n_rep = nrep;
 
     invalid = (int*) calloc(parameters.n_rep, sizeof(int));
     for (i = 0; i < parameters.n_rep; i++) {
         invalid[i] = 0;
     }
+    if (parameters.clock_tracking_interval > 0) {
+        uncertainty = (double*) calloc(parameters.n_rep, sizeof(double));
+    }
     repetition_counter = 0;
 
+    reprompi_init_sync_topology(parameters.node_leaders_only);
+    reprompi_window_adapter_init(&window_adapter, parsed_opts.auto_window_batch,
+            parameters.window_size_sec, parameters.wait_time_sec, parameters.n_rep);
 }
 
-void jk_sync_clocks(void) {
+static void jk_sync_clocks_linear(void) {
     int p;
     int master_rank;
     double *rtts_s;
     int n_pingpongs = 1000;
-    int np = icmb_global_size();
+    int np = reprompi_sync_size();
 
     master_rank = 0;
 
@@ -306,32 +365,163 @@ void jk_sync_clocks(void) {
     }
 
     MPI_Scatter(rtts_s, 1, MPI_DOUBLE, &my_rtt, 1, MPI_DOUBLE, master_rank,
-            icmb_global_communicator());
+            reprompi_sync_comm());
     free(rtts_s);
 
     learn_clock(master_rank, &intercept, &slope, parameters.n_fitpoints,
             parameters.n_exchanges, my_rtt);
 
-    MPI_Barrier(icmb_global_communicator());
+    MPI_Barrier(reprompi_sync_comm());
+}
+
+/*
+ * learns the clock models along a binomial tree: in round k, every process
+ * r with r % 2^(k+1) == 2^k learns its model against r - 2^k, with all
+ * pairs of a round running concurrently; the root then merges the models
+ * along the tree into models relative to its own clock
+ */
+static void jk_sync_clocks_tree(void) {
+    int i, j, step, parent;
+    int master_rank = 0;
+    int n_pingpongs = 1000;
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
+    double model_to_parent[2] = { 0, 0 };   /* intercept, slope */
+    double *models = NULL;
+    MPI_Status stat;
+
+    for (step = 1; step < np; step *= 2) {
+        if (my_rank % (2 * step) == 0) {
+            if (my_rank + step < np) {
+                estimate_rtt(my_rank, my_rank + step, n_pingpongs, &my_rtt);
+                MPI_Send(&my_rtt, 1, MPI_DOUBLE, my_rank + step, 0, reprompi_sync_comm());
+
+                for (j = 0; j < parameters.n_fitpoints; j++) {
+                    serve_clock_exchanges(my_rank + step, parameters.n_exchanges);
+                }
+            }
+        }
+        else if (my_rank % (2 * step) == step) {
+            parent = my_rank - step;
+            estimate_rtt(parent, my_rank, n_pingpongs, &my_rtt);
+            MPI_Recv(&my_rtt, 1, MPI_DOUBLE, parent, 0, reprompi_sync_comm(), &stat);
+
+            fit_clock_model(parent, &model_to_parent[0], &model_to_parent[1],
+                    parameters.n_fitpoints, parameters.n_exchanges, my_rtt);
+        }
+        MPI_Barrier(reprompi_sync_comm());
+    }
+
+    if (my_rank == master_rank) {
+        models = (double*) malloc(2 * np * sizeof(double));
+    }
+    MPI_Gather(model_to_parent, 2, MPI_DOUBLE, models, 2, MPI_DOUBLE, master_rank,
+            reprompi_sync_comm());
+
+    if (my_rank == master_rank) {
+        // the parent of i (i with its lowest set bit cleared) is always smaller than i,
+        // so its model relative to the root is already known
+        models[0] = 0;
+        models[1] = 0;
+        for (i = 1; i < np; i++) {
+            double p_intercept, p_slope, c_intercept, c_slope;
+
+            parent = i & (i - 1);
+            p_intercept = models[2 * parent];
+            p_slope = models[2 * parent + 1];
+            c_intercept = models[2 * i];
+            c_slope = models[2 * i + 1];
+
+            models[2 * i] = c_intercept + p_intercept - c_intercept * p_slope;
+            models[2 * i + 1] = c_slope + p_slope - c_slope * p_slope;
+        }
+    }
+    MPI_Scatter(models, 2, MPI_DOUBLE, model_to_parent, 2, MPI_DOUBLE, master_rank,
+            reprompi_sync_comm());
+    free(models);
+
+    intercept = model_to_parent[0];
+    slope = model_to_parent[1];
+
+    MPI_Barrier(reprompi_sync_comm());
+}
+
+void jk_sync_clocks(void) {
+    double model[2];
+
+    if (reprompi_is_sync_participant()) {
+        if (parameters.model_alg == JK_MODELS_TREE) {
+            jk_sync_clocks_tree();
+        }
+        else {
+            jk_sync_clocks_linear();
+        }
+    }
+
+    model[0] = intercept;
+    model[1] = slope;
+    reprompi_share_sync_model(model, 2, MPI_DOUBLE);
+    intercept = model[0];
+    slope = model[1];
 }
 
 
 void jk_init_synchronization(void) {
+    repetition_counter = 0;
+    jk_resume_synchronization();
+
+    if (parameters.clock_tracking_interval > 0) {
+        reprompi_clock_tracker_init(&tracker, intercept, slope, get_time());
+        tracking_update_index = 0;
+    }
+}
+
+/*
+ * moves the next window after the current time (on the master)
+ * without resetting the repetition counter
+ */
+void jk_resume_synchronization(void) {
     int my_rank = icmb_global_rank();
     int master_rank = 0;
 
-    repetition_counter = 0;
     if (my_rank == master_rank) {
         start_sync = get_time() + parameters.wait_time_sec;
     }
     MPI_Bcast(&start_sync, 1, MPI_DOUBLE, master_rank, icmb_global_communicator());
 }
 
+/*
+ * one process per call measures its offset to the master and updates its
+ * clock model, so that each model is updated every (np-1) calls
+ */
+static void jk_track_clock_model(void) {
+    int np = reprompi_sync_size();
+    int master_rank = 0;
+    int client;
+    double x, offset, error_bound;
+
+    if (np < 2) {
+        return;
+    }
+    client = 1 + tracking_update_index % (np - 1);
+    tracking_update_index++;
+
+    if (reprompi_clock_tracker_measure_offset(master_rank, client, get_time,
+            &x, &offset, &error_bound)) {
+        reprompi_clock_tracker_update(&tracker, x, offset, error_bound);
+        reprompi_clock_tracker_get_model(&tracker, &intercept, &slope);
+    }
+}
+
 
 void jk_start_synchronization(void) {
     int is_first = 1;
     double global_time;
 
+    if (uncertainty != NULL && reprompi_sync_rank() != 0) {
+        uncertainty[repetition_counter] = reprompi_clock_tracker_uncertainty(&tracker, get_time());
+    }
+
     while (1) {
         global_time = jk_get_normalized_time(get_time());
 
@@ -339,6 +529,7 @@ void jk_start_synchronization(void) {
             if (is_first == 1) {
                 invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
             }
+            window_entry_time = global_time;
             break;
         }
         is_first = 0;
@@ -346,27 +537,51 @@ void jk_start_synchronization(void) {
 }
 
 void jk_stop_synchronization(void) {
-    double global_time;
+    double global_time, next_start;
     global_time = jk_get_normalized_time(get_time());
 
     if (global_time > start_sync + parameters.window_size_sec) {
         invalid[repetition_counter] |= FLAG_SYNC_WIN_EXPIRED;
     }
 
-    start_sync += parameters.window_size_sec;
+    if (reprompi_window_adapter_record(&window_adapter, global_time - window_entry_time, global_time, &next_start)) {
+        parameters.window_size_sec = window_adapter.window_sec;
+        start_sync = next_start;
+    } else {
+        start_sync += parameters.window_size_sec;
+    }
     repetition_counter++;
+
+    // measure between two windows
+    if (parameters.clock_tracking_interval > 0 &&
+            repetition_counter % parameters.clock_tracking_interval == 0) {
+        jk_track_clock_model();
+    }
 }
 
 int* jk_get_local_sync_errorcodes(void) {
     return invalid;
 }
 
+double* jk_get_local_model_uncertainties(void) {
+    return uncertainty;
+}
+
+double* jk_get_window_sizes(void) {
+    return reprompi_window_adapter_get_windows(&window_adapter);
+}
+
 double jk_get_timediff_to_root(double local_time) {
     return local_time - jk_get_normalized_time(local_time);
 }
 
 void jk_cleanup_synchronization_module(void) {
     free(invalid);
+    free(uncertainty);
+    uncertainty = NULL;
+    // keep the last model, but not the models used during the finished job
+    tracker.n_segments = 0;
+    reprompi_window_adapter_cleanup(&window_adapter);
 }
 
 void jk_print_sync_parameters(FILE* f) {
@@ -375,4 +590,12 @@ void jk_print_sync_parameters(FILE* f) {
     fprintf(f, "#@fitpoints=%d\n", parameters.n_fitpoints);
     fprintf(f, "#@exchanges=%d\n", parameters.n_exchanges);
     fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
+    if (parameters.model_alg == JK_MODELS_TREE) {
+        fprintf(f, "#@jk_models=tree\n");
+    }
+    reprompi_print_sync_topology(f);
+    if (parameters.clock_tracking_interval > 0) {
+        fprintf(f, "#@clock_tracking_interval=%d\n", parameters.clock_tracking_interval);
+    }
+    reprompi_window_adapter_print(&window_adapter, f);
 }
@@ -25,6 +25,11 @@
 
 #include "reprompi_bench/sync/sync_info.h"
 
+typedef enum {
+    JK_MODELS_LINEAR = 0,   /* every process learns its model against the root */
+    JK_MODELS_TREE          /* models learned along a binomial tree and merged */
+} jk_model_alg_t;
+
 typedef struct {
     long n_rep; /* --repetitions */
     double window_size_sec; /* --window-size */
@@ -33,18 +38,25 @@ typedef struct {
     int n_exchanges; /* --exchanges */
 
     double wait_time_sec; /* --wait-time */
+    jk_model_alg_t model_alg; /* --jk-models */
+    int node_leaders_only; /* --node-leader-sync */
+    int clock_tracking_interval; /* --clock-tracking */
 } reprompi_jk_options_t;
 
 void jk_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
 void jk_init_synchronization(void);
+void jk_resume_synchronization(void);
 void jk_sync_clocks(void);
 void jk_start_synchronization(void);
 void jk_stop_synchronization(void);
 void jk_cleanup_synchronization_module(void);
 
 int* jk_get_local_sync_errorcodes(void);
+double* jk_get_local_model_uncertainties(void);
+double* jk_get_window_sizes(void);
 
 double jk_get_normalized_time(double local_time);
+void jk_get_normalized_times(const double* local_times, double* global_times, long n);
 
 void jk_print_sync_parameters(FILE* f);
 
@@ -36,6 +36,7 @@ void mpibarrier_cleanup_synchronization_module(void);
 int* mpibarrier_get_local_sync_errorcodes(void);
 
 double mpibarrier_get_normalized_time(double local_time);
+void mpibarrier_get_normalized_times(const double* local_times, double* global_times, long n);
 
 void mpibarrier_print_sync_parameters(FILE* f);
 
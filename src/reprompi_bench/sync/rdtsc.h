@@ -43,38 +43,14 @@ typedef struct {
 
 #define HRT_GET_TIME(t1, time) time = (((( uint64_t ) t1.h) << 32) | t1.l)
 
-#define HRT_CALIBRATE(freq) do {  \
-  static volatile HRT_TIMESTAMP_T t1, t2; \
-  static volatile uint64_t elapsed_ticks, min = (uint64_t)(~0x1); \
-  int notsmaller=0; \
-  while(notsmaller<3) { \
-    HRT_GET_TIMESTAMP(t1); \
-    sleep(1); \
-    HRT_GET_TIMESTAMP(t2); \
-    HRT_GET_ELAPSED_TICKS(t1, t2, &elapsed_ticks); \
-    \
-    notsmaller++; \
-    if(elapsed_ticks<min) { \
-      min = elapsed_ticks; \
-      notsmaller = 0; \
-    } \
-  } \
-  freq = min; \
-} while(0);
-
-#define HRT_INIT(print, freq) do {\
-  if(print) printf("# initializing x86-64 timer (takes some seconds)\n"); \
-  HRT_CALIBRATE(freq); \
-} while(0)
-
-__inline__ unsigned long long rdtsc(void)
+static __inline__ unsigned long long rdtsc(void)
 {
     unsigned hi, lo;
     __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
     return ( (unsigned long long)lo)|( ((unsigned long long)hi)<<32 );
 }
 
-__inline__ unsigned long long rdtscp(void) {
+static __inline__ unsigned long long rdtscp(void) {
     unsigned long long tsc;
     __asm__ __volatile__("rdtscp; "         // serializing read of tsc
             "shl $32,%%rdx; "// shift higher 32 bits stored in rdx up
@@ -0,0 +1,241 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+ *
+ * Copyright (c) 2021 Stefan Christians
+ *
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mpi.h"
+#include <gsl/gsl_statistics.h>
+#include <gsl/gsl_sort.h>
+
+#include "reprompi_bench/misc.h"
+#include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/sync_topology.h"
+#include "reprompi_bench/sync/hca_sync/hca_sync.h"
+#include "reprompi_bench/sync/hca_sync/hca_parse_options.h"
+#include "rt_sync.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+enum {
+    RT_N_LATENCY_ROUNDS = 20    /* MPI_Allreduce calls used to estimate the latency for each job */
+};
+
+// the next round starts this many times the latency after the end of the slowest process
+static const double RT_LATENCY_FACTOR = 2.0;
+
+
+static double start_sync = 0;       /* start time of the current round (global time) */
+static int* invalid = NULL;
+static long repetition_counter = 0; /* current repetition index */
+
+// options specified from the command line
+static reprompi_rt_params_t parameters;
+
+static double latency_estimate_sec = 0;   /* agreement latency estimated at the start of the job */
+static double local_latency_sec = 0;      /* time from the end of the last round to the start check on this process */
+static double last_round_end = -1;        /* largest end time of the last round (-1 after a broadcast start time) */
+
+typedef struct {
+    long n_rounds;              /* measured repetitions */
+    long n_late_rounds;         /* repetitions that started late on any process */
+    double total_gap_sec;       /* summed time between the end of a round and the start of the next one */
+    double max_latency_sec;     /* largest agreement latency seen by any process */
+} rt_stats_t;
+
+static rt_stats_t stats;
+
+
+static double rt_get_global_time(void) {
+    return hca_get_normalized_time(hca_get_adjusted_time());
+}
+
+
+void rt_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
+    // the clock model and its options are shared with the HCA synchronization
+    hca_parse_options(argc, argv, opts_p);
+
+    if (opts_p->clock_tracking_interval > 0) {
+      reprompib_print_error_and_exit("Online clock tracking is not supported by the round-time synchronization");
+    }
+    if (opts_p->auto_window_batch > 0) {
+      reprompib_print_error_and_exit("The round-time synchronization does not use windows (--auto-window is not supported)");
+    }
+}
+
+
+void rt_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep) {
+    hca_init_synchronization_module(parsed_opts, nrep);
+
+    parameters.n_rep = nrep;
+    parameters.n_fitpoints = parsed_opts.n_fitpoints;
+    parameters.n_exchanges = parsed_opts.n_exchanges;
+    parameters.wait_time_sec = parsed_opts.wait_time_sec;
+    parameters.drift_bound_sec = parsed_opts.hca_drift_bound_sec;
+
+    invalid = (int*)calloc(parameters.n_rep, sizeof(int));
+    repetition_counter = 0;
+}
+
+
+/*
+ * median over RT_N_LATENCY_ROUNDS calls of the time between the last process
+ * entering an MPI_Allreduce and the last process leaving it
+ */
+static double estimate_agreement_latency(void) {
+    double latencies[RT_N_LATENCY_ROUNDS];
+    double max_latencies[RT_N_LATENCY_ROUNDS];
+    double entry_time, max_entry_time;
+    int i;
+
+    for (i = 0; i < RT_N_LATENCY_ROUNDS; i++) {
+        entry_time = rt_get_global_time();
+        MPI_Allreduce(&entry_time, &max_entry_time, 1, MPI_DOUBLE, MPI_MAX, icmb_global_communicator());
+        latencies[i] = rt_get_global_time() - max_entry_time;
+    }
+    MPI_Allreduce(latencies, max_latencies, RT_N_LATENCY_ROUNDS, MPI_DOUBLE, MPI_MAX,
+            icmb_global_communicator());
+
+    gsl_sort(max_latencies, 1, RT_N_LATENCY_ROUNDS);
+    return gsl_stats_median_from_sorted_data(max_latencies, 1, RT_N_LATENCY_ROUNDS);
+}
+
+
+void rt_init_synchronization(void) {
+    repetition_counter = 0;
+
+    latency_estimate_sec = estimate_agreement_latency();
+    if (latency_estimate_sec < 0) {     // within the error of the clock model
+        latency_estimate_sec = 0;
+    }
+    local_latency_sec = latency_estimate_sec;
+
+    rt_resume_synchronization();
+}
+
+
+/*
+ * the root broadcasts the start time of the next round
+ * without resetting the repetition counter
+ */
+void rt_resume_synchronization(void) {
+    int my_rank = icmb_global_rank();
+    int master_rank = 0;
+
+    if (my_rank == master_rank) {
+        start_sync = rt_get_global_time() + parameters.wait_time_sec;
+    }
+    MPI_Bcast(&start_sync, 1, MPI_DOUBLE, master_rank, icmb_global_communicator());
+    last_round_end = -1;
+}
+
+
+void rt_start_synchronization(void) {
+    int is_first = 1;
+
+    if (last_round_end >= 0) {
+        local_latency_sec = rt_get_global_time() - last_round_end;
+    }
+    while (rt_get_global_time() < start_sync) {
+        is_first = 0;
+    }
+    if (is_first == 1) {
+        invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
+    }
+}
+
+
+void rt_stop_synchronization(void) {
+    double local_times[3], max_times[3];
+    double margin;
+
+    // largest end time of this round, largest latency of the previous round
+    // (from its agreement to the start check), and whether any process started this round late
+    local_times[0] = rt_get_global_time();
+    local_times[1] = local_latency_sec;
+    local_times[2] = (invalid[repetition_counter] & FLAG_START_TIME_HAS_PASSED) ? 1 : 0;
+    MPI_Allreduce(local_times, max_times, 3, MPI_DOUBLE, MPI_MAX, icmb_global_communicator());
+    last_round_end = max_times[0];
+
+    // the estimate of the job bounds the margin from below, and an outlier
+    // latency only delays the round that immediately follows it
+    margin = latency_estimate_sec;
+    if (max_times[1] > margin) {
+        margin = max_times[1];
+    }
+    margin *= RT_LATENCY_FACTOR;
+    start_sync = max_times[0] + margin;
+
+    stats.n_rounds++;
+    if (max_times[2] > 0) {
+        stats.n_late_rounds++;
+    }
+    stats.total_gap_sec += margin;
+    if (max_times[1] > stats.max_latency_sec) {
+        stats.max_latency_sec = max_times[1];
+    }
+    repetition_counter++;
+}
+
+
+int* rt_get_local_sync_errorcodes(void) {
+    return invalid;
+}
+
+
+void rt_cleanup_synchronization_module(void) {
+    free(invalid);
+    invalid = NULL;
+    hca_cleanup_synchronization_module();
+}
+
+
+void rt_print_sync_parameters(FILE* f) {
+    fprintf(f, "#@sync=roundtime\n");
+    fprintf(f, "#@fitpoints=%d\n", parameters.n_fitpoints);
+    fprintf(f, "#@exchanges=%d\n", parameters.n_exchanges);
+    fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
+    fprintf(f, "#@rt_latency_factor=%.2f\n", RT_LATENCY_FACTOR);
+    reprompi_print_sync_topology(f);
+    if (parameters.drift_bound_sec > 0) {
+        fprintf(f, "#@hca_drift_bound_s=%.10f\n", parameters.drift_bound_sec);
+    }
+#ifdef ENABLE_LOGP_SYNC
+    fprintf(f, "#@hcasynctype=logp\n");
+#else
+    fprintf(f, "#@hcasynctype=linear\n");
+#endif
+}
+
+
+void rt_print_sync_statistics(FILE* f) {
+    hca_print_sync_statistics(f);
+
+    fprintf(f, "#@rt_rounds=%ld\n", stats.n_rounds);
+    fprintf(f, "#@rt_late_rounds=%ld\n", stats.n_late_rounds);
+    if (stats.n_rounds > 0) {
+        fprintf(f, "#@rt_mean_gap_s=%.10f\n", stats.total_gap_sec / stats.n_rounds);
+    }
+    fprintf(f, "#@rt_max_latency_s=%.10f\n", stats.max_latency_sec);
+}
@@ -0,0 +1,58 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef RT_SYNC_H_
+#define RT_SYNC_H_
+
+#include <stdio.h>
+#include "reprompi_bench/sync/sync_info.h"
+
+typedef struct {
+    long n_rep; /* --repetitions */
+
+    int n_fitpoints; /* --fitpoints */
+    int n_exchanges; /* --exchanges */
+
+    double wait_time_sec; /* --wait-time */
+    double drift_bound_sec; /* --hca-drift-bound */
+} reprompi_rt_params_t;
+
+/*
+ * round-time synchronization: the processes agree on the largest end time
+ * of each measurement and start the next one after it, plus the measured
+ * latency of that agreement; the global clocks are those of the HCA method
+ */
+void rt_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
+void rt_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p);
+void rt_init_synchronization(void);
+void rt_resume_synchronization(void);
+void rt_start_synchronization(void);
+void rt_stop_synchronization(void);
+void rt_cleanup_synchronization_module(void);
+
+int* rt_get_local_sync_errorcodes(void);
+
+void rt_print_sync_parameters(FILE* f);
+void rt_print_sync_statistics(FILE* f);
+
+#endif /* RT_SYNC_H_ */
@@ -33,6 +33,13 @@
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/sync_info.h"
 #include "sk_parse_options.h"
+#include "sk_sync.h"
+
+static char* const sk_offset_alg_names[] = {
+        [SK_OFFSETS_LINEAR] = "linear",
+        [SK_OFFSETS_TREE] = "tree",
+        NULL
+};
 
 void sk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
     int c;
@@ -62,6 +69,27 @@ void sk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
         case REPROMPI_ARGS_WINSYNC_WAITTIME: /* wait time before starting the first measurement  (in usec) */
             opts_p->wait_time_sec = atof(optarg) * 1e-6;
             break;
+
+        case REPROMPI_ARGS_WINSYNC_SK_OFFSETS: /* scheme used to measure the offsets to the root */
+        {
+            char* subopts = optarg;
+            char* value;
+
+            opts_p->sk_offset_alg = getsubopt(&subopts, sk_offset_alg_names, &value);
+            if (opts_p->sk_offset_alg < 0) {
+                reprompib_print_error_and_exit("Unknown SKaMPI offset scheme (should be linear or tree)");
+            }
+            break;
+        }
+
+        case REPROMPI_ARGS_WINSYNC_NODE_LEADERS: /* only one process per node learns the clock model */
+            opts_p->node_leaders_only = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_AUTO_WINDOW: /* repetitions between two adaptations of the window size */
+            opts_p->auto_window_batch = atoi(optarg);
+            break;
+
         case '?':
             break;
         }
@@ -74,6 +102,9 @@ void sk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
     if (opts_p->wait_time_sec <= 0) {
       reprompib_print_error_and_exit("Invalid wait time before the first window (should be positive)");
     }
+    if (opts_p->auto_window_batch < 0) {
+      reprompib_print_error_and_exit("Invalid window adaptation batch (should be a positive number of repetitions, or 0 for a fixed window)");
+    }
 
     optind = 1;	// reset optind to enable option re-parsing
     opterr = 1; // reset opterr
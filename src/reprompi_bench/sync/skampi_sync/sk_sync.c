@@ -41,6 +41,8 @@
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/time_measurement.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/sync_topology.h"
+#include "reprompi_bench/sync/window_adaptation.h"
 #include "sk_parse_options.h"
 #include "sk_sync.h"
 
@@ -59,10 +61,23 @@ static double *ping_pong_min_time; /* ping_pong_min_time[i] is the minimum time
  (in this case only a few ping-pongs are performed if the RTT stays
  within 110% for the ping_pong_min_time)
  */
+static int ping_pong_cache_size = 0; /* ping_pong_min_time is kept across jobs and re-synchronizations */
+
+enum {
+    PP_CALLS = 0,           /* ping_pong calls */
+    PP_CACHE_HITS,          /* calls with a known minimum ping-pong time */
+    PP_EXCHANGES,           /* ping-pong exchanges performed */
+    PP_N_COUNTERS
+};
+static long pp_counters[PP_N_COUNTERS];        /* counted by p1 during the current synchronization */
+static long pp_total_counters[PP_N_COUNTERS];  /* summed over all synchronizations and processes (on the root) */
 
 double start_batch, start_sync, stop_sync;
 static int sync_index = 0; /* current window index within the current measurement batch */
 
+// adaptive window size (enabled with --auto-window)
+static reprompi_window_adapter_t window_adapter;
+
 // options specified from the command line
 static reprompi_sk_options_t parameters;
 
@@ -78,6 +93,8 @@ void sk_init_synchronization_module(const reprompib_sync_options_t opts_p, const
 
     parameters.wait_time_sec = opts_p.wait_time_sec;
     parameters.window_size_sec = opts_p.window_size_sec;
+    parameters.offset_alg = (sk_offset_alg_t)opts_p.sk_offset_alg;
+    parameters.node_leaders_only = opts_p.node_leaders_only;
     parameters.n_rep = nrep;
 
     tds = (double*) skampi_malloc(np * sizeof(double));
@@ -90,6 +107,9 @@ void sk_init_synchronization_module(const reprompib_sync_options_t opts_p, const
     }
     repetition_counter = 0;
 
+    reprompi_init_sync_topology(parameters.node_leaders_only);
+    reprompi_window_adapter_init(&window_adapter, opts_p.auto_window_batch,
+            parameters.window_size_sec, parameters.wait_time_sec, parameters.n_rep);
 }
 
 void print_global_time_differences() {
@@ -149,21 +169,16 @@ static void ping_pong(int p1, int p2, int my_rank, int np) {
     MPI_Status status;
     int pp_tag = 43;
 
-    ping_pong_min_time = (double*) skampi_malloc(
-            np * sizeof(double));
-    for (i = 0; i < np; i++)
-        ping_pong_min_time[i] = -1.0;
-
     /* I had to unroll the main loop because I didn't find a portable way
      to define the initial td_min and td_max with INFINITY and NINFINITY */
     if (my_rank == p1) {
         other_global_id = p2;
 
         s_last = get_time();
-        MPI_Send(&s_last, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
-        MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator(), &status);
+        MPI_Send(&s_last, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
+        MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm(), &status);
         s_now = get_time();
-        MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
+        MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
 
         td_min = t_last - s_now;
         td_max = t_last - s_last;
@@ -171,10 +186,10 @@ static void ping_pong(int p1, int p2, int my_rank, int np) {
     } else {
         other_global_id = p1;
 
-        MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator(), &status);
+        MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm(), &status);
         t_last = get_time();
-        MPI_Send(&t_last, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator());
-        MPI_Recv(&s_now, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator(), &status);
+        MPI_Send(&t_last, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm());
+        MPI_Recv(&s_now, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm(), &status);
         t_now = get_time();
 
         td_min = s_last - t_last;
@@ -187,7 +202,7 @@ static void ping_pong(int p1, int p2, int my_rank, int np) {
         i = 1;
         while (1) {
 
-            MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator(),
+            MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm(),
                     &status);
             if (t_last < 0.0) {
                 break;
@@ -204,23 +219,23 @@ static void ping_pong(int p1, int p2, int my_rank, int np) {
                     && s_now - s_last
                     < ping_pong_min_time[other_global_id] * 1.10) {
                 MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag,
-                        icmb_global_communicator());
+                        reprompi_sync_comm());
                 break;
             }
             i++;
             if (i == Number_ping_pongs) {
                 MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag,
-                        icmb_global_communicator());
+                        reprompi_sync_comm());
                 break;
             }
-            MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, icmb_global_communicator());
+            MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, reprompi_sync_comm());
 
         }
     } else {
         i = 1;
         while (1) {
-            MPI_Send(&t_now, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator());
-            MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, icmb_global_communicator(),
+            MPI_Send(&t_now, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm());
+            MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, reprompi_sync_comm(),
                     &status);
             t_last = t_now;
             t_now = get_time();
@@ -237,13 +252,21 @@ static void ping_pong(int p1, int p2, int my_rank, int np) {
                     && t_now - t_last
                     < ping_pong_min_time[other_global_id] * 1.10) {
                 MPI_Send(&invalid_time, 1, MPI_DOUBLE, p1, pp_tag,
-                        icmb_global_communicator());
+                        reprompi_sync_comm());
                 break;
             }
             i++;
         }
     }
 
+    if (my_rank == p1) {
+        pp_counters[PP_CALLS]++;
+        pp_counters[PP_EXCHANGES] += i;
+        if (ping_pong_min_time[other_global_id] >= 0.0) {
+            pp_counters[PP_CACHE_HITS]++;
+        }
+    }
+
     if (ping_pong_min_time[other_global_id] < 0.0) {
         ping_pong_min_time[other_global_id] = td_max - td_min;
     }
@@ -254,20 +277,91 @@ static void ping_pong(int p1, int p2, int my_rank, int np) {
 
     tds[other_global_id] = (td_min + td_max) / 2.0;
 
-    free(ping_pong_min_time);
+}
+
+static void init_ping_pong_cache(int np) {
+    int i;
 
+    if (ping_pong_cache_size == np) {
+        return;
+    }
+    free(ping_pong_min_time);
+    ping_pong_min_time = (double*) skampi_malloc(np * sizeof(double));
+    for (i = 0; i < np; i++)
+        ping_pong_min_time[i] = -1.0;
+    ping_pong_cache_size = np;
 }
 
-void determine_time_differences(int my_rank, int np) {
+static void measure_offsets_linear(int my_rank, int np) {
     int i;
-    double *tmp_tds;
 
     //  measure ping-pong time between processes 0 and i
     for (i = 1; i < np; i++) {
-        MPI_Barrier(icmb_global_communicator());
+        MPI_Barrier(reprompi_sync_comm());
         if (my_rank == 0 || my_rank == i)
             ping_pong(0, i, my_rank, np);
     }
+}
+
+/*
+ * measures the offsets along a binomial tree: in round k, every process r
+ * with r % 2^(k+1) == 0 runs a ping-pong with r + 2^k, so that all pairs
+ * of a round measure concurrently; the root then composes the offset of
+ * each process from the offsets of its ancestors, and stores them in tds
+ */
+static void measure_offsets_tree(int my_rank, int np) {
+    int i, step, parent;
+    double offset_to_parent = 0;
+    double *offsets = NULL;
+
+    for (step = 1; step < np; step *= 2) {
+        MPI_Barrier(reprompi_sync_comm());
+        if (my_rank % (2 * step) == 0) {
+            if (my_rank + step < np) {
+                ping_pong(my_rank, my_rank + step, my_rank, np);
+            }
+        }
+        else if (my_rank % (2 * step) == step) {
+            parent = my_rank - step;
+            ping_pong(parent, my_rank, my_rank, np);
+            offset_to_parent = -tds[parent];
+        }
+    }
+
+    if (my_rank == 0) {
+        offsets = (double*) skampi_malloc(np * sizeof(double));
+    }
+    MPI_Gather(&offset_to_parent, 1, MPI_DOUBLE, offsets, 1, MPI_DOUBLE, 0,
+            reprompi_sync_comm());
+
+    if (my_rank == 0) {
+        // the parent of i (i with its lowest set bit cleared) is always smaller than i
+        offsets[0] = 0.0;
+        for (i = 1; i < np; i++) {
+            parent = i & (i - 1);
+            offsets[i] = offsets[parent] + offsets[i];
+            tds[i] = offsets[i];
+        }
+        free(offsets);
+    }
+}
+
+void determine_time_differences(int my_rank, int np) {
+    int i;
+    double *tmp_tds;
+    long total_counters[PP_N_COUNTERS];
+
+    init_ping_pong_cache(np);
+    for (i = 0; i < PP_N_COUNTERS; i++) {
+        pp_counters[i] = 0;
+    }
+
+    if (parameters.offset_alg == SK_OFFSETS_TREE) {
+        measure_offsets_tree(my_rank, np);
+    }
+    else {
+        measure_offsets_linear(my_rank, np);
+    }
 
     // send root time differences to all the other processes
     tmp_tds = (double*) skampi_malloc(np * sizeof(double));
@@ -278,16 +372,28 @@ void determine_time_differences(int my_rank, int np) {
 
     assert(np - 1 >= 0);
     MPI_Bcast(&(tmp_tds[1]), np - 1, MPI_DOUBLE, 0,
-            icmb_global_communicator());
+            reprompi_sync_comm());
 
     // update local time differences
     if (my_rank != 0) {
+        if (parameters.offset_alg == SK_OFFSETS_TREE) {
+            // the offset to the root was composed along the tree
+            tds[0] = -tmp_tds[my_rank];
+        }
         for (i = 1; i < np; i++) {
             tds[i] = tmp_tds[i] + tds[0];
         }
     }
     free(tmp_tds);
-    MPI_Barrier(icmb_global_communicator());
+
+    MPI_Reduce(pp_counters, total_counters, PP_N_COUNTERS, MPI_LONG, MPI_SUM, 0,
+            reprompi_sync_comm());
+    if (my_rank == 0) {
+        for (i = 0; i < PP_N_COUNTERS; i++) {
+            pp_total_counters[i] += total_counters[i];
+        }
+    }
+    MPI_Barrier(reprompi_sync_comm());
 
 }
 
@@ -311,16 +417,30 @@ inline double should_wait_till(int counter, double interval, double offset) {
 }
 
 void sk_sync_clocks(void) {
-    int my_rank = icmb_global_rank();
-    int np = icmb_global_size();
+    int my_rank = reprompi_sync_rank();
+    int np = reprompi_sync_size();
+
+    if (reprompi_is_sync_participant()) {
+        determine_time_differences(my_rank, np);
+    }
 
-    determine_time_differences(my_rank, np);
+    // with node-leader synchronization, tds[i] refers to the leader of the i-th node
+    reprompi_share_sync_model(tds, icmb_global_size(), MPI_DOUBLE);
 }
 
 void sk_init_synchronization(void) {
+    repetition_counter = 0;
+    sk_resume_synchronization();
+}
+
+/*
+ * starts a new batch of windows after the current time (on the root)
+ * without resetting the repetition counter
+ */
+void sk_resume_synchronization(void) {
     int my_rank = icmb_global_rank();
 
-    repetition_counter = 0;
+    sync_index = 0;
     if (my_rank == 0) {
         start_batch = get_time() + parameters.wait_time_sec;
     }
@@ -341,6 +461,8 @@ void sk_start_synchronization(void) {
 }
 
 void sk_stop_synchronization(void) {
+    double next_start;
+
     stop_sync = get_time();
 
     if (stop_sync - start_sync > parameters.window_size_sec) {
@@ -349,6 +471,13 @@ void sk_stop_synchronization(void) {
 
     repetition_counter++;
     sync_index++;
+
+    // a new batch of windows starts after each adaptation of the window size (times of the root)
+    if (reprompi_window_adapter_record(&window_adapter, stop_sync - start_sync, stop_sync + tds[0], &next_start)) {
+        parameters.window_size_sec = window_adapter.window_sec;
+        start_batch = next_start - parameters.window_size_sec;
+        sync_index = 0;
+    }
 }
 
 void print_sync_results(void) {
@@ -380,15 +509,37 @@ int* sk_get_local_sync_errorcodes(void) {
     return invalid;
 }
 
+double* sk_get_window_sizes(void) {
+    return reprompi_window_adapter_get_windows(&window_adapter);
+}
+
 void sk_cleanup_synchronization_module(void) {
     free(tds);
     free(invalid);
+    reprompi_window_adapter_cleanup(&window_adapter);
 }
 
 void sk_print_sync_parameters(FILE* f) {
     fprintf(f, "#@sync=SKaMPI\n");
     fprintf(f, "#@window_s=%.10f\n", parameters.window_size_sec);
     fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
+    if (parameters.offset_alg == SK_OFFSETS_TREE) {
+        fprintf(f, "#@sk_offsets=tree\n");
+    }
+    reprompi_print_sync_topology(f);
+    reprompi_window_adapter_print(&window_adapter, f);
+}
+
+void sk_print_sync_statistics(FILE* f) {
+    long saved = pp_total_counters[PP_CALLS] * Number_ping_pongs - pp_total_counters[PP_EXCHANGES];
+
+    fprintf(f, "#@sk_pingpongs=%ld\n", pp_total_counters[PP_CALLS]);
+    if (pp_total_counters[PP_CALLS] > 0) {
+        fprintf(f, "#@sk_pingpong_cache_hit_rate=%.4f\n",
+                (double)pp_total_counters[PP_CACHE_HITS] / pp_total_counters[PP_CALLS]);
+    }
+    fprintf(f, "#@sk_pingpong_exchanges=%ld\n", pp_total_counters[PP_EXCHANGES]);
+    fprintf(f, "#@sk_pingpong_exchanges_saved=%ld\n", saved);
 }
 
 inline double sk_get_timediff_to_root(void) {
@@ -399,6 +550,15 @@ inline double sk_get_normalized_time(double local_time) {
     return local_time + tds[0];
 }
 
+void sk_get_normalized_times(const double* restrict local_times, double* restrict global_times, long n) {
+    const double td = tds[0];
+    long i;
+
+    for (i = 0; i < n; i++) {
+        global_times[i] = local_times[i] + td;
+    }
+}
+
 
 void* skampi_malloc(int size) {
     void *baseptr = NULL;
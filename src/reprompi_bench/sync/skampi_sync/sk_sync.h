@@ -31,27 +31,38 @@
 
 #include "reprompi_bench/sync/sync_info.h"
 
+typedef enum {
+    SK_OFFSETS_LINEAR = 0,  /* root measures the offset to every process in turn */
+    SK_OFFSETS_TREE         /* disjoint pairs measure concurrently along a binomial tree */
+} sk_offset_alg_t;
+
 typedef struct {
     long n_rep; /* --repetitions */
     double window_size_sec; /* --window-size */
 
     double wait_time_sec; /* --wait-time */
+    sk_offset_alg_t offset_alg; /* --sk-offsets */
+    int node_leaders_only; /* --node-leader-sync */
 } reprompi_sk_options_t;
 
 
 void sk_init_synchronization_module(const reprompib_sync_options_t opts_p, const long nrep);
 void sk_sync_clocks(void);
 void sk_init_synchronization(void);
+void sk_resume_synchronization(void);
 void sk_start_synchronization(void);
 void sk_stop_synchronization(void);
 void sk_cleanup_synchronization_module(void);
 
 int* sk_get_local_sync_errorcodes(void);
+double* sk_get_window_sizes(void);
 
 double sk_get_timediff_to_root(void);
 double sk_get_normalized_time(double local_time);
+void sk_get_normalized_times(const double* local_times, double* global_times, long n);
 
 void sk_print_sync_parameters(FILE* f);
+void sk_print_sync_statistics(FILE* f);
 
 double should_wait_till(int counter, double interval, double offset);
 
@@ -33,6 +33,7 @@ const int REPROMPI_SYNC_N_EXCHANGES_DEFAULT = 10;
 
 const double REPROMPI_SYNC_WAIT_TIME_SEC_DEFAULT = 1e-3;
 const double REPROMPI_SYNC_WIN_SIZE_SEC_DEFAULT = 1e-3;
+const double REPROMPI_SYNC_HCA_DRIFT_BOUND_SEC_DEFAULT = 0;   // re-learn the model for every job
 
 
 const struct option reprompi_sync_long_options[] = {
@@ -40,6 +41,13 @@ const struct option reprompi_sync_long_options[] = {
         { "fitpoints", required_argument, 0, REPROMPI_ARGS_WINSYNC_NFITPOINTS },
         { "exchanges", required_argument, 0, REPROMPI_ARGS_WINSYNC_NEXCHANGES },
         { "wait-time", required_argument, 0, REPROMPI_ARGS_WINSYNC_WAITTIME },
+        { "hca-drift-bound", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_DRIFT_BOUND },
+        { "sk-offsets", required_argument, 0, REPROMPI_ARGS_WINSYNC_SK_OFFSETS },
+        { "jk-models", required_argument, 0, REPROMPI_ARGS_WINSYNC_JK_MODELS },
+        { "node-leader-sync", no_argument, 0, REPROMPI_ARGS_WINSYNC_NODE_LEADERS },
+        { "clock-tracking", required_argument, 0, REPROMPI_ARGS_WINSYNC_CLOCK_TRACKING },
+        { "auto-window", required_argument, 0, REPROMPI_ARGS_WINSYNC_AUTO_WINDOW },
+        { "bbarrier-alg", required_argument, 0, REPROMPI_ARGS_WINSYNC_BBARRIER_ALG },
         { 0, 0, 0, 0 }
 };
 const char reprompi_sync_opts_str[] = "";
@@ -52,5 +60,12 @@ void reprompi_init_sync_parameters(reprompib_sync_options_t* opts_p) {
   opts_p->n_fitpoints = REPROMPI_SYNC_N_FITPOINTS_DEFAULT;
   opts_p->n_exchanges = REPROMPI_SYNC_N_EXCHANGES_DEFAULT;
   opts_p->wait_time_sec = REPROMPI_SYNC_WAIT_TIME_SEC_DEFAULT;
+  opts_p->hca_drift_bound_sec = REPROMPI_SYNC_HCA_DRIFT_BOUND_SEC_DEFAULT;
+  opts_p->sk_offset_alg = 0;    // offsets measured sequentially by the root
+  opts_p->jk_model_alg = 0;     // models learned against the root
+  opts_p->node_leaders_only = 0;
+  opts_p->clock_tracking_interval = 0;  // no online tracking of the clock model
+  opts_p->auto_window_batch = 0;        // fixed window size
+  opts_p->bbarrier_alg = 0;             // dissemination barrier
 
 }
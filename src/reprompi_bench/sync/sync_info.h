@@ -38,6 +38,13 @@ typedef struct {
     int n_exchanges; /* --exchanges */
 
     double wait_time_sec; /* --wait-time */
+    double hca_drift_bound_sec; /* --hca-drift-bound */
+    int sk_offset_alg; /* --sk-offsets */
+    int jk_model_alg; /* --jk-models */
+    int node_leaders_only; /* --node-leader-sync */
+    int clock_tracking_interval; /* --clock-tracking */
+    int auto_window_batch; /* --auto-window */
+    int bbarrier_alg; /* --bbarrier-alg */
 } reprompib_sync_options_t;
 
 
@@ -45,7 +52,14 @@ typedef enum reprompi_win_sync_getopt_ids {
   REPROMPI_ARGS_WINSYNC_WIN_SIZE = 700,
   REPROMPI_ARGS_WINSYNC_NFITPOINTS,
   REPROMPI_ARGS_WINSYNC_NEXCHANGES,
-  REPROMPI_ARGS_WINSYNC_WAITTIME
+  REPROMPI_ARGS_WINSYNC_WAITTIME,
+  REPROMPI_ARGS_WINSYNC_HCA_DRIFT_BOUND,
+  REPROMPI_ARGS_WINSYNC_SK_OFFSETS,
+  REPROMPI_ARGS_WINSYNC_JK_MODELS,
+  REPROMPI_ARGS_WINSYNC_NODE_LEADERS,
+  REPROMPI_ARGS_WINSYNC_CLOCK_TRACKING,
+  REPROMPI_ARGS_WINSYNC_AUTO_WINDOW,
+  REPROMPI_ARGS_WINSYNC_BBARRIER_ALG
 } reprompi_win_sync_getopt_ids_t;
 
 extern const struct option reprompi_sync_long_options[];
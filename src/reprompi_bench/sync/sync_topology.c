@@ -0,0 +1,138 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+ *
+ * Copyright (c) 2021 Stefan Christians
+ *
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+ */
+
+
+#include <stdio.h>
+#include "mpi.h"
+
+#include "sync_topology.h"
+#include "reprompi_bench/utils/node_topology.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+/*
+ * Processes on the same node read the same clock, so with node-leader
+ * synchronization only one process per node (the one with the lowest
+ * global rank) learns the clock model. The other processes of the node
+ * receive the model of their leader through the node communicator.
+ */
+
+static int node_leaders_only = 0;
+static int topology_initialized = 0;
+
+static MPI_Comm node_comm = MPI_COMM_NULL;      /* processes on the same node */
+static MPI_Comm leader_comm = MPI_COMM_NULL;    /* one leader per node (MPI_COMM_NULL on other processes) */
+
+
+// called at the beginning of MPI_Finalize, while MPI can still be used
+static int free_topology_at_finalize(MPI_Comm comm, int keyval, void* attribute_val, void* extra_state) {
+    reprompi_cleanup_sync_topology();
+    return MPI_SUCCESS;
+}
+
+
+void reprompi_init_sync_topology(int enable_node_leaders) {
+    int keyval;
+
+    // each sync module selects whether only node leaders synchronize
+    node_leaders_only = enable_node_leaders;
+    if (!node_leaders_only || topology_initialized) {
+        return;
+    }
+    topology_initialized = 1;
+
+    reprompib_init_node_topology();
+    node_comm = reprompib_get_node_comm();
+    leader_comm = reprompib_get_leader_comm();
+
+    // the communicators are kept for all jobs and freed at the end of the program
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, free_topology_at_finalize, &keyval, NULL);
+    MPI_Comm_set_attr(MPI_COMM_SELF, keyval, NULL);
+    MPI_Comm_free_keyval(&keyval);
+}
+
+
+void reprompi_cleanup_sync_topology(void) {
+    if (topology_initialized) {
+        reprompib_cleanup_node_topology();
+    }
+    node_comm = MPI_COMM_NULL;
+    leader_comm = MPI_COMM_NULL;
+    node_leaders_only = 0;
+    topology_initialized = 0;
+}
+
+
+MPI_Comm reprompi_sync_comm(void) {
+    if (node_leaders_only) {
+        return leader_comm;
+    }
+    return icmb_global_communicator();
+}
+
+
+int reprompi_sync_rank(void) {
+    int rank = -1;
+
+    if (!node_leaders_only) {
+        return icmb_global_rank();
+    }
+    if (leader_comm != MPI_COMM_NULL) {
+        MPI_Comm_rank(leader_comm, &rank);
+    }
+    return rank;
+}
+
+
+int reprompi_sync_size(void) {
+    int size = 0;
+
+    if (!node_leaders_only) {
+        return icmb_global_size();
+    }
+    if (leader_comm != MPI_COMM_NULL) {
+        MPI_Comm_size(leader_comm, &size);
+    }
+    return size;
+}
+
+
+int reprompi_is_sync_participant(void) {
+    return (reprompi_sync_comm() != MPI_COMM_NULL);
+}
+
+
+void reprompi_share_sync_model(void* buf, int count, MPI_Datatype datatype) {
+    if (node_leaders_only) {
+        MPI_Bcast(buf, count, datatype, 0, node_comm);
+    }
+}
+
+
+void reprompi_print_sync_topology(FILE* f) {
+    if (node_leaders_only) {
+        fprintf(f, "#@sync_node_leaders=%d\n", reprompi_sync_size());
+    }
+}
@@ -0,0 +1,53 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_SYNC_TOPOLOGY_H_
+#define REPROMPIB_SYNC_TOPOLOGY_H_
+
+#include <stdio.h>
+#include "mpi.h"
+
+/*
+ * creates the node and node-leader communicators with the first sync module
+ * (collective over all processes); they are kept for all jobs and released
+ * by reprompi_cleanup_sync_topology() when MPI is finalized
+ */
+void reprompi_init_sync_topology(int enable_node_leaders);
+void reprompi_cleanup_sync_topology(void);
+
+/*
+ * communicator, rank and size of the processes taking part in the clock
+ * synchronization: the global communicator, or the node leaders only
+ * (MPI_COMM_NULL, -1 and 0 on the other processes)
+ */
+MPI_Comm reprompi_sync_comm(void);
+int reprompi_sync_rank(void);
+int reprompi_sync_size(void);
+int reprompi_is_sync_participant(void);
+
+/* broadcasts the clock model of the node leader to the other processes of its node */
+void reprompi_share_sync_model(void* buf, int count, MPI_Datatype datatype);
+
+void reprompi_print_sync_topology(FILE* f);
+
+#endif /* REPROMPIB_SYNC_TOPOLOGY_H_ */
@@ -25,145 +25,350 @@
 
 
 
+// avoid getsubopt bug
+#define _XOPEN_SOURCE 500
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
 #include "mpi.h"
 
+#include "reprompi_bench/misc.h"
 #include "synchronization.h"
 #include "time_measurement.h"
+#include "sync_topology.h"
 
-#ifdef ENABLE_WINDOWSYNC_SK
 #include "skampi_sync/sk_sync.h"
 #include "skampi_sync/sk_parse_options.h"
-
-#elif defined ENABLE_WINDOWSYNC_JK
 #include "joneskoenig_sync/jk_sync.h"
 #include "joneskoenig_sync/jk_parse_options.h"
-
-#elif defined ENABLE_WINDOWSYNC_HCA
-#include "hca_sync/hca_sync.h"
-#include "hca_sync/hca_parse_options.h"
-
-#elif defined ENABLE_GLOBAL_TIMES
 #include "hca_sync/hca_sync.h"
 #include "hca_sync/hca_parse_options.h"
+#include "roundtime_sync/rt_sync.h"
+#include "benchmark_barrier_sync/bbarrier_sync.h"
 #include "mpibarrier_sync/barrier_sync.h"
-#endif
 
-#ifdef ENABLE_BENCHMARK_BARRIER
-#include "benchmark_barrier_sync/bbarrier_sync.h"
-#endif
+enum {
+  REPROMPI_ARGS_SYNC_METHOD = 750
+};
 
-#ifndef ENABLE_WINDOWSYNC
-#include "mpibarrier_sync/barrier_sync.h"
+static const struct option sync_method_long_options[] = {
+        { "sync", required_argument, 0, REPROMPI_ARGS_SYNC_METHOD },
+        { 0, 0, 0, 0 }
+};
+
+// names accepted by --sync (same order as reprompi_sync_method_t)
+static char* const sync_method_names[] = {
+        [REPROMPI_SYNC_MPIBARRIER] = "mpibarrier",
+        [REPROMPI_SYNC_BBARRIER] = "bbarrier",
+        [REPROMPI_SYNC_SKAMPI] = "sk",
+        [REPROMPI_SYNC_JK] = "jk",
+        [REPROMPI_SYNC_HCA] = "hca",
+        [REPROMPI_SYNC_HCA_GLOBAL] = "hca-global",
+        [REPROMPI_SYNC_ROUNDTIME] = "roundtime",
+        NULL
+};
+
+#if defined ENABLE_WINDOWSYNC_SK
+static const reprompi_sync_method_t default_sync_method = REPROMPI_SYNC_SKAMPI;
+#elif defined ENABLE_WINDOWSYNC_JK
+static const reprompi_sync_method_t default_sync_method = REPROMPI_SYNC_JK;
+#elif defined ENABLE_WINDOWSYNC_HCA
+static const reprompi_sync_method_t default_sync_method = REPROMPI_SYNC_HCA;
+#elif defined ENABLE_GLOBAL_TIMES
+static const reprompi_sync_method_t default_sync_method = REPROMPI_SYNC_HCA_GLOBAL;
+#elif defined ENABLE_BENCHMARK_BARRIER
+static const reprompi_sync_method_t default_sync_method = REPROMPI_SYNC_BBARRIER;
+#else
+static const reprompi_sync_method_t default_sync_method = REPROMPI_SYNC_MPIBARRIER;
 #endif
 
+
 void no_op(void) {
 
 }
 
 
-#ifdef ENABLE_WINDOWSYNC_SK
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
+static void init_skampi_sync(reprompib_sync_functions_t *sync_f)
 {
     sync_f->init_sync_module = sk_init_synchronization_module;
     sync_f->init_sync = sk_init_synchronization;
+    sync_f->resume_sync = sk_resume_synchronization;
     sync_f->sync_clocks = sk_sync_clocks;
     sync_f->start_sync = sk_start_synchronization;
     sync_f->stop_sync = sk_stop_synchronization;
     sync_f->clean_sync_module = sk_cleanup_synchronization_module;
     sync_f->get_normalized_time = sk_get_normalized_time;
+    sync_f->get_normalized_times = sk_get_normalized_times;
     sync_f->get_errorcodes = sk_get_local_sync_errorcodes;
+    sync_f->get_uncertainties = NULL;
+    sync_f->get_window_sizes = sk_get_window_sizes;
     sync_f->print_sync_info = sk_print_sync_parameters;
     sync_f->get_time = get_time;
     sync_f->parse_sync_params = sk_parse_options;
+    sync_f->print_sync_stats = sk_print_sync_statistics;
+    sync_f->clocktype = REPROMPI_CLOCKS_GLOBAL;
 }
 
-#elif defined ENABLE_WINDOWSYNC_JK
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
+static void init_jk_sync(reprompib_sync_functions_t *sync_f)
 {
     sync_f->init_sync_module = jk_init_synchronization_module;
     sync_f->init_sync = jk_init_synchronization;
+    sync_f->resume_sync = jk_resume_synchronization;
     sync_f->sync_clocks = jk_sync_clocks;
     sync_f->start_sync = jk_start_synchronization;
     sync_f->stop_sync = jk_stop_synchronization;
     sync_f->clean_sync_module = jk_cleanup_synchronization_module;
     sync_f->get_normalized_time = jk_get_normalized_time;
+    sync_f->get_normalized_times = jk_get_normalized_times;
     sync_f->get_errorcodes = jk_get_local_sync_errorcodes;
+    sync_f->get_uncertainties = jk_get_local_model_uncertainties;
+    sync_f->get_window_sizes = jk_get_window_sizes;
     sync_f->print_sync_info = jk_print_sync_parameters;
     sync_f->get_time = get_time;
     sync_f->parse_sync_params = jk_parse_options;
+    sync_f->print_sync_stats = NULL;
+    sync_f->clocktype = REPROMPI_CLOCKS_GLOBAL;
 }
 
-#elif defined ENABLE_WINDOWSYNC_HCA
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
+static void init_hca_sync(reprompib_sync_functions_t *sync_f)
 {
     sync_f->init_sync_module = hca_init_synchronization_module;
     sync_f->sync_clocks = hca_synchronize_clocks;
     sync_f->init_sync = hca_init_synchronization;
+    sync_f->resume_sync = hca_resume_synchronization;
     sync_f->clean_sync_module = hca_cleanup_synchronization_module;
     sync_f->get_normalized_time = hca_get_normalized_time;
+    sync_f->get_normalized_times = hca_get_normalized_times;
     sync_f->get_errorcodes = hca_get_local_sync_errorcodes;
+    sync_f->get_uncertainties = hca_get_local_model_uncertainties;
+    sync_f->get_window_sizes = hca_get_window_sizes;
 
     sync_f->print_sync_info = hca_print_sync_parameters;
     sync_f->start_sync = hca_start_synchronization;
     sync_f->stop_sync = hca_stop_synchronization;
     sync_f->get_time = hca_get_adjusted_time;
     sync_f->parse_sync_params = hca_parse_options;
+    sync_f->print_sync_stats = hca_print_sync_statistics;
+    sync_f->clocktype = REPROMPI_CLOCKS_GLOBAL;
 }
 
-#elif defined ENABLE_GLOBAL_TIMES // barrier sync with HCA-global times
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
+
+/*
+ * hca-global synchronizes the processes with MPI_Barrier, or with the
+ * benchmark barrier if --bbarrier-alg is given (or ENABLE_BENCHMARK_BARRIER
+ * is set at compile time)
+ */
+#if defined ENABLE_BENCHMARK_BARRIER
+static int hca_global_bbarrier = 1;
+#else
+static int hca_global_bbarrier = 0;
+#endif
+
+static void hca_global_parse_options(int argc, char** argv, reprompib_sync_options_t* opts_p)
 {
-    sync_f->init_sync_module = hca_init_synchronization_module;
+    hca_parse_options(argc, argv, opts_p);
+    bbarrier_parse_alg(argc, argv, opts_p);
+}
+
+static void hca_global_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep)
+{
+    hca_init_synchronization_module(parsed_opts, nrep);
+    if (hca_global_bbarrier) {
+        bbarrier_init_synchronization_module(parsed_opts, nrep);
+    }
+}
+
+static void hca_global_cleanup_synchronization_module(void)
+{
+    if (hca_global_bbarrier) {
+        bbarrier_cleanup_synchronization_module();
+    }
+    hca_cleanup_synchronization_module();
+}
+
+static void hca_global_print_sync_parameters(FILE* f)
+{
+    if (hca_global_bbarrier) {
+        bbarrier_print_sync_parameters(f);
+    } else {
+        mpibarrier_print_sync_parameters(f);
+    }
+    reprompi_print_sync_topology(f);
+#ifdef ENABLE_LOGP_SYNC
+    fprintf(f, "#@hcasynctype=logp\n");
+#else
+    fprintf(f, "#@hcasynctype=linear\n");
+#endif
+}
+
+// barrier sync with HCA-global times
+static void init_hca_global_sync(reprompib_sync_functions_t *sync_f, int argc, char** argv)
+{
+    reprompib_sync_options_t opts;
+
+    reprompi_init_sync_parameters(&opts);
+    if (bbarrier_parse_alg(argc, argv, &opts)) {
+        hca_global_bbarrier = 1;
+    }
+
+    sync_f->init_sync_module = hca_global_init_synchronization_module;
     sync_f->sync_clocks = hca_synchronize_clocks;
     sync_f->init_sync = hca_init_synchronization;
-    sync_f->clean_sync_module = hca_cleanup_synchronization_module;
+    sync_f->resume_sync = no_op;
+    sync_f->clean_sync_module = hca_global_cleanup_synchronization_module;
     sync_f->get_normalized_time = hca_get_normalized_time;
+    sync_f->get_normalized_times = hca_get_normalized_times;
     sync_f->get_errorcodes = hca_get_local_sync_errorcodes;
+    sync_f->get_uncertainties = NULL;
+    sync_f->get_window_sizes = NULL;
     sync_f->get_time = hca_get_adjusted_time;
-    sync_f->parse_sync_params = hca_parse_options;
+    sync_f->parse_sync_params = hca_global_parse_options;
+    sync_f->print_sync_info = hca_global_print_sync_parameters;
 
-#if defined ENABLE_BENCHMARK_BARRIER
-    sync_f->print_sync_info = bbarrier_print_sync_parameters;
-    sync_f->start_sync = bbarrier_start_synchronization;
-    sync_f->stop_sync = bbarrier_stop_synchronization;
-#else	// MPI_Barrier sync
-    sync_f->print_sync_info = mpibarrier_print_sync_parameters;
-    sync_f->start_sync = mpibarrier_start_synchronization;
-    sync_f->stop_sync = mpibarrier_stop_synchronization;
-#endif
+    if (hca_global_bbarrier) {
+        sync_f->start_sync = bbarrier_start_synchronization;
+        sync_f->stop_sync = bbarrier_stop_synchronization;
+    } else {
+        sync_f->start_sync = mpibarrier_start_synchronization;
+        sync_f->stop_sync = mpibarrier_stop_synchronization;
+    }
+    sync_f->print_sync_stats = hca_print_sync_statistics;
+    sync_f->clocktype = REPROMPI_CLOCKS_GLOBAL;
 }
 
-#elif defined ENABLE_BENCHMARK_BARRIER
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
+// round-time sync with the HCA clock models
+static void init_roundtime_sync(reprompib_sync_functions_t *sync_f)
+{
+    sync_f->init_sync_module = rt_init_synchronization_module;
+    sync_f->sync_clocks = hca_synchronize_clocks;
+    sync_f->init_sync = rt_init_synchronization;
+    sync_f->resume_sync = rt_resume_synchronization;
+    sync_f->start_sync = rt_start_synchronization;
+    sync_f->stop_sync = rt_stop_synchronization;
+    sync_f->clean_sync_module = rt_cleanup_synchronization_module;
+    sync_f->get_normalized_time = hca_get_normalized_time;
+    sync_f->get_normalized_times = hca_get_normalized_times;
+    sync_f->get_errorcodes = rt_get_local_sync_errorcodes;
+    sync_f->get_uncertainties = NULL;
+    sync_f->get_window_sizes = NULL;
+    sync_f->print_sync_info = rt_print_sync_parameters;
+    sync_f->get_time = hca_get_adjusted_time;
+    sync_f->parse_sync_params = rt_parse_options;
+    sync_f->print_sync_stats = rt_print_sync_statistics;
+    sync_f->clocktype = REPROMPI_CLOCKS_GLOBAL;
+}
+
+static void init_bbarrier_sync(reprompib_sync_functions_t *sync_f)
 {
     sync_f->init_sync_module = bbarrier_init_synchronization_module;
     sync_f->sync_clocks = no_op;
     sync_f->init_sync = bbarrier_init_synchronization;
+    sync_f->resume_sync = no_op;
     sync_f->start_sync = bbarrier_start_synchronization;
     sync_f->stop_sync = bbarrier_stop_synchronization;
     sync_f->clean_sync_module = bbarrier_cleanup_synchronization_module;
     sync_f->get_normalized_time = bbarrier_get_normalized_time;
+    sync_f->get_normalized_times = bbarrier_get_normalized_times;
     sync_f->get_errorcodes = NULL;
+    sync_f->get_uncertainties = NULL;
+    sync_f->get_window_sizes = NULL;
     sync_f->print_sync_info = bbarrier_print_sync_parameters;
     sync_f->get_time = get_time;
     sync_f->parse_sync_params = bbarrier_parse_options;
+    sync_f->print_sync_stats = NULL;
+    sync_f->clocktype = REPROMPI_CLOCKS_LOCAL;
 }
 
-#else	// MPI_Barrier
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f) {
+static void init_mpibarrier_sync(reprompib_sync_functions_t *sync_f)
+{
     sync_f->init_sync_module = mpibarrier_init_synchronization_module;
     sync_f->sync_clocks = no_op;
     sync_f->init_sync = mpibarrier_init_synchronization;
+    sync_f->resume_sync = no_op;
     sync_f->start_sync = mpibarrier_start_synchronization;
     sync_f->stop_sync = mpibarrier_stop_synchronization;
     sync_f->clean_sync_module = mpibarrier_cleanup_synchronization_module;
     sync_f->get_normalized_time = mpibarrier_get_normalized_time;
+    sync_f->get_normalized_times = mpibarrier_get_normalized_times;
     sync_f->get_errorcodes = NULL;
+    sync_f->get_uncertainties = NULL;
+    sync_f->get_window_sizes = NULL;
     sync_f->print_sync_info = mpibarrier_print_sync_parameters;
     sync_f->get_time = get_time;
     sync_f->parse_sync_params = mpibarrier_parse_options;
+    sync_f->print_sync_stats = NULL;
+    sync_f->clocktype = REPROMPI_CLOCKS_LOCAL;
 }
 
-#endif
+
+static reprompi_sync_method_t parse_sync_method(int argc, char** argv) {
+    int c;
+    reprompi_sync_method_t method = default_sync_method;
+
+    optind = 1;
+    optopt = 0;
+    opterr = 0; // ignore invalid options
+    while (1) {
+        int option_index = 0;
+
+        c = getopt_long(argc, argv, "", sync_method_long_options, &option_index);
+
+        /* Detect the end of the options. */
+        if (c == -1)
+            break;
+
+        switch (c) {
+        case REPROMPI_ARGS_SYNC_METHOD: /* synchronization method */
+        {
+            char* subopts = optarg;
+            char* value;
+            int index = getsubopt(&subopts, sync_method_names, &value);
+
+            if (index < 0 || index >= REPROMPI_N_SYNC_METHODS) {
+                reprompib_print_error_and_exit("Unknown synchronization method (should be one of mpibarrier, bbarrier, sk, jk, hca, hca-global, roundtime)");
+            }
+            method = (reprompi_sync_method_t)index;
+            break;
+        }
+        case '?':
+            break;
+        }
+    }
+
+    optind = 1;	// reset optind to enable option re-parsing
+    opterr = 1; // reset opterr
+
+    return method;
+}
+
+
+void initialize_sync_implementation(int argc, char** argv, reprompib_sync_functions_t *sync_f)
+{
+    sync_f->method = parse_sync_method(argc, argv);
+
+    switch (sync_f->method) {
+    case REPROMPI_SYNC_SKAMPI:
+        init_skampi_sync(sync_f);
+        break;
+    case REPROMPI_SYNC_JK:
+        init_jk_sync(sync_f);
+        break;
+    case REPROMPI_SYNC_HCA:
+        init_hca_sync(sync_f);
+        break;
+    case REPROMPI_SYNC_HCA_GLOBAL:
+        init_hca_global_sync(sync_f, argc, argv);
+        break;
+    case REPROMPI_SYNC_ROUNDTIME:
+        init_roundtime_sync(sync_f);
+        break;
+    case REPROMPI_SYNC_BBARRIER:
+        init_bbarrier_sync(sync_f);
+        break;
+    default:
+        init_mpibarrier_sync(sync_f);
+        break;
+    }
+}
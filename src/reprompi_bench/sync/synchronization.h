@@ -27,33 +27,21 @@
 #include "reprompi_bench/sync/sync_info.h"
 
 
-#if defined (ENABLE_WINDOWSYNC_SK)
-#define ENABLE_WINDOWSYNC
-#undef ENABLE_WINDOWSYNC_JK
-#undef ENABLE_WINDOWSYNC_HCA
-#undef ENABLE_GLOBAL_TIMES
+typedef enum reprompi_sync_method {
+    REPROMPI_SYNC_MPIBARRIER = 0,
+    REPROMPI_SYNC_BBARRIER,
+    REPROMPI_SYNC_SKAMPI,
+    REPROMPI_SYNC_JK,
+    REPROMPI_SYNC_HCA,
+    REPROMPI_SYNC_HCA_GLOBAL,
+    REPROMPI_SYNC_ROUNDTIME,
+    REPROMPI_N_SYNC_METHODS
+} reprompi_sync_method_t;
 
-#elif defined (ENABLE_WINDOWSYNC_JK)
-#define ENABLE_WINDOWSYNC
-#undef ENABLE_WINDOWSYNC_SK
-#undef ENABLE_WINDOWSYNC_HCA
-#undef ENABLE_GLOBAL_TIMES
-
-#elif defined (ENABLE_WINDOWSYNC_HCA)
-#define ENABLE_WINDOWSYNC
-#undef ENABLE_WINDOWSYNC_JK
-#undef ENABLE_WINDOWSYNC_SK
-#undef ENABLE_GLOBAL_TIMES
-
-#else
-#undef ENABLE_WINDOWSYNC
-#endif
-
-#ifdef ENABLE_GLOBAL_TIMES
-#ifndef ENABLE_WINDOWSYNC
-#define ENABLE_WINDOWSYNC
-#endif
-#endif
+typedef enum reprompi_clock_type {
+    REPROMPI_CLOCKS_LOCAL = 0,      /* runtimes computed from local start/end times */
+    REPROMPI_CLOCKS_GLOBAL          /* start/end times normalized to the global clock of the root */
+} reprompi_clock_type_t;
 
 typedef void (*init_sync_module_t)(const reprompib_sync_options_t parsed_opts, const long nrep);
 typedef void (*sync_clocks_t)(void);
@@ -62,7 +50,9 @@ typedef void (*start_sync_t)(void);
 typedef void (*stop_sync_t)(void);
 typedef void (*cleanup_sync_t)(void);
 typedef int* (*sync_errorcodes_t)(void);
+typedef double* (*sync_uncertainties_t)(void);
 typedef double (*sync_normtime_t)(double local_time);
+typedef void (*sync_normtimes_t)(const double* local_times, double* global_times, long n);
 typedef void (*print_sync_info_t)(FILE* f);
 typedef double (*sync_time_t)(void);
 typedef void (*parse_sync_params_t)(int argc, char** argv, reprompib_sync_options_t* parsed_opts);
@@ -71,16 +61,28 @@ typedef struct {
     init_sync_module_t init_sync_module;
     sync_clocks_t sync_clocks;
     init_sync_t init_sync;
+    init_sync_t resume_sync;    /* starts new windows after the current time, keeping the repetition index */
     start_sync_t start_sync;
     stop_sync_t stop_sync;
     cleanup_sync_t clean_sync_module;
     sync_normtime_t get_normalized_time;
+    sync_normtimes_t get_normalized_times;     /* get_normalized_time for an array of timestamps */
     sync_errorcodes_t get_errorcodes;
+    sync_uncertainties_t get_uncertainties;     /* per-repetition clock model uncertainty (may be NULL) */
+    sync_uncertainties_t get_window_sizes;      /* per-repetition window size with --auto-window (may be NULL) */
     print_sync_info_t print_sync_info;
+    print_sync_info_t print_sync_stats;     /* statistics at the end of the run (may be NULL) */
     sync_time_t get_time;
     parse_sync_params_t parse_sync_params;
+
+    reprompi_sync_method_t method;
+    reprompi_clock_type_t clocktype;
 } reprompib_sync_functions_t;
 
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f);
+/*
+ * selects the synchronization method given by --sync=<method>
+ * (or the compile-time default if the option is missing)
+ */
+void initialize_sync_implementation(int argc, char** argv, reprompib_sync_functions_t *sync_f);
 
 #endif /* REPROMPIB_SYNCHRONIZATION_H_ */
@@ -23,69 +23,451 @@
 </license>
 */
 
+// CLOCK_MONOTONIC_RAW, RTLD_NOLOAD
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <dlfcn.h>
 #include "mpi.h"
 
-#if defined ENABLE_RDTSCP || defined ENABLE_RDTSC
+#if defined __x86_64__
+#define HAVE_TSC
+#include <cpuid.h>
 #include "rdtsc.h"
-#elif defined ENABLE_CNTVCT
+#elif defined __aarch64__
+#define HAVE_ARM_TIMERS
 #include "contrib/highres_clocks/cntvct.h"
-#elif defined ENABLE_CNTPCT
+// both headers define the HRT_* macros
+#undef HRT_GET_FREQUENCY
+#undef HRT_GET_TIMESTAMP
+#undef HRT_INIT
 #include "contrib/highres_clocks/cntpct.h"
 #endif
 
-
+#include "reprompi_bench/misc.h"
 #include "time_measurement.h"
 
-#if defined ENABLE_RDTSCP || defined ENABLE_RDTSC || defined ENABLE_CNTVCT || defined ENABLE_CNTPCT
-#if defined RDTSC_CALIBRATION || defined ENABLE_CNTVCT || defined ENABLE_CNTPCT
+enum {
+  REPROMPI_ARGS_TIMER = 760
+};
+
+static const struct option timer_long_options[] = {
+        { "timer", required_argument, 0, REPROMPI_ARGS_TIMER },
+        { 0, 0, 0, 0 }
+};
+
+typedef enum reprompi_timer_id {
+    REPROMPI_TIMER_MPI_WTIME = 0,
+    REPROMPI_TIMER_MONOTONIC,
+    REPROMPI_TIMER_MONOTONIC_RAW,
+    REPROMPI_TIMER_MONOTONIC_VDSO,
+    REPROMPI_TIMER_RDTSC,
+    REPROMPI_TIMER_RDTSCP,
+    REPROMPI_TIMER_CNTVCT,
+    REPROMPI_TIMER_CNTPCT,
+    REPROMPI_N_TIMERS
+} reprompi_timer_id_t;
+
+// names accepted by --timer (same order as reprompi_timer_id_t)
+static char* const timer_names[] = {
+        [REPROMPI_TIMER_MPI_WTIME] = "mpi_wtime",
+        [REPROMPI_TIMER_MONOTONIC] = "monotonic",
+        [REPROMPI_TIMER_MONOTONIC_RAW] = "monotonic_raw",
+        [REPROMPI_TIMER_MONOTONIC_VDSO] = "monotonic_vdso",
+        [REPROMPI_TIMER_RDTSC] = "rdtsc",
+        [REPROMPI_TIMER_RDTSCP] = "rdtscp",
+        [REPROMPI_TIMER_CNTVCT] = "cntvct",
+        [REPROMPI_TIMER_CNTPCT] = "cntpct",
+        NULL
+};
+
+#if defined ENABLE_RDTSCP
+static const reprompi_timer_id_t default_timer = REPROMPI_TIMER_RDTSCP;
+#elif defined ENABLE_RDTSC
+static const reprompi_timer_id_t default_timer = REPROMPI_TIMER_RDTSC;
+#elif defined ENABLE_CNTVCT
+static const reprompi_timer_id_t default_timer = REPROMPI_TIMER_CNTVCT;
+#elif defined ENABLE_CNTPCT
+static const reprompi_timer_id_t default_timer = REPROMPI_TIMER_CNTPCT;
+#else
+static const reprompi_timer_id_t default_timer = REPROMPI_TIMER_MPI_WTIME;
+#endif
+
+typedef struct {
+    const char* clock_name;         /* printed as #@clock */
+    double (*get_time)(void);       /* NULL if not supported on this platform */
+    uint64_t (*read_ticks)(void);   /* cycle counters only */
+    int calibrate;                  /* calibrate the counter frequency at startup */
+} reprompi_timer_t;
+
+
+#if defined RDTSC_CALIBRATION
 static double FREQ_HZ=0;
 #elif FREQUENCY_MHZ		// Do not calibrate, set frequency to a fixed value
-const double FREQ_HZ=FREQUENCY_MHZ*1.0e6;
+static double FREQ_HZ=FREQUENCY_MHZ*1.0e6;
 #else
-const double FREQ_HZ=2300*1.0e6;
-#endif
+static double FREQ_HZ=2300*1.0e6;
 #endif
+static double FREQ_ERROR_PPM=0;
+static const char* FREQ_SOURCE="";
+
+// properties of the selected timer measured by init_timer()
+static double timer_overhead_s = 0;
+static double timer_resolution_s = 0;
+static long timer_backward_steps = 0;
+
+// length of the regression window and number of (counter, CLOCK_MONOTONIC_RAW) samples
+static const double CALIBRATION_WINDOW_NS = 20e6;
+#define CALIBRATION_N_SAMPLES 64
+#define CALIBRATION_N_TRIES 4
+
+// a nominal frequency deviating more than this from the measured one is not trusted
+static const double NOMINAL_FREQ_MAX_ERROR_PPM = 1000;
+
+static const long TIMER_N_OVERHEAD_CALLS = 10000;
+static const int TIMER_N_RESOLUTION_SAMPLES = 100;
 
-void init_timer(void) {
-#if defined RDTSC_CALIBRATION || defined ENABLE_CNTVCT || defined ENABLE_CNTPCT
-    uint64_t timerfreq = 0;
-    HRT_INIT(0 /* do not print */, timerfreq);
-    FREQ_HZ = (double)timerfreq;
+
+static double get_time_mpi_wtime(void) {
+    return MPI_Wtime();
+}
+
+static double get_time_monotonic(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double get_time_monotonic_raw(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// clock_gettime of the vDSO, called directly instead of through the libc wrapper
+#if defined __aarch64__
+#define VDSO_CLOCK_GETTIME "__kernel_clock_gettime"
+#else
+#define VDSO_CLOCK_GETTIME "__vdso_clock_gettime"
 #endif
+
+static int (*vdso_clock_gettime)(clockid_t clk_id, struct timespec* ts) = NULL;
+
+static double get_time_monotonic_vdso(void) {
+    struct timespec ts;
+    vdso_clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
-inline double get_time(void) {
-#ifdef ENABLE_RDTSCP
-    return (double)rdtscp()/FREQ_HZ;
-#elif defined ENABLE_RDTSC
+static int load_vdso_clock_gettime(void) {
+    void* vdso = dlopen("linux-vdso.so.1", RTLD_LAZY | RTLD_LOCAL | RTLD_NOLOAD);
+
+    if (vdso == NULL) {
+        return 0;
+    }
+    *(void**)&vdso_clock_gettime = dlsym(vdso, VDSO_CLOCK_GETTIME);
+    return vdso_clock_gettime != NULL;
+}
+
+#ifdef HAVE_TSC
+static uint64_t read_ticks_rdtsc(void) {
+    return rdtsc();
+}
+
+static uint64_t read_ticks_rdtscp(void) {
+    return rdtscp();
+}
+
+static double get_time_rdtsc(void) {
     return (double)rdtsc()/FREQ_HZ;
-#elif defined ENABLE_CNTVCT
+}
+
+static double get_time_rdtscp(void) {
+    return (double)rdtscp()/FREQ_HZ;
+}
+#endif
+
+#ifdef HAVE_ARM_TIMERS
+static double get_time_cntvct(void) {
     return cntvct()*(1.0/FREQ_HZ);
-#elif defined ENABLE_CNTPCT
+}
+
+static double get_time_cntpct(void) {
     return cntpct()*(1.0/FREQ_HZ);
+}
+#endif
+
+#if defined RDTSC_CALIBRATION
+#define CALIBRATE_TSC 1
 #else
-    return MPI_Wtime();
+#define CALIBRATE_TSC 0
+#endif
+
+static const reprompi_timer_t timers[] = {
+        [REPROMPI_TIMER_MPI_WTIME] = { "MPI_Wtime", get_time_mpi_wtime, NULL, 0 },
+        [REPROMPI_TIMER_MONOTONIC] = { "CLOCK_MONOTONIC", get_time_monotonic, NULL, 0 },
+        [REPROMPI_TIMER_MONOTONIC_RAW] = { "CLOCK_MONOTONIC_RAW", get_time_monotonic_raw, NULL, 0 },
+        [REPROMPI_TIMER_MONOTONIC_VDSO] = { "CLOCK_MONOTONIC_VDSO", get_time_monotonic_vdso, NULL, 0 },
+#ifdef HAVE_TSC
+        [REPROMPI_TIMER_RDTSC] = { "RDTSC", get_time_rdtsc, read_ticks_rdtsc, CALIBRATE_TSC },
+        [REPROMPI_TIMER_RDTSCP] = { "RDTSCP", get_time_rdtscp, read_ticks_rdtscp, CALIBRATE_TSC },
+#else
+        [REPROMPI_TIMER_RDTSC] = { "RDTSC", NULL, NULL, 0 },
+        [REPROMPI_TIMER_RDTSCP] = { "RDTSCP", NULL, NULL, 0 },
 #endif
+#ifdef HAVE_ARM_TIMERS
+        [REPROMPI_TIMER_CNTVCT] = { "CNTVCT", get_time_cntvct, cntvct, 1 },
+        [REPROMPI_TIMER_CNTPCT] = { "CNTPCT", get_time_cntpct, cntpct, 1 },
+#else
+        [REPROMPI_TIMER_CNTVCT] = { "CNTVCT", NULL, NULL, 0 },
+        [REPROMPI_TIMER_CNTPCT] = { "CNTPCT", NULL, NULL, 0 },
+#endif
+};
+
+static const reprompi_timer_t* current_timer = &timers[default_timer];
+
+
+static inline double get_raw_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
 }
 
-void print_time_parameters(FILE* f) {
-    char clock[10];
+/*
+ * nominal counter frequency as reported by the hardware or the kernel,
+ * 0 if not available
+ */
+static double get_nominal_frequency(const char** source) {
+#if defined HAVE_ARM_TIMERS
+    uint64_t freq = 0;
+    HRT_GET_FREQUENCY(freq);
+    *source = "cntfrq";
+    return (double)freq;
+#elif defined HAVE_TSC
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    FILE* f;
 
-    strcpy(clock, "MPI_Wtime");
-#ifdef ENABLE_RDTSCP
-    strcpy(clock, "RDTSCP");
-    fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
-#elif defined ENABLE_RDTSC
-    strcpy(clock, "RDTSC");
-    fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
-#elif defined ENABLE_CNTVCT
-    strcpy(clock, "CNTVCT");
-    fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
-#elif defined ENABLE_CNTPCT
-    strcpy(clock, "CNTPCT");
-    fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
+    // CPUID leaf 0x15: TSC/crystal clock ratio (ebx/eax) and crystal frequency (ecx)
+    if (__get_cpuid_max(0, NULL) >= 0x15) {
+        __cpuid(0x15, eax, ebx, ecx, edx);
+        if (eax != 0 && ebx != 0 && ecx != 0) {
+            *source = "cpuid";
+            return (double)ecx * ebx / eax;
+        }
+    }
+
+    // exported by some kernels (and the tsc_freq_khz module)
+    f = fopen("/sys/devices/system/cpu/cpu0/tsc_freq_khz", "r");
+    if (f != NULL) {
+        unsigned long khz = 0;
+        int n = fscanf(f, "%lu", &khz);
+        fclose(f);
+        if (n == 1 && khz > 0) {
+            *source = "sysfs";
+            return khz * 1e3;
+        }
+    }
+    return 0;
+#else
+    return 0;
 #endif
-    fprintf(f, "#@clock=%s\n", clock);
+}
+
+/*
+ * least-squares fit of counter ticks against CLOCK_MONOTONIC_RAW over a short window;
+ * returns the slope in Hz and its relative standard error in ppm
+ */
+static double regress_counter_frequency(uint64_t (*read_ticks)(void), double* error_ppm) {
+    double x[CALIBRATION_N_SAMPLES], y[CALIBRATION_N_SAMPLES];
+    double t_start, mean_x = 0, mean_y = 0, sxx = 0, sxy = 0, ssr = 0;
+    double slope, intercept;
+    uint64_t c_start;
+    int i, j;
+
+    c_start = read_ticks();
+    t_start = get_raw_time_ns();
+    for (i = 0; i < CALIBRATION_N_SAMPLES; i++) {
+        double target = t_start + CALIBRATION_WINDOW_NS * (i + 1) / CALIBRATION_N_SAMPLES;
+        uint64_t min_gap = UINT64_MAX;
+
+        while (get_raw_time_ns() < target) {
+        }
+        // bracket the clock read with two counter reads and keep the tightest sample
+        for (j = 0; j < CALIBRATION_N_TRIES; j++) {
+            uint64_t c1, c2;
+            double t;
+
+            c1 = read_ticks();
+            t = get_raw_time_ns();
+            c2 = read_ticks();
+            if (c2 - c1 < min_gap) {
+                min_gap = c2 - c1;
+                x[i] = t - t_start;
+                y[i] = (double)(c1 - c_start) + 0.5 * (double)(c2 - c1);
+            }
+        }
+        mean_x += x[i];
+        mean_y += y[i];
+    }
+    mean_x /= CALIBRATION_N_SAMPLES;
+    mean_y /= CALIBRATION_N_SAMPLES;
+
+    for (i = 0; i < CALIBRATION_N_SAMPLES; i++) {
+        sxx += (x[i] - mean_x) * (x[i] - mean_x);
+        sxy += (x[i] - mean_x) * (y[i] - mean_y);
+    }
+    slope = sxy / sxx;
+    intercept = mean_y - slope * mean_x;
+    for (i = 0; i < CALIBRATION_N_SAMPLES; i++) {
+        double r = y[i] - (intercept + slope * x[i]);
+        ssr += r * r;
+    }
+
+    *error_ppm = sqrt(ssr / (CALIBRATION_N_SAMPLES - 2) / sxx) / slope * 1e6;
+    return slope * 1e9;   // ticks/ns -> Hz
+}
+
+
+double calibrate_timer_frequency(double* error_ppm, const char** source) {
+    double nominal_freq, measured_freq, measured_error_ppm;
+
+    if (current_timer->read_ticks == NULL) {
+        *source = "none";
+        *error_ppm = 0;
+        return 0;
+    }
+
+    measured_freq = regress_counter_frequency(current_timer->read_ticks, &measured_error_ppm);
+    nominal_freq = get_nominal_frequency(source);
+    if (nominal_freq > 0) {
+        // the error of a nominal frequency is its deviation from the measured one
+        *error_ppm = fabs(nominal_freq - measured_freq) / measured_freq * 1e6;
+        if (*error_ppm <= NOMINAL_FREQ_MAX_ERROR_PPM) {
+            return nominal_freq;
+        }
+    }
+    *source = "regression";
+    *error_ppm = measured_error_ppm;
+    return measured_freq;
+}
+
+
+static reprompi_timer_id_t parse_timer(int argc, char** argv) {
+    int c;
+    reprompi_timer_id_t timer = default_timer;
+
+    optind = 1;
+    optopt = 0;
+    opterr = 0; // ignore invalid options
+    while (1) {
+        int option_index = 0;
+
+        c = getopt_long(argc, argv, "", timer_long_options, &option_index);
+
+        /* Detect the end of the options. */
+        if (c == -1)
+            break;
+
+        switch (c) {
+        case REPROMPI_ARGS_TIMER: /* timer backend */
+        {
+            char* subopts = optarg;
+            char* value;
+            int index = getsubopt(&subopts, timer_names, &value);
+
+            if (index < 0 || index >= REPROMPI_N_TIMERS) {
+                reprompib_print_error_and_exit("Unknown timer (should be one of mpi_wtime, monotonic, monotonic_raw, monotonic_vdso, rdtsc, rdtscp, cntvct, cntpct)");
+            }
+            timer = (reprompi_timer_id_t)index;
+            break;
+        }
+        case '?':
+            break;
+        }
+    }
+
+    optind = 1;	// reset optind to enable option re-parsing
+    opterr = 1; // reset opterr
+
+    return timer;
+}
+
+/*
+ * call overhead (back-to-back calls), resolution (smallest non-zero step)
+ * and monotonicity (number of steps backwards) of the selected timer
+ */
+static void measure_timer_properties(void) {
+    double t_start, t_prev, t;
+    long i;
+
+    timer_backward_steps = 0;
+    t_start = t_prev = get_time();
+    for (i = 0; i < TIMER_N_OVERHEAD_CALLS; i++) {
+        t = get_time();
+        if (t < t_prev) {
+            timer_backward_steps++;
+        }
+        t_prev = t;
+    }
+    timer_overhead_s = (t_prev - t_start) / TIMER_N_OVERHEAD_CALLS;
+
+    timer_resolution_s = HUGE_VAL;
+    for (i = 0; i < TIMER_N_RESOLUTION_SAMPLES; i++) {
+        t_prev = get_time();
+        do {
+            t = get_time();
+        } while (t == t_prev);
+
+        if (t < t_prev) {
+            timer_backward_steps++;
+        } else if (t - t_prev < timer_resolution_s) {
+            timer_resolution_s = t - t_prev;
+        }
+    }
+}
+
+
+void init_timer(int argc, char** argv) {
+    reprompi_timer_id_t timer = parse_timer(argc, argv);
+
+    if (timer == REPROMPI_TIMER_MONOTONIC_VDSO && !load_vdso_clock_gettime()) {
+        reprompib_print_error_and_exit("Cannot find clock_gettime in the vDSO (use --timer=monotonic instead)");
+    }
+    if (timers[timer].get_time == NULL) {
+        reprompib_print_error_and_exit("The selected timer is not supported on this platform");
+    }
+    current_timer = &timers[timer];
+
+    if (current_timer->calibrate) {
+        FREQ_HZ = calibrate_timer_frequency(&FREQ_ERROR_PPM, &FREQ_SOURCE);
+    }
+    measure_timer_properties();
+}
+
+inline double get_time(void) {
+    return current_timer->get_time();
+}
+
+double get_timer_overhead(void) {
+    return timer_overhead_s;
+}
+
+void print_time_parameters(FILE* f) {
+    if (current_timer->read_ticks != NULL) {
+        fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
+        if (current_timer->calibrate) {
+            fprintf(f, "#@frequency_source=%s\n", FREQ_SOURCE);
+            fprintf(f, "#@frequency_error_ppm=%.3f\n", FREQ_ERROR_PPM);
+        }
+    }
+    fprintf(f, "#@clock=%s\n", current_timer->clock_name);
+    fprintf(f, "#@timer_overhead_ns=%.3f\n", timer_overhead_s * 1e9);
+    fprintf(f, "#@timer_resolution_ns=%.3f\n", timer_resolution_s * 1e9);
+    fprintf(f, "#@timer_backward_steps=%ld\n", timer_backward_steps);
 }
@@ -24,10 +24,24 @@
 #ifndef REPROMPIB_TIME_MEASUREMENT_H_
 #define REPROMPIB_TIME_MEASUREMENT_H_
 
-void init_timer(void);
+/*
+ * selects the timer given by --timer=<name> (or the compile-time default),
+ * calibrates its frequency if needed and measures its overhead and resolution
+ */
+void init_timer(int argc, char** argv);
 
 double get_time(void);
 
+/* average cost of one get_time() call in seconds */
+double get_timer_overhead(void);
+
 void print_time_parameters(FILE* f);
 
+/*
+ * estimates the frequency (Hz) of the cycle counter used by get_time(),
+ * either from the nominal frequency (CPUID, sysfs, cntfrq_el0) or by regression
+ * against CLOCK_MONOTONIC_RAW, and reports the calibration error in ppm
+ */
+double calibrate_timer_frequency(double* error_ppm, const char** source);
+
 #endif /* REPROMPIB_TIME_MEASUREMENT_H_ */
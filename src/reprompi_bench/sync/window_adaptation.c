@@ -0,0 +1,219 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+ *
+ * Copyright (c) 2021 Stefan Christians
+ *
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+#include "reprompi_bench/misc.h"
+#include "time_measurement.h"
+#include "window_adaptation.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+/*
+ * Adaptive window size for the window-based synchronization methods.
+ * The first batch of repetitions of a job (the pilot) uses the window
+ * given by --window-size. At the end of every batch, the processes agree
+ * on the largest window time used by each repetition and set the next
+ * window to an upper quantile of these times over the most recent
+ * repetitions (with a safety factor) plus the synchronization error.
+ * If too many repetitions of the batch expired, the window is at least
+ * doubled.
+ */
+
+static const double AUTO_WINDOW_QUANTILE = 0.995;
+static const double AUTO_WINDOW_FACTOR = 1.5;
+static const int AUTO_WINDOW_HISTORY = 1000;    /* repetitions considered for the quantile */
+static const double AUTO_WINDOW_MAX_EXPIRED = 0.05;   /* fraction of expired repetitions before doubling */
+
+enum {
+    SYNC_ERROR_N_EXCHANGES = 10,
+    SYNC_ERROR_TAG = 45
+};
+
+static double sync_error_sec = -1;      /* measured once and kept across jobs */
+
+
+/*
+ * half the minimum RTT between the root and a process bounds the error of
+ * any offset measured with a ping-pong; the largest bound over all processes
+ */
+static double measure_sync_error_bound(void) {
+    int my_rank = icmb_global_rank();
+    int nprocs = icmb_global_size();
+    MPI_Comm comm = icmb_global_communicator();
+    double error_sec = 0;
+    double buf = 0;
+    int p, i;
+
+    if (my_rank == 0) {
+        for (p = 1; p < nprocs; p++) {
+            double min_rtt = -1;
+
+            for (i = 0; i < SYNC_ERROR_N_EXCHANGES; i++) {
+                double t_start = get_time();
+
+                MPI_Send(&buf, 1, MPI_DOUBLE, p, SYNC_ERROR_TAG, comm);
+                MPI_Recv(&buf, 1, MPI_DOUBLE, p, SYNC_ERROR_TAG, comm, MPI_STATUS_IGNORE);
+                if (min_rtt < 0 || get_time() - t_start < min_rtt) {
+                    min_rtt = get_time() - t_start;
+                }
+            }
+            if (min_rtt / 2 > error_sec) {
+                error_sec = min_rtt / 2;
+            }
+        }
+    } else {
+        for (i = 0; i < SYNC_ERROR_N_EXCHANGES; i++) {
+            MPI_Recv(&buf, 1, MPI_DOUBLE, 0, SYNC_ERROR_TAG, comm, MPI_STATUS_IGNORE);
+            MPI_Send(&buf, 1, MPI_DOUBLE, 0, SYNC_ERROR_TAG, comm);
+        }
+    }
+    MPI_Bcast(&error_sec, 1, MPI_DOUBLE, 0, comm);
+
+    return error_sec;
+}
+
+
+void reprompi_window_adapter_init(reprompi_window_adapter_t* adapter, const int batch_size,
+        const double window_sec, const double wait_time_sec, const long n_rep) {
+    adapter->batch_size = batch_size;
+    adapter->window_sec = window_sec;
+    adapter->wait_time_sec = wait_time_sec;
+    adapter->n_elapsed = 0;
+    adapter->n_rep = n_rep;
+    adapter->rep = 0;
+    adapter->n_adaptations = 0;
+    adapter->elapsed_sec = NULL;
+    adapter->windows_sec = NULL;
+    adapter->history_sec = NULL;
+    adapter->sorted_sec = NULL;
+    adapter->n_history = 0;
+    adapter->history_index = 0;
+
+    if (batch_size <= 0) {
+        return;
+    }
+
+    // one more element for the current time of the processes
+    adapter->elapsed_sec = (double*)calloc(batch_size + 1, sizeof(double));
+    adapter->windows_sec = (double*)calloc(n_rep, sizeof(double));
+    adapter->history_size = (AUTO_WINDOW_HISTORY > batch_size) ? AUTO_WINDOW_HISTORY : batch_size;
+    adapter->history_sec = (double*)calloc(adapter->history_size, sizeof(double));
+    adapter->sorted_sec = (double*)calloc(adapter->history_size, sizeof(double));
+
+    if (sync_error_sec < 0) {
+        sync_error_sec = measure_sync_error_bound();
+    }
+}
+
+
+void reprompi_window_adapter_cleanup(reprompi_window_adapter_t* adapter) {
+    free(adapter->elapsed_sec);
+    free(adapter->windows_sec);
+    free(adapter->history_sec);
+    free(adapter->sorted_sec);
+    adapter->elapsed_sec = NULL;
+    adapter->windows_sec = NULL;
+    adapter->history_sec = NULL;
+    adapter->sorted_sec = NULL;
+}
+
+
+int reprompi_window_adapter_record(reprompi_window_adapter_t* adapter, const double elapsed_sec,
+        const double now_sec, double* next_start_sec) {
+    int batch_size = adapter->batch_size;
+    int i, n_expired = 0;
+    double window_sec;
+
+    if (batch_size <= 0) {
+        return 0;
+    }
+
+    if (adapter->rep < adapter->n_rep) {
+        adapter->windows_sec[adapter->rep] = adapter->window_sec;
+    }
+    adapter->rep++;
+    adapter->elapsed_sec[adapter->n_elapsed++] = elapsed_sec;
+
+    if (adapter->n_elapsed < batch_size) {
+        return 0;
+    }
+    adapter->n_elapsed = 0;
+    if (adapter->rep >= adapter->n_rep) {  // no need to adapt after the last repetition
+        return 0;
+    }
+
+    // largest window time of each repetition over all processes
+    adapter->elapsed_sec[batch_size] = now_sec;
+    MPI_Allreduce(MPI_IN_PLACE, adapter->elapsed_sec, batch_size + 1, MPI_DOUBLE, MPI_MAX,
+            icmb_global_communicator());
+
+    for (i = 0; i < batch_size; i++) {
+        if (adapter->elapsed_sec[i] > adapter->window_sec) {
+            n_expired++;
+        }
+        adapter->history_sec[adapter->history_index] = adapter->elapsed_sec[i];
+        adapter->history_index = (adapter->history_index + 1) % adapter->history_size;
+    }
+    adapter->n_history += batch_size;
+    if (adapter->n_history > adapter->history_size) {
+        adapter->n_history = adapter->history_size;
+    }
+
+    memcpy(adapter->sorted_sec, adapter->history_sec, adapter->n_history * sizeof(double));
+    gsl_sort(adapter->sorted_sec, 1, adapter->n_history);
+    window_sec = AUTO_WINDOW_FACTOR
+            * gsl_stats_quantile_from_sorted_data(adapter->sorted_sec, 1, adapter->n_history, AUTO_WINDOW_QUANTILE)
+            + sync_error_sec;
+
+    if (n_expired > AUTO_WINDOW_MAX_EXPIRED * batch_size && window_sec < 2 * adapter->window_sec) {
+        window_sec = 2 * adapter->window_sec;
+    }
+    adapter->window_sec = window_sec;
+    adapter->n_adaptations++;
+
+    // every process has reached the latest current time once the reduction is done
+    *next_start_sec = adapter->elapsed_sec[batch_size] + adapter->wait_time_sec;
+    return 1;
+}
+
+
+double* reprompi_window_adapter_get_windows(reprompi_window_adapter_t* adapter) {
+    return adapter->windows_sec;
+}
+
+
+void reprompi_window_adapter_print(const reprompi_window_adapter_t* adapter, FILE* f) {
+    if (adapter->batch_size > 0) {
+        fprintf(f, "#@auto_window_batch=%d\n", adapter->batch_size);
+        fprintf(f, "#@auto_window_sync_error_s=%.10f\n", sync_error_sec);
+    }
+}
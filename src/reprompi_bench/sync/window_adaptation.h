@@ -0,0 +1,72 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+
+#ifndef REPROMPIB_WINDOW_ADAPTATION_H_
+#define REPROMPIB_WINDOW_ADAPTATION_H_
+
+#include <stdio.h>
+
+typedef struct {
+    int batch_size;         /* repetitions between two adaptations (0: fixed window) */
+    double window_sec;      /* current window size */
+    double wait_time_sec;   /* wait time before the first window after an adaptation */
+
+    double* elapsed_sec;    /* window time used by each repetition of the current batch */
+    int n_elapsed;
+
+    double* history_sec;    /* largest window times of the most recent repetitions (ring buffer) */
+    double* sorted_sec;
+    int history_size;
+    int n_history;
+    int history_index;
+
+    double* windows_sec;    /* window size used for each repetition of the job */
+    long n_rep;
+    long rep;
+    long n_adaptations;
+} reprompi_window_adapter_t;
+
+/*
+ * starts a job with the given initial window size (used for the pilot batch);
+ * collective on the global communicator
+ */
+void reprompi_window_adapter_init(reprompi_window_adapter_t* adapter, const int batch_size,
+        const double window_sec, const double wait_time_sec, const long n_rep);
+void reprompi_window_adapter_cleanup(reprompi_window_adapter_t* adapter);
+
+/*
+ * records the window time used by the current repetition (from the start to the
+ * end of the measurement, in the time base of the sync method). At the end
+ * of a batch, all processes choose the next window size and the start time of the
+ * next window from their current time now_sec, and 1 is returned.
+ */
+int reprompi_window_adapter_record(reprompi_window_adapter_t* adapter, const double elapsed_sec,
+        const double now_sec, double* next_start_sec);
+
+/* window size used for each repetition of the job (NULL for a fixed window) */
+double* reprompi_window_adapter_get_windows(reprompi_window_adapter_t* adapter);
+
+void reprompi_window_adapter_print(const reprompi_window_adapter_t* adapter, FILE* f);
+
+#endif /* REPROMPIB_WINDOW_ADAPTATION_H_ */
@@ -0,0 +1,131 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+
+#include "node_topology.h"
+
+#include "contrib/intercommunication/intercommunication.h"
+
+static int n_users = 0;
+static MPI_Comm node_comm = MPI_COMM_NULL;
+static MPI_Comm leader_comm = MPI_COMM_NULL;
+static int n_nodes = 0;
+static int node_id = -1;
+
+
+void reprompib_init_node_topology(void) {
+    int global_rank, node_rank;
+
+    if (n_users++ > 0) {
+        return;
+    }
+
+    // order the processes by global rank, so that global rank 0 is rank 0 in both communicators
+    global_rank = icmb_global_rank();
+    MPI_Comm_split_type(icmb_global_communicator(), MPI_COMM_TYPE_SHARED, global_rank,
+            MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &node_rank);
+
+    MPI_Comm_split(icmb_global_communicator(), (node_rank == 0) ? 0 : MPI_UNDEFINED,
+            global_rank, &leader_comm);
+
+    // the rank of the leader in the leader communicator numbers the node
+    if (leader_comm != MPI_COMM_NULL) {
+        MPI_Comm_rank(leader_comm, &node_id);
+        MPI_Comm_size(leader_comm, &n_nodes);
+    }
+    MPI_Bcast(&node_id, 1, MPI_INT, 0, node_comm);
+    MPI_Bcast(&n_nodes, 1, MPI_INT, 0, node_comm);
+}
+
+
+void reprompib_cleanup_node_topology(void) {
+    if (n_users == 0 || --n_users > 0) {
+        return;
+    }
+
+    if (node_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&node_comm);
+    }
+    if (leader_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&leader_comm);
+    }
+    n_nodes = 0;
+    node_id = -1;
+}
+
+
+MPI_Comm reprompib_get_node_comm(void) {
+    return node_comm;
+}
+
+MPI_Comm reprompib_get_leader_comm(void) {
+    return leader_comm;
+}
+
+int reprompib_get_n_nodes(void) {
+    return n_nodes;
+}
+
+
+void reprompib_gather_node_info(int root, int** rank_nodes, char** node_names) {
+    char name[MPI_MAX_PROCESSOR_NAME];
+    int* name_counts = NULL;
+    int* name_displs = NULL;
+    int is_root = (icmb_global_rank() == root);
+    int name_len, nprocs, p, n;
+
+    nprocs = icmb_global_size();
+    *rank_nodes = NULL;
+    *node_names = NULL;
+    if (is_root) {
+        *rank_nodes = (int*)malloc(nprocs * sizeof(int));
+        *node_names = (char*)malloc(n_nodes * MPI_MAX_PROCESSOR_NAME * sizeof(char));
+    }
+    MPI_Gather(&node_id, 1, MPI_INT, *rank_nodes, 1, MPI_INT, root, icmb_global_communicator());
+
+    // only the node leaders send their name, in the order of the node numbers
+    if (is_root) {
+        name_counts = (int*)calloc(nprocs, sizeof(int));
+        name_displs = (int*)calloc(nprocs, sizeof(int));
+        for (p = 0, n = 0; p < nprocs; p++) {
+            if ((*rank_nodes)[p] == n) {
+                name_counts[p] = MPI_MAX_PROCESSOR_NAME;
+                name_displs[p] = n * MPI_MAX_PROCESSOR_NAME;
+                n++;
+            }
+        }
+    }
+    memset(name, 0, sizeof(name));
+    MPI_Get_processor_name(name, &name_len);
+    MPI_Gatherv(name, (leader_comm != MPI_COMM_NULL) ? MPI_MAX_PROCESSOR_NAME : 0, MPI_CHAR,
+            *node_names, name_counts, name_displs, MPI_CHAR, root, icmb_global_communicator());
+
+    free(name_counts);
+    free(name_displs);
+}
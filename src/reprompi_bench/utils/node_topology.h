@@ -0,0 +1,57 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_NODE_TOPOLOGY_H_
+#define REPROMPIB_NODE_TOPOLOGY_H_
+
+#include <stdio.h>
+#include "mpi.h"
+
+/*
+ * Nodes of the global communicator: the processes of a node share memory
+ * (MPI_COMM_TYPE_SHARED), the process with the lowest global rank is the
+ * node leader, and the nodes are numbered in the order of their leaders.
+ *
+ * The topology is created by the first call to reprompib_init_node_topology()
+ * and freed by the matching last call to reprompib_cleanup_node_topology()
+ * (both collective over all processes).
+ */
+void reprompib_init_node_topology(void);
+void reprompib_cleanup_node_topology(void);
+
+// processes on the same node (ordered by global rank)
+MPI_Comm reprompib_get_node_comm(void);
+
+// one process per node (MPI_COMM_NULL on the other processes)
+MPI_Comm reprompib_get_leader_comm(void);
+
+int reprompib_get_n_nodes(void);
+
+/*
+ * node number of each global rank (nprocs values) and the names of the nodes
+ * (n_nodes * MPI_MAX_PROCESSOR_NAME characters), gathered on the given global
+ * rank (collective; the arrays are allocated on root only, NULL elsewhere)
+ */
+void reprompib_gather_node_info(int root, int** rank_nodes, char** node_names);
+
+#endif /* REPROMPIB_NODE_TOPOLOGY_H_ */
@@ -57,6 +57,7 @@ int main(int argc, char* argv[]) {
 
     /* start up MPI */
     MPI_Init(&argc, &argv);
+    init_timer(argc, argv);
 
      // parse command line options to launch inter-communicators
     icmb_parse_intercommunication_options(argc, argv);
@@ -82,10 +83,10 @@ int main(int argc, char* argv[]) {
     }
 
     for (step = 0; step < n_wait_steps; step++) {
-        uint64_t timerfreq = 0;
-        HRT_INIT(0 /* do not print */, timerfreq);
+        double error_ppm;
+        const char* source;
 
-        frequencies[step] = (double) timerfreq;
+        frequencies[step] = calibrate_timer_frequency(&error_ppm, &source);
 //       wtime_times[step] = MPI_Wtime();
 
 // wait 1 second
@@ -179,19 +179,19 @@ int main(int argc, char* argv[]) {
 
     double runtime_s;
 
-    // initialize synchronization functions according to the configured synchronization method
     reprompib_sync_functions_t sync_f;
-    initialize_sync_implementation(&sync_f);
-
-    init_timer();
 
     /* start up MPI */
     MPI_Init(&argc, &argv);
+    init_timer(argc, argv);
     master_rank = 0;
 
     // parse command line options to launch inter-communicators
     icmb_parse_intercommunication_options(argc, argv);
 
+    // initialize synchronization functions according to the selected synchronization method
+    initialize_sync_implementation(argc, argv, &sync_f);
+
     ret = parse_test_options(&opts, argc, argv);
     validate_test_options_or_abort(ret, &opts);
 
@@ -71,19 +71,19 @@ int main(int argc, char* argv[]) {
     double *all_runtimes = NULL;
     int dummy_nrep = 1;
 
-    // initialize synchronization functions according to the configured synchronization method
     reprompib_sync_functions_t sync_f;
-    initialize_sync_implementation(&sync_f);
-
-    init_timer();
 
     /* start up MPI */
     MPI_Init(&argc, &argv);
+    init_timer(argc, argv);
     master_rank = 0;
 
     // parse command line options to launch inter-communicators
     icmb_parse_intercommunication_options(argc, argv);
 
+    // initialize synchronization functions according to the selected synchronization method
+    initialize_sync_implementation(argc, argv, &sync_f);
+
     my_rank = icmb_global_rank();
     nprocs = icmb_global_size();
 
@@ -100,7 +100,6 @@ int main(int argc, char* argv[]) {
 
 
     runtime_s = get_time();
-    init_timer();
     sync_f.sync_clocks();
     sync_f.init_sync();
     runtime_s = get_time() - runtime_s;
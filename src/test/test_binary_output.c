@@ -0,0 +1,243 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+ Research Group for Parallel Computing
+ Faculty of Informatics
+ Vienna University of Technology, Austria
+
+ <license>
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ </license>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+
+#include "../reprompi_bench/output_management/binary_output.h"
+
+static const int NPROCS = 3;
+static const long NREP = 40;
+
+// bit patterns whose differences are the int64 extremes (0, -0.0, NaN with all bits set, ...)
+static const uint64_t extreme_bits[] = {
+    0x0000000000000000ULL, 0x8000000000000000ULL, 0x0000000000000000ULL,
+    0x7FFFFFFFFFFFFFFFULL, 0x8000000000000000ULL, 0xFFFFFFFFFFFFFFFFULL,
+    0x0000000000000000ULL, 0x7FF0000000000000ULL, 0x0000000000000001ULL
+};
+
+static double* columns[REPROMPIB_BIN_N_COLUMNS];
+static int* errorcodes;
+
+// timestamps with negative deltas, special values and int64-extreme deltas
+static void init_measurements(void) {
+  long nvalues = NPROCS * NREP;
+  long i;
+  int p;
+
+  errorcodes = (int*) malloc(nvalues * sizeof(int));
+  columns[REPROMPIB_BIN_COL_LOC_TSTART] = (double*) malloc(nvalues * sizeof(double));
+  columns[REPROMPIB_BIN_COL_GL_TSTART] = (double*) malloc(nvalues * sizeof(double));
+  columns[REPROMPIB_BIN_COL_RUNTIME] = (double*) malloc(nvalues * sizeof(double));
+
+  for (p = 0; p < NPROCS; p++) {
+    for (i = 0; i < NREP; i++) {
+      long index = p * NREP + i;
+      int extremes = sizeof(extreme_bits) / sizeof(extreme_bits[0]);
+
+      columns[REPROMPIB_BIN_COL_LOC_TSTART][index] = 1e5 + p + i * 1e-5;
+      columns[REPROMPIB_BIN_COL_GL_TSTART][index] = 1e-3 - i * 1e-6 * (i % 3);
+      if (p == 1 && i < extremes) {
+        memcpy(&columns[REPROMPIB_BIN_COL_RUNTIME][index], &extreme_bits[i], sizeof(double));
+      } else {
+        const double special[] = { DBL_MAX, -DBL_MAX, DBL_MIN / 4, -INFINITY, 1e-6 * i };
+        columns[REPROMPIB_BIN_COL_RUNTIME][index] = special[(i + p) % 5];
+      }
+      errorcodes[index] = (i % 7 == 0) ? (int)(i % 4) : 0;
+    }
+  }
+  errorcodes[NREP - 1] = INT_MAX;
+  errorcodes[NREP] = INT_MIN;
+  errorcodes[2 * NREP + 1] = -1;
+}
+
+static void free_measurements(void) {
+  int c;
+
+  for (c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+    free(columns[c]);
+  }
+  free(errorcodes);
+}
+
+// compares the decoded chunk bit by bit with the measurements
+static int check_chunk(const reprompib_bin_chunk_t* chunk, const char* name, uint32_t flags, int nprocs,
+    long first_rep, size_t msize, const int* codes) {
+  long nvalues = nprocs * NREP;
+  int c;
+  int errors = 0;
+
+  if (strcmp(chunk->name, name) != 0 || chunk->header.flags != flags || chunk->header.nprocs != (uint32_t) nprocs
+      || chunk->header.first_rep != (uint64_t) first_rep || chunk->header.nrep != (uint64_t) NREP || chunk->header.msize != msize) {
+    printf("%s: wrong header\n", name);
+    errors++;
+  }
+  if ((codes == NULL) != (chunk->errorcodes == NULL)
+      || (codes != NULL && memcmp(chunk->errorcodes, codes, nvalues * sizeof(int)) != 0)) {
+    printf("%s: wrong error codes\n", name);
+    errors++;
+  }
+  for (c = 0; c < REPROMPIB_BIN_N_COLUMNS; c++) {
+    if ((columns[c] == NULL) != (chunk->columns[c] == NULL)
+        || (columns[c] != NULL && memcmp(chunk->columns[c], columns[c], nvalues * sizeof(double)) != 0)) {
+      printf("%s: wrong column %s\n", name, reprompib_get_bin_column_name(c));
+      errors++;
+    }
+  }
+  return errors;
+}
+
+static int test_round_trip(void) {
+  reprompib_bin_chunk_t chunk;
+  FILE* f = tmpfile();
+  int errors = 0;
+
+  reprompib_write_binary_chunk(f, "MPI_Allreduce", REPROMPIB_BIN_FLAG_PER_PROCESS | REPROMPIB_BIN_FLAG_ERRORCODES,
+      NPROCS, 0, NREP, 8, errorcodes, columns);
+  reprompib_write_binary_chunk(f, "MPI_Bcast", REPROMPIB_BIN_FLAG_MSIZE_BYTES, 1, 5 * NREP, NREP, 1 << 20,
+      NULL, columns);
+  rewind(f);
+
+  if (reprompib_read_binary_chunk(f, &chunk) != 1) {
+    printf("round trip: cannot read the first chunk\n");
+    errors++;
+  } else {
+    errors += check_chunk(&chunk, "MPI_Allreduce", REPROMPIB_BIN_FLAG_PER_PROCESS | REPROMPIB_BIN_FLAG_ERRORCODES,
+        NPROCS, 0, 8, errorcodes);
+    reprompib_free_binary_chunk(&chunk);
+  }
+
+  if (reprompib_read_binary_chunk(f, &chunk) != 1) {
+    printf("round trip: cannot read the second chunk\n");
+    errors++;
+  } else {
+    errors += check_chunk(&chunk, "MPI_Bcast", REPROMPIB_BIN_FLAG_MSIZE_BYTES, 1, 5 * NREP, 1 << 20, NULL);
+    reprompib_free_binary_chunk(&chunk);
+  }
+
+  if (reprompib_read_binary_chunk(f, &chunk) != 0) {
+    printf("round trip: no end of file after the last chunk\n");
+    errors++;
+  }
+
+  fclose(f);
+  printf("round trip: %s\n", (errors == 0) ? "ok" : "FAILED");
+  return errors;
+}
+
+/*
+ * a chunk encoded in memory, modified by the test and read back from a file;
+ * the reader has to reject it
+ */
+static int read_modified_chunk(const char* name, long new_size, long new_payload_size, int fill_payload) {
+  reprompib_bin_chunk_t chunk;
+  reprompib_bin_header_t header;
+  unsigned char* bytes;
+  long size;
+  FILE* f = tmpfile();
+  int ret;
+
+  reprompib_write_binary_chunk(f, "MPI_Allreduce", REPROMPIB_BIN_FLAG_PER_PROCESS | REPROMPIB_BIN_FLAG_ERRORCODES,
+      NPROCS, 0, NREP, 8, errorcodes, columns);
+  size = ftell(f);
+  bytes = (unsigned char*) malloc(size);
+  rewind(f);
+  if (fread(bytes, 1, size, f) != (size_t) size) {
+    printf("%s: cannot read the encoded chunk\n", name);
+    fclose(f);
+    free(bytes);
+    return 1;
+  }
+  fclose(f);
+
+  memcpy(&header, bytes, sizeof(header));
+  if (new_payload_size >= 0) {
+    header.payload_size = new_payload_size;
+  }
+  memcpy(bytes, &header, sizeof(header));
+  if (fill_payload) {
+    long start = sizeof(header) + header.name_length;
+    memset(bytes + start, 0xff, size - start);
+  }
+
+  f = tmpfile();
+  fwrite(bytes, 1, (new_size >= 0) ? new_size : size, f);
+  rewind(f);
+  ret = reprompib_read_binary_chunk(f, &chunk);
+  fclose(f);
+  free(bytes);
+
+  if (ret != -1) {
+    printf("%s: read returned %d (should be -1)\n", name, ret);
+    reprompib_free_binary_chunk(&chunk);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+static int test_truncated(void) {
+  reprompib_bin_header_t header;
+  long size, header_size, name_length = strlen("MPI_Allreduce");
+  FILE* f = tmpfile();
+  int errors = 0;
+
+  reprompib_write_binary_chunk(f, "MPI_Allreduce", REPROMPIB_BIN_FLAG_PER_PROCESS | REPROMPIB_BIN_FLAG_ERRORCODES,
+      NPROCS, 0, NREP, 8, errorcodes, columns);
+  size = ftell(f);
+  rewind(f);
+  if (fread(&header, sizeof(header), 1, f) != 1) {
+    printf("truncated: cannot read the header\n");
+    fclose(f);
+    return 1;
+  }
+  fclose(f);
+  header_size = sizeof(header) + name_length;
+
+  // the file ends inside the name or the payload
+  errors += read_modified_chunk("truncated name", sizeof(header) + 2, -1, 0);
+  errors += read_modified_chunk("truncated file", size - 1, -1, 0);
+  // the payload ends inside a value, in the error codes and in the last column
+  errors += read_modified_chunk("truncated payload (error codes)", header_size + 5, 5, 0);
+  errors += read_modified_chunk("truncated payload (last value)", size - 1, header.payload_size - 1, 0);
+  // varints without end
+  errors += read_modified_chunk("unterminated varints", -1, -1, 1);
+  return errors;
+}
+
+int main(int argc, char* argv[]) {
+  int errors = 0;
+
+  init_measurements();
+  errors += test_round_trip();
+  errors += test_truncated();
+  free_measurements();
+
+  printf("%d errors\n", errors);
+  return (errors == 0) ? 0 : 1;
+}
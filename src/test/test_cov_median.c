@@ -0,0 +1,126 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+ Research Group for Parallel Computing
+ Faculty of Informatics
+ Vienna University of Technology, Austria
+
+ <license>
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ </license>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <gsl/gsl_statistics.h>
+#include <gsl/gsl_sort.h>
+#include "mpi.h"
+
+#include "../pred_bench/prediction_methods/prediction_data.h"
+#include "../pred_bench/prediction_methods/pred_helpers.h"
+#include "../pred_bench/prediction_methods/cov_median.h"
+
+static const long MAX_NREPS = 600;
+
+// median of the first n runtimes, computed on a sorted copy
+static double sorted_prefix_median(const double* runtimes_sec, long n) {
+  double* sorted;
+  double median;
+
+  sorted = (double*) malloc(n * sizeof(double));
+  memcpy(sorted, runtimes_sec, n * sizeof(double));
+  gsl_sort(sorted, 1, n);
+  median = gsl_stats_quantile_from_sorted_data(sorted, 1, n, 0.5);
+  free(sorted);
+  return median;
+}
+
+// coefficient of variation of the medians of the last method_win prefixes
+static double reference_cov_median(long nreps, const double* runtimes_sec, int method_win) {
+  double* medians;
+  double cov;
+  int i;
+
+  if (method_win > nreps) {
+    return COEF_ERROR_VALUE;
+  }
+  medians = (double*) malloc(method_win * sizeof(double));
+  for (i = 0; i < method_win; i++) {
+    medians[i] = sorted_prefix_median(runtimes_sec, nreps - i);
+  }
+  cov = gsl_stats_sd(medians, 1, method_win) / gsl_stats_mean(medians, 1, method_win);
+  free(medians);
+  return cov;
+}
+
+/*
+ * prediction rounds of a job with nreps growing by the given steps: the
+ * prefix medians kept between the rounds have to give the same coefficient
+ * as the medians of the sorted prefixes, for prefixes of odd and even length
+ */
+static int test_job(const char* name, double* runtimes_sec, int method_win, long first_nreps, long step) {
+  pred_method_info_t info = { 0, 0.01, method_win };
+  long nreps;
+  int errors = 0;
+
+  for (nreps = first_nreps; nreps <= MAX_NREPS; nreps += step) {
+    double cov = compute_cov_median(nreps, runtimes_sec, info);
+    double expected = reference_cov_median(nreps, runtimes_sec, method_win);
+
+    if (cov != expected && !(isnan(cov) && isnan(expected))) {
+      printf("%s (win=%d): nreps=%ld cov_median=%.17g (should be %.17g)\n", name, method_win, nreps, cov, expected);
+      errors++;
+    }
+  }
+  printf("%s (win=%d, step=%ld): %s\n", name, method_win, step, (errors == 0) ? "ok" : "FAILED");
+  return errors;
+}
+
+int main(int argc, char* argv[]) {
+  double* runtimes_sec;
+  double* other_runtimes_sec;
+  long i;
+  int errors = 0;
+
+  MPI_Init(&argc, &argv);
+  srand(1);
+
+  runtimes_sec = (double*) malloc(MAX_NREPS * sizeof(double));
+  other_runtimes_sec = (double*) malloc(MAX_NREPS * sizeof(double));
+  for (i = 0; i < MAX_NREPS; i++) {
+    // runtimes with many duplicates and a few outliers
+    runtimes_sec[i] = (rand() % 10 == 0) ? 1e-3 * rand() / RAND_MAX : 1e-6 * (rand() % 50 + 1);
+    other_runtimes_sec[i] = 1e-6 * (MAX_NREPS - i);
+  }
+
+  // every prefix length, one repetition more per round
+  errors += test_job("random", runtimes_sec, 2, 1, 1);
+  errors += test_job("descending", other_runtimes_sec, 2, 1, 1);
+  // rounds of several repetitions, as with --pred-method
+  errors += test_job("random", runtimes_sec, 10, 10, 7);
+  errors += test_job("random", runtimes_sec, 1, 50, 50);
+  // all prefix medians of an odd and an even number of repetitions in one window
+  errors += test_job("all prefixes odd", runtimes_sec, MAX_NREPS - 1, MAX_NREPS - 1, MAX_NREPS);
+  errors += test_job("all prefixes even", runtimes_sec, MAX_NREPS, MAX_NREPS, MAX_NREPS);
+
+  reset_cov_median();
+  free(runtimes_sec);
+  free(other_runtimes_sec);
+
+  printf("%d errors\n", errors);
+  MPI_Finalize();
+  return (errors == 0) ? 0 : 1;
+}
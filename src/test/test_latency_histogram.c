@@ -0,0 +1,144 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+ Research Group for Parallel Computing
+ Faculty of Informatics
+ Vienna University of Technology, Austria
+
+ <license>
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ </license>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mpi.h"
+
+#include "../reprompi_bench/output_management/latency_histogram.h"
+
+static reprompib_histogram_t hist;
+
+// bucket in which a runtime in seconds is counted
+static int get_bucket_index(double runtime_sec) {
+  int i;
+
+  memset(&hist, 0, sizeof(hist));
+  reprompib_record_latency(&hist, runtime_sec);
+  for (i = 0; i < REPROMPIB_HIST_N_BUCKETS; i++) {
+    if (hist.counts[i] != 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// bucket of an integer number of nanoseconds (half a nanosecond avoids rounding down)
+static int get_ns_bucket_index(unsigned long long ns) {
+  return get_bucket_index((ns + 0.5) * 1e-9);
+}
+
+/*
+ * the buckets cover [0, 2^REPROMPIB_HIST_MAX_EXP) ns without gaps, the first
+ * and last nanosecond of each bucket are counted in it, the first nanosecond
+ * of the next bucket in the next one, and the relative width stays below 1/64
+ */
+static int test_bucket_edges(void) {
+  unsigned long long lower, upper, prev_upper = 0;
+  int i;
+  int errors = 0;
+
+  for (i = 0; i < REPROMPIB_HIST_N_BUCKETS; i++) {
+    reprompib_get_bucket_bounds(i, &lower, &upper);
+
+    if (lower != prev_upper || upper <= lower) {
+      printf("bucket %d: [%llu, %llu) does not follow %llu\n", i, lower, upper, prev_upper);
+      errors++;
+    }
+    if (get_ns_bucket_index(lower) != i || get_ns_bucket_index(upper - 1) != i) {
+      printf("bucket %d: [%llu, %llu) counted in %d and %d\n", i, lower, upper,
+          get_ns_bucket_index(lower), get_ns_bucket_index(upper - 1));
+      errors++;
+    }
+    if (i < REPROMPIB_HIST_N_BUCKETS - 1 && get_ns_bucket_index(upper) != i + 1) {
+      printf("bucket %d: upper bound %llu counted in %d\n", i, upper, get_ns_bucket_index(upper));
+      errors++;
+    }
+    if (lower >= 2 * REPROMPIB_HIST_HALF_SUB_COUNT && (upper - lower) * REPROMPIB_HIST_HALF_SUB_COUNT > lower) {
+      printf("bucket %d: [%llu, %llu) is too wide\n", i, lower, upper);
+      errors++;
+    }
+    prev_upper = upper;
+  }
+  if (prev_upper != 1ULL << REPROMPIB_HIST_MAX_EXP) {
+    printf("last bucket ends at %llu (should be %llu)\n", prev_upper, 1ULL << REPROMPIB_HIST_MAX_EXP);
+    errors++;
+  }
+
+  printf("bucket edges: %s\n", (errors == 0) ? "ok" : "FAILED");
+  return errors;
+}
+
+// increasing runtimes never go to a lower bucket and fall within the bounds of theirs
+static int test_monotonic(void) {
+  unsigned long long lower, upper;
+  double runtime_sec;
+  int index, prev_index = 0;
+  int errors = 0;
+
+  for (runtime_sec = 1e-10; runtime_sec < 1000; runtime_sec *= 1.001) {
+    double ns = runtime_sec * 1e9;
+
+    index = get_bucket_index(runtime_sec);
+    reprompib_get_bucket_bounds(index, &lower, &upper);
+    if (index < prev_index || ns < lower || ns >= upper) {
+      printf("%.12e s: bucket %d [%llu, %llu) after bucket %d\n", runtime_sec, index, lower, upper, prev_index);
+      errors++;
+    }
+    prev_index = index;
+  }
+
+  printf("monotonic: %s\n", (errors == 0) ? "ok" : "FAILED");
+  return errors;
+}
+
+// runtimes out of range go to the first and last bucket
+static int test_clamping(void) {
+  int errors = 0;
+
+  if (get_bucket_index(0) != 0 || get_bucket_index(-1e-3) != 0 || get_bucket_index(NAN) != 0) {
+    printf("non-positive runtimes are not counted in bucket 0\n");
+    errors++;
+  }
+  if (get_bucket_index(1e6) != REPROMPIB_HIST_N_BUCKETS - 1
+      || get_bucket_index(INFINITY) != REPROMPIB_HIST_N_BUCKETS - 1) {
+    printf("huge runtimes are not counted in the last bucket\n");
+    errors++;
+  }
+
+  printf("clamping: %s\n", (errors == 0) ? "ok" : "FAILED");
+  return errors;
+}
+
+int main(int argc, char* argv[]) {
+  int errors = 0;
+
+  errors += test_bucket_edges();
+  errors += test_monotonic();
+  errors += test_clamping();
+
+  printf("%d errors\n", errors);
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+ Research Group for Parallel Computing
+ Faculty of Informatics
+ Vienna University of Technology, Austria
+
+ <license>
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ </license>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../reprompi_bench/misc.h"
+#include "../reprompi_bench/output_management/streaming_stats.h"
+
+// rank error allowed for the quantiles of a sketch that has been compacted
+static const double QUANTILE_RANK_ERROR = 0.01;
+
+static const double quantiles[] = { 0, 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1 };
+static const int n_quantiles = sizeof(quantiles) / sizeof(quantiles[0]);
+
+static int cmp_doubles(const void* a, const void* b) {
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+// same interpolation as gsl_stats_quantile_from_sorted_data
+static double exact_quantile(const double* sorted, long n, double q) {
+  double pos = (n - 1) * q;
+  long lhs = (long) pos;
+  double delta = pos - lhs;
+
+  if (lhs >= n - 1) {
+    return sorted[n - 1];
+  }
+  return (1 - delta) * sorted[lhs] + delta * sorted[lhs + 1];
+}
+
+// fraction of the sorted values below v and not above v
+static void get_rank_range(const double* sorted, long n, double v, double* lo, double* hi) {
+  long below = 0, not_above = 0;
+  long i;
+
+  for (i = 0; i < n; i++) {
+    if (sorted[i] < v) {
+      below++;
+    }
+    if (sorted[i] <= v) {
+      not_above++;
+    }
+  }
+  *lo = (double) below / n;
+  *hi = (double) not_above / n;
+}
+
+// runtimes with a long tail, like the measurements of a benchmark
+static void generate_runtimes(double* values, long n) {
+  long i;
+
+  for (i = 0; i < n; i++) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    values[i] = 1e-6 * (10 - 2 * log(u));
+  }
+}
+
+static int check_moments(const char* name, const reprompib_streaming_stats_t* stats,
+    const double* values, long n) {
+  double mean = 0, var = 0, min = values[0], max = values[0];
+  long i;
+  int errors = 0;
+
+  for (i = 0; i < n; i++) {
+    mean += values[i];
+    if (values[i] < min) {
+      min = values[i];
+    }
+    if (values[i] > max) {
+      max = values[i];
+    }
+  }
+  mean /= n;
+  for (i = 0; i < n; i++) {
+    var += (values[i] - mean) * (values[i] - mean);
+  }
+  var = (n > 1) ? var / (n - 1) : 0;
+
+  if (stats->count != n) {
+    printf("%s: count=%ld (should be %ld)\n", name, stats->count, n);
+    errors++;
+  }
+  if (fabs(stats->mean - mean) > 1e-12 * fabs(mean)) {
+    printf("%s: mean=%.15e (should be %.15e)\n", name, stats->mean, mean);
+    errors++;
+  }
+  if (fabs(reprompib_get_streaming_variance(stats) - var) > 1e-9 * var) {
+    printf("%s: variance=%.15e (should be %.15e)\n", name, reprompib_get_streaming_variance(stats), var);
+    errors++;
+  }
+  if (stats->min != min || stats->max != max) {
+    printf("%s: min=%.15e max=%.15e (should be %.15e %.15e)\n", name, stats->min, stats->max, min, max);
+    errors++;
+  }
+  return errors;
+}
+
+/*
+ * the quantiles are exact while the sketch holds all values, otherwise
+ * the rank of each quantile has to be within QUANTILE_RANK_ERROR of q
+ */
+static int check_quantiles(const char* name, const reprompib_streaming_stats_t* stats,
+    const double* sorted, long n) {
+  int errors = 0;
+  int i;
+
+  for (i = 0; i < n_quantiles; i++) {
+    double q = quantiles[i];
+    double v = reprompib_get_streaming_quantile(stats, q);
+
+    if (n <= REPROMPIB_STATS_SKETCH_K) {
+      double exact = exact_quantile(sorted, n, q);
+      if (fabs(v - exact) > 1e-12 * fabs(exact)) {
+        printf("%s: quantile(%g)=%.15e (should be %.15e)\n", name, q, v, exact);
+        errors++;
+      }
+    } else {
+      double lo, hi;
+      get_rank_range(sorted, n, v, &lo, &hi);
+      if (q < lo - QUANTILE_RANK_ERROR || q > hi + QUANTILE_RANK_ERROR) {
+        printf("%s: quantile(%g)=%.15e has rank [%g,%g]\n", name, q, v, lo, hi);
+        errors++;
+      }
+    }
+  }
+  return errors;
+}
+
+static int test_stream(long n, long batch_size) {
+  reprompib_streaming_stats_t stats;
+  double* values;
+  char name[100];
+  long i;
+  int errors;
+
+  sprintf(name, "n=%ld batch=%ld", n, batch_size);
+  values = (double*) malloc(n * sizeof(double));
+  generate_runtimes(values, n);
+
+  reprompib_init_streaming_stats(&stats);
+  for (i = 0; i < n; i += batch_size) {
+    reprompib_add_to_streaming_stats(&stats, values + i, NULL, (n - i < batch_size) ? n - i : batch_size);
+  }
+
+  errors = check_moments(name, &stats, values, n);
+  qsort(values, n, sizeof(double), cmp_doubles);
+  errors += check_quantiles(name, &stats, values, n);
+  printf("%s: %s\n", name, (errors == 0) ? "ok" : "FAILED");
+
+  reprompib_free_streaming_stats(&stats);
+  free(values);
+  return errors;
+}
+
+// statistics of the halves merged vs. statistics of the whole
+static int test_merge(long n) {
+  reprompib_streaming_stats_t stats, other;
+  double* values;
+  char name[100];
+  int errors;
+
+  sprintf(name, "merge n=%ld", n);
+  values = (double*) malloc(n * sizeof(double));
+  generate_runtimes(values, n);
+
+  reprompib_init_streaming_stats(&stats);
+  reprompib_init_streaming_stats(&other);
+  reprompib_add_to_streaming_stats(&stats, values, NULL, n / 3);
+  reprompib_add_to_streaming_stats(&other, values + n / 3, NULL, n - n / 3);
+  reprompib_merge_streaming_stats(&stats, &other);
+
+  errors = check_moments(name, &stats, values, n);
+  qsort(values, n, sizeof(double), cmp_doubles);
+  errors += check_quantiles(name, &stats, values, n);
+  printf("%s: %s\n", name, (errors == 0) ? "ok" : "FAILED");
+
+  reprompib_free_streaming_stats(&stats);
+  reprompib_free_streaming_stats(&other);
+  free(values);
+  return errors;
+}
+
+// only the values with error code 0 are added
+static int test_errorcodes(long n) {
+  reprompib_streaming_stats_t stats;
+  double* values;
+  double* valid_values;
+  int* errorcodes;
+  long i, n_valid = 0;
+  int errors;
+
+  values = (double*) malloc(n * sizeof(double));
+  valid_values = (double*) malloc(n * sizeof(double));
+  errorcodes = (int*) malloc(n * sizeof(int));
+  generate_runtimes(values, n);
+  for (i = 0; i < n; i++) {
+    errorcodes[i] = (i % 3 == 0);
+    if (errorcodes[i] == 0) {
+      valid_values[n_valid++] = values[i];
+    }
+  }
+
+  reprompib_init_streaming_stats(&stats);
+  reprompib_add_to_streaming_stats(&stats, values, errorcodes, n);
+
+  errors = check_moments("errorcodes", &stats, valid_values, n_valid);
+  qsort(valid_values, n_valid, sizeof(double), cmp_doubles);
+  errors += check_quantiles("errorcodes", &stats, valid_values, n_valid);
+  printf("errorcodes n=%ld valid=%ld: %s\n", n, n_valid, (errors == 0) ? "ok" : "FAILED");
+
+  reprompib_free_streaming_stats(&stats);
+  free(values);
+  free(valid_values);
+  free(errorcodes);
+  return errors;
+}
+
+int main(int argc, char* argv[]) {
+  int errors = 0;
+
+  srand(1);
+
+  // exact: the sketch holds all values
+  errors += test_stream(1, 1);
+  errors += test_stream(2, 1);
+  errors += test_stream(1000, 1000);
+  errors += test_stream(REPROMPIB_STATS_SKETCH_K, 100);
+  errors += test_errorcodes(1500);
+
+  // approximate: the sketch has been compacted
+  errors += test_stream(REPROMPIB_STATS_SKETCH_K + 1, 1);
+  errors += test_stream(100000, 1000);
+  errors += test_stream(1000000, 4096);
+  errors += test_merge(1000);
+  errors += test_merge(200000);
+
+  printf("%d errors\n", errors);
+  return (errors == 0) ? 0 : 1;
+}
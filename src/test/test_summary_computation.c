@@ -0,0 +1,178 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+ Research Group for Parallel Computing
+ Faculty of Informatics
+ Vienna University of Technology, Austria
+
+ <license>
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ </license>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../reprompi_bench/output_management/summary_computation.h"
+
+static int cmp_doubles(const void* a, const void* b) {
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+// same interpolation as gsl_stats_quantile_from_sorted_data
+static double exact_quantile(const double* sorted, long n, double q) {
+  double pos = (n - 1) * q;
+  long lhs = (long) pos;
+  double delta = pos - lhs;
+
+  if (lhs >= n - 1) {
+    return sorted[n - 1];
+  }
+  return (1 - delta) * sorted[lhs] + delta * sorted[lhs + 1];
+}
+
+/*
+ * selects every k of the input and compares the result with the sorted
+ * input: data[k] has to be the k-th smallest value, no value before it may
+ * be larger and no value after it smaller, and no value may be lost
+ */
+static int test_select(const char* name, const double* input, long n) {
+  static const double quantiles[] = { 0, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 1 };
+  double* sorted;
+  double* data;
+  long i, k;
+  int q;
+  int errors = 0;
+
+  sorted = (double*) malloc(n * sizeof(double));
+  data = (double*) malloc(n * sizeof(double));
+  memcpy(sorted, input, n * sizeof(double));
+  qsort(sorted, n, sizeof(double), cmp_doubles);
+
+  for (k = 0; k < n; k++) {
+    memcpy(data, input, n * sizeof(double));
+    reprompib_select(data, n, k);
+
+    if (data[k] != sorted[k]) {
+      printf("%s: select(k=%ld)=%g (should be %g)\n", name, k, data[k], sorted[k]);
+      errors++;
+    }
+    for (i = 0; i < n; i++) {
+      if ((i < k && data[i] > data[k]) || (i > k && data[i] < data[k])) {
+        printf("%s: select(k=%ld) leaves %g at %ld\n", name, k, data[i], i);
+        errors++;
+        break;
+      }
+    }
+    qsort(data, n, sizeof(double), cmp_doubles);
+    if (memcmp(data, sorted, n * sizeof(double)) != 0) {
+      printf("%s: select(k=%ld) changed the values\n", name, k);
+      errors++;
+    }
+  }
+
+  for (q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+    double exact = exact_quantile(sorted, n, quantiles[q]);
+    double v;
+
+    memcpy(data, input, n * sizeof(double));
+    v = reprompib_select_quantile(data, n, quantiles[q]);
+    if (fabs(v - exact) > 1e-12 * fabs(exact)) {
+      printf("%s: quantile(%g)=%.15g (should be %.15g)\n", name, quantiles[q], v, exact);
+      errors++;
+    }
+  }
+
+  printf("%s (n=%ld): %s\n", name, n, (errors == 0) ? "ok" : "FAILED");
+  free(sorted);
+  free(data);
+  return errors;
+}
+
+static int check_summary(const char* method, const double* input, long n, double expected) {
+  double* data;
+  double v;
+
+  data = (double*) malloc(n * sizeof(double));
+  memcpy(data, input, n * sizeof(double));
+  v = reprompib_compute_summary(method, data, n);
+  free(data);
+
+  if (fabs(v - expected) > 1e-12 * fabs(expected)) {
+    printf("%s (n=%ld) = %.15g (should be %.15g)\n", method, n, v, expected);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  // fixed input with an outlier: sorted 1 2 3 4 5 6 7 8 9 100
+  const double fixed[] = { 7, 1, 100, 3, 5, 2, 9, 4, 6, 8 };
+  double* data;
+  long i, n = 257;
+  int errors = 0;
+
+  data = (double*) malloc(n * sizeof(double));
+  srand(1);
+
+  data[0] = 42;
+  errors += test_select("single value", data, 1);
+
+  for (i = 0; i < n; i++) {
+    data[i] = (double) rand() / RAND_MAX;
+  }
+  errors += test_select("random", data, n);
+  errors += test_select("random", data, n - 1);
+
+  for (i = 0; i < n; i++) {
+    data[i] = rand() % 4;
+  }
+  errors += test_select("duplicates", data, n);
+
+  for (i = 0; i < n; i++) {
+    data[i] = 1;
+  }
+  errors += test_select("equal", data, n);
+
+  for (i = 0; i < n; i++) {
+    data[i] = i;
+  }
+  errors += test_select("ascending", data, n);
+
+  for (i = 0; i < n; i++) {
+    data[i] = n - i;
+  }
+  errors += test_select("descending", data, n);
+
+  // one value removed at each end: mean of 2..9
+  errors += check_summary("trimmed_mean", fixed, 10, 5.5);
+  // deviations from the median 5.5: 0.5 0.5 1.5 1.5 2.5 2.5 3.5 3.5 4.5 94.5
+  errors += check_summary("mad", fixed, 10, 2.5);
+  errors += check_summary("median", fixed, 10, 5.5);
+  errors += check_summary("iqr", fixed, 10, 7.75 - 3.25);
+  errors += check_summary("min", fixed, 10, 1);
+  errors += check_summary("max", fixed, 10, 100);
+  // fewer than 10 values: nothing is trimmed
+  errors += check_summary("trimmed_mean", fixed, 5, (7 + 1 + 100 + 3 + 5) / 5.0);
+  // median 3, deviations 0 2 2 4 97
+  errors += check_summary("mad", fixed, 5, 2);
+
+  free(data);
+  printf("%d errors\n", errors);
+  return (errors == 0) ? 0 : 1;
+}